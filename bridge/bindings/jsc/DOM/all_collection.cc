@@ -102,6 +102,10 @@ void JSAllCollection::internalAdd(NodeInstance *node, NodeInstance *before) {
   }
 }
 
+void JSAllCollection::internalClear() {
+  m_nodes.clear();
+}
+
 void JSAllCollection::getPropertyNames(JSPropertyNameAccumulatorRef accumulator) {
   HostObject::getPropertyNames(accumulator);
 
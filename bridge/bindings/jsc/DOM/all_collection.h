@@ -32,6 +32,7 @@ public:
   void getPropertyNames(JSPropertyNameAccumulatorRef accumulator) override;
 
   void internalAdd(NodeInstance *node, NodeInstance *before);
+  void internalClear();
 
 private:
   std::vector<NodeInstance *> m_nodes;
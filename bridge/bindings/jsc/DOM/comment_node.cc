@@ -42,7 +42,7 @@ JSCommentNode::CommentNodeInstance::CommentNodeInstance(JSCommentNode *jsComment
   NativeString args_01{};
   buildUICommandArgs(str, args_01);
 
-  ::foundation::UICommandBuffer::instance(jsCommentNode->contextId)
+  jsCommentNode->context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createComment, args_01, nativeComment);
 }
 
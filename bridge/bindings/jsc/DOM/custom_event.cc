@@ -110,7 +110,7 @@ JSValueRef JSCustomEvent::initCustomEvent(JSContextRef ctx, JSObjectRef function
   auto eventInstance = static_cast<CustomEventInstance *>(JSObjectGetPrivate(thisObject));
 
   JSStringRef typeStringRef = JSValueToStringCopy(ctx, arguments[0], exception);
-  eventInstance->nativeEvent->type = stringRefToNativeString(typeStringRef);
+  eventInstance->setType(stringRefToNativeString(typeStringRef));
 
   if (argumentCount <= 2) {
     bool canBubble = JSValueToBoolean(ctx, arguments[1]);
@@ -49,10 +49,10 @@ JSValueRef JSDocument::createEvent(JSContextRef ctx, JSObjectRef function, JSObj
   std::string &&eventType = JSStringToStdString(eventTypeStringRef);
 
   if (eventType == "Event") {
-    auto nativeEvent = new NativeEvent(stringToNativeString(eventType));
-
     auto document = static_cast<DocumentInstance *>(JSObjectGetPrivate(thisObject));
+    auto nativeEvent = document->context->eventPayloadPool()->acquireEvent(eventType);
     auto e = JSEvent::buildEventInstance(eventType, document->context, nativeEvent, false);
+    e->pooledPayload = true;
     return e->object;
   } else {
     return nullptr;
@@ -261,6 +261,8 @@ DocumentInstance::DocumentInstance(JSDocument *document)
   JSObjectSetProperty(ctx, object, documentElementStringHolder.getString(),
                       documentElement->object, kJSPropertyAttributeReadOnly, nullptr);
 
+  indexElement(documentElement);
+
   instanceMap[document->context] = this;
   getDartMethod()->initDocument(contextId, nativeDocument);
 }
@@ -285,14 +287,23 @@ JSValueRef DocumentInstance::getProperty(std::string &name, JSValueRef *exceptio
     return nullptr;
   }
   case DocumentProperty::all: {
-    auto all = new JSAllCollection(context);
+    if (m_allCollection == nullptr) {
+      m_allCollection = new JSAllCollection(context);
+      JSValueProtect(ctx, m_allCollection->jsObject);
+    }
 
-    traverseNode(documentElement, [&all](NodeInstance *node) {
-      all->internalAdd(node, nullptr);
-      return false;
-    });
+    if (m_allCollectionVersion != m_elementIndexVersion) {
+      std::vector<ElementInstance *> elements;
+      elements.reserve(m_elementCount);
+      collectElementsByTagName("*", elements);
+      m_allCollection->internalClear();
+      for (auto &element : elements) {
+        m_allCollection->internalAdd(element, nullptr);
+      }
+      m_allCollectionVersion = m_elementIndexVersion;
+    }
 
-    return all->jsObject;
+    return m_allCollection->jsObject;
   }
   case DocumentProperty::cookie: {
     std::string cookie = m_cookie.getCookie();
@@ -311,6 +322,18 @@ DocumentInstance::~DocumentInstance() {
   ::foundation::UICommandCallbackQueue::instance()->registerCallback(
     [](void *ptr) { delete reinterpret_cast<NativeDocument *>(ptr); }, nativeDocument);
   instanceMap.erase(context);
+
+  if (context->isValid()) {
+    for (auto &collection : m_collectionsByTagName) {
+      JSValueUnprotect(ctx, collection.second->jsObject);
+    }
+    if (m_allCollection != nullptr) {
+      JSValueUnprotect(ctx, m_allCollection->jsObject);
+    }
+    if (m_htmlCollectionPrototype != nullptr) {
+      JSValueUnprotect(ctx, m_htmlCollectionPrototype);
+    }
+  }
 }
 
 void DocumentInstance::getPropertyNames(JSPropertyNameAccumulatorRef accumulator) {
@@ -321,26 +344,202 @@ void DocumentInstance::getPropertyNames(JSPropertyNameAccumulatorRef accumulator
   }
 }
 
-void DocumentInstance::removeElementById(JSValueRef idRef, ElementInstance *element) {
-  std::string id = JSStringToStdString(JSValueToStringCopy(ctx, idRef, nullptr));
-  if (elementMapById.count(id) > 0) {
-    auto &list = elementMapById[id];
-    list.erase(std::find(list.begin(), list.end(), element));
+void ElementIndexList::add(ElementInstance *element, Link link) {
+  (element->*link).previous = nullptr;
+  (element->*link).next = m_head;
+  if (m_head != nullptr) (m_head->*link).previous = element;
+  m_head = element;
+  m_size++;
+}
+
+void ElementIndexList::remove(ElementInstance *element, Link link) {
+  ElementIndexLink &elementLink = element->*link;
+  if (elementLink.previous != nullptr) {
+    (elementLink.previous->*link).next = elementLink.next;
+  } else {
+    m_head = elementLink.next;
+  }
+  if (elementLink.next != nullptr) (elementLink.next->*link).previous = elementLink.previous;
+  elementLink.previous = nullptr;
+  elementLink.next = nullptr;
+  m_size--;
+}
+
+void DocumentInstance::indexElement(ElementInstance *element) {
+  if (element->m_indexed) return;
+
+  element->m_indexed = true;
+  element->m_indexedTagName = element->tagName();
+  m_elementsByTagName[element->m_indexedTagName].add(element, &ElementInstance::m_tagNameLink);
+  m_elementCount++;
+
+  std::string idKey = "id";
+  auto attributes = *element->m_attributes;
+  if (attributes->hasAttribute(idKey)) {
+    element->m_indexedId = JSStringToStdString(JSValueToStringCopy(ctx, attributes->getAttribute(idKey), nullptr));
+    if (!element->m_indexedId.empty()) {
+      m_elementsById[element->m_indexedId].add(element, &ElementInstance::m_idLink);
+    }
+  }
+
+  m_elementIndexVersion++;
+}
+
+void DocumentInstance::unindexElement(ElementInstance *element) {
+  if (!element->m_indexed) return;
+
+  auto &list = m_elementsByTagName[element->m_indexedTagName];
+  list.remove(element, &ElementInstance::m_tagNameLink);
+  m_elementCount--;
+
+  if (list.empty()) {
+    // Script may still hold the collection, it stays live but is no longer kept alive by the document.
+    auto it = m_collectionsByTagName.find(element->m_indexedTagName);
+    if (it != m_collectionsByTagName.end()) {
+      JSValueUnprotect(ctx, it->second->jsObject);
+      m_collectionsByTagName.erase(it);
+    }
+    m_elementsByTagName.erase(element->m_indexedTagName);
+  }
+
+  if (!element->m_indexedId.empty()) {
+    m_elementsById[element->m_indexedId].remove(element, &ElementInstance::m_idLink);
+    element->m_indexedId.clear();
+  }
+
+  element->m_indexed = false;
+  m_elementIndexVersion++;
+}
+
+void DocumentInstance::updateElementId(ElementInstance *element, JSValueRef idRef) {
+  if (!element->m_indexed) return;
+
+  std::string id = idRef != nullptr ? JSStringToStdString(JSValueToStringCopy(ctx, idRef, nullptr)) : "";
+  if (id == element->m_indexedId) return;
+
+  if (!element->m_indexedId.empty()) {
+    m_elementsById[element->m_indexedId].remove(element, &ElementInstance::m_idLink);
+  }
+  element->m_indexedId = id;
+  if (!id.empty()) {
+    m_elementsById[id].add(element, &ElementInstance::m_idLink);
+  }
+
+  m_elementIndexVersion++;
+}
+
+template <typename Predicate>
+void DocumentInstance::collectElements(size_t expectedCount, std::vector<ElementInstance *> &elements,
+                                       Predicate predicate) {
+  size_t count = elements.size() + expectedCount;
+  NodeInstance *node = documentElement;
+
+  // Walk in tree order and stop as soon as all indexed elements were found.
+  while (node != nullptr && elements.size() < count) {
+    if (node->nodeType == NodeType::ELEMENT_NODE) {
+      auto element = reinterpret_cast<ElementInstance *>(node);
+      if (predicate(element)) elements.emplace_back(element);
+    }
+
+    NodeInstance *next = node->firstChild();
+    while (next == nullptr && node != documentElement) {
+      next = node->nextSibling();
+      if (next == nullptr) node = node->parentNode;
+    }
+    node = next;
+  }
+}
+
+void DocumentInstance::collectElementsByTagName(const std::string &tagName, std::vector<ElementInstance *> &elements) {
+  size_t count = countElementsByTagName(tagName);
+  if (count == 0) return;
+
+  if (tagName == "*") {
+    collectElements(count, elements, [](ElementInstance *element) { return element->m_indexed; });
+    return;
   }
+
+  auto &list = m_elementsByTagName[tagName];
+  if (count == 1) {
+    elements.emplace_back(list.front());
+    return;
+  }
+
+  collectElements(count, elements, [&tagName](ElementInstance *element) {
+    return element->m_indexed && element->m_indexedTagName == tagName;
+  });
+}
+
+size_t DocumentInstance::countElementsByTagName(const std::string &tagName) {
+  if (tagName == "*") return m_elementCount;
+
+  auto it = m_elementsByTagName.find(tagName);
+  return it != m_elementsByTagName.end() ? it->second.size() : 0;
+}
+
+ElementInstance *DocumentInstance::getElementById(const std::string &id) {
+  auto it = m_elementsById.find(id);
+  if (it == m_elementsById.end() || it->second.empty()) return nullptr;
+  if (it->second.size() == 1) return it->second.front();
+
+  // Duplicated ids, the first element in tree order wins.
+  std::vector<ElementInstance *> elements;
+  collectElements(1, elements, [&id](ElementInstance *element) {
+    return element->m_indexed && element->m_indexedId == id;
+  });
+  return elements.empty() ? nullptr : elements[0];
 }
 
-void DocumentInstance::addElementById(JSValueRef idRef, ElementInstance *element) {
-  std::string id = JSStringToStdString(JSValueToStringCopy(ctx, idRef, nullptr));
-  if (elementMapById.count(id) == 0) {
-    elementMapById[id] = std::vector<ElementInstance *>();
+JSHTMLCollection *DocumentInstance::getElementsByTagName(const std::string &tagName) {
+  auto it = m_collectionsByTagName.find(tagName);
+  if (it != m_collectionsByTagName.end()) return it->second;
+
+  // Collections of tags which still have no elements are only kept until the next tag is looked up, so looking up
+  // many absent tags does not grow the cache.
+  for (auto it = m_collectionsByTagName.begin(); it != m_collectionsByTagName.end();) {
+    if (countElementsByTagName(it->first) == 0) {
+      JSValueUnprotect(ctx, it->second->jsObject);
+      it = m_collectionsByTagName.erase(it);
+    } else {
+      ++it;
+    }
   }
 
-  auto &list = elementMapById[id];
-  auto it = std::find(list.begin(), list.end(), element);
+  // The same collection is returned for the same tag name while it is cached.
+  auto collection = new JSHTMLCollection(context, this, tagName);
+  JSObjectSetPrototype(ctx, collection->jsObject, htmlCollectionPrototype());
+  JSValueProtect(ctx, collection->jsObject);
+  m_collectionsByTagName[tagName] = collection;
+  return collection;
+}
 
-  if (it == list.end()) {
-    elementMapById[id].emplace_back(element);
+JSObjectRef DocumentInstance::htmlCollectionPrototype() {
+  if (m_htmlCollectionPrototype != nullptr) return m_htmlCollectionPrototype;
+
+  JSObjectRef global = JSContextGetGlobalObject(ctx);
+  JSObjectRef arrayConstructor = JSValueToObject(ctx, getObjectPropertyValue(ctx, "Array", global, nullptr), nullptr);
+  JSObjectRef arrayPrototype =
+    JSValueToObject(ctx, getObjectPropertyValue(ctx, "prototype", arrayConstructor, nullptr), nullptr);
+
+  m_htmlCollectionPrototype = JSObjectMake(ctx, nullptr, nullptr);
+  JSValueProtect(ctx, m_htmlCollectionPrototype);
+
+  // Array methods are generic, they work on anything with length and indexes.
+  static const char *methods[] = {"forEach", "map",       "filter", "some", "every",  "reduce",  "indexOf",
+                                  "includes", "find", "findIndex", "slice",  "keys", "values", "entries"};
+  for (auto method : methods) {
+    JSStringHolder methodName = JSStringHolder(context, method);
+    JSValueRef function = JSObjectGetProperty(ctx, arrayPrototype, methodName.getString(), nullptr);
+    JSObjectSetProperty(ctx, m_htmlCollectionPrototype, methodName.getString(), function, kJSPropertyAttributeDontEnum,
+                        nullptr);
   }
+
+  JSObjectRef symbolConstructor = JSValueToObject(ctx, getObjectPropertyValue(ctx, "Symbol", global, nullptr), nullptr);
+  JSValueRef iteratorSymbol = getObjectPropertyValue(ctx, "iterator", symbolConstructor, nullptr);
+  JSObjectSetPropertyForKey(ctx, m_htmlCollectionPrototype, iteratorSymbol,
+                            getObjectPropertyValue(ctx, "values", arrayPrototype, nullptr),
+                            kJSPropertyAttributeDontEnum, nullptr);
+  return m_htmlCollectionPrototype;
 }
 
 JSValueRef JSDocument::getElementById(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
@@ -358,18 +557,8 @@ JSValueRef JSDocument::getElementById(JSContextRef ctx, JSObjectRef function, JS
   std::string id = JSStringToStdString(idStringRef);
   if (id.empty()) return nullptr;
 
-  if (document->elementMapById.count(id) == 0) {
-    return nullptr;
-  }
-
-  auto targetElementList = document->elementMapById[id];
-  if (targetElementList.empty()) return nullptr;
-
-  for (auto &element : targetElementList) {
-    if (element->isConnected()) return element->object;
-  }
-
-  return nullptr;
+  auto element = document->getElementById(id);
+  return element != nullptr ? element->object : nullptr;
 }
 
 JSValueRef JSDocument::getElementsByTagName(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
@@ -387,26 +576,7 @@ JSValueRef JSDocument::getElementsByTagName(JSContextRef ctx, JSObjectRef functi
   std::string tagName = JSStringToStdString(tagNameStringRef);
   std::transform(tagName.begin(), tagName.end(), tagName.begin(), ::toupper);
 
-  std::vector<ElementInstance *> elements;
-
-  traverseNode(document->documentElement, [tagName, &elements](NodeInstance *node) {
-    if (node->nodeType == NodeType::ELEMENT_NODE) {
-      auto element = reinterpret_cast<ElementInstance *>(node);
-      if (element->tagName() == tagName) {
-        elements.emplace_back(element);
-      }
-    }
-
-    return false;
-  });
-
-  JSValueRef elementArguments[elements.size()];
-
-  for (int i = 0; i < elements.size(); i++) {
-    elementArguments[i] = elements[i]->object;
-  }
-
-  return JSObjectMakeArray(ctx, elements.size(), elementArguments, exception);
+  return document->getElementsByTagName(tagName)->jsObject;
 }
 
 bool DocumentInstance::setProperty(std::string &name, JSValueRef value, JSValueRef *exception) {
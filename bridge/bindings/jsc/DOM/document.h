@@ -9,6 +9,7 @@
 #include "all_collection.h"
 #include "bindings/jsc/js_context_internal.h"
 #include "element.h"
+#include "html_collection.h"
 #include "node.h"
 
 
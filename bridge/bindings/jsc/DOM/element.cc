@@ -128,7 +128,26 @@ void JSElementAttributes::setAttributesVector(std::vector<JSValueRef> &attribute
 std::unordered_map<JSContext *, JSElement *> JSElement::instanceMap{};
 std::unordered_map<std::string, ElementCreator> JSElement::elementCreatorMap{};
 
-JSElement::JSElement(JSContext *context) : JSNode(context, "Element") {}
+const JSStaticFunction JSElement::prototypeStaticFunctions[] = {
+  {"getBoundingClientRect", getBoundingClientRect, kJSPropertyAttributeNone},
+  {"setAttribute", setAttribute, kJSPropertyAttributeNone},
+  {"getAttribute", getAttribute, kJSPropertyAttributeNone},
+  {"hasAttribute", hasAttribute, kJSPropertyAttributeNone},
+  {"removeAttribute", removeAttribute, kJSPropertyAttributeNone},
+  {"toBlob", toBlob, kJSPropertyAttributeNone},
+  {"click", click, kJSPropertyAttributeNone},
+  {"scroll", scroll, kJSPropertyAttributeNone},
+  {"scrollTo", scroll, kJSPropertyAttributeNone},
+  {"scrollBy", scrollBy, kJSPropertyAttributeNone},
+  {nullptr, nullptr, 0}};
+
+JSClassRef JSElement::prototypeClass() {
+  return getPrototypeClassRef("Element", JSNode::prototypeClass(), prototypeStaticFunctions);
+}
+
+JSElement::JSElement(JSContext *context) : JSNode(context, "Element") {
+  setPrototypeClass(prototypeClass());
+}
 
 JSElement::~JSElement() {
   instanceMap.erase(context);
@@ -155,7 +174,7 @@ ElementInstance::ElementInstance(JSElement *element, const char *tagName, bool s
     std::string t = std::string(tagName);
     NativeString args_01{};
     buildUICommandArgs(t, args_01);
-    ::foundation::UICommandBuffer::instance(element->context->getContextId())
+    element->context->uiCommandBuffer()
         ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeElement);
   }
 }
@@ -175,10 +194,34 @@ ElementInstance::~ElementInstance() {
     [](void *ptr) { delete reinterpret_cast<NativeElement *>(ptr); }, nativeElement);
 }
 
+// Dart side layout only changes after pending commands are consumed, skip the flush when nothing is pending.
+static void flushUICommandIfLayoutDirty(JSContext *context) {
+  if (context->uiCommandBuffer()->isLayoutDirty()) {
+    getDartMethod()->flushUICommand();
+  }
+}
+
+static void invalidateLayout(JSContext *context) {
+  context->uiCommandBuffer()->invalidateLayout();
+}
+
+double ElementInstance::getViewModuleProperty(ViewModuleProperty property) {
+  flushUICommandIfLayoutDirty(context);
+  auto buffer = context->uiCommandBuffer();
+  uint64_t epoch = buffer->layoutEpoch();
+  if (m_viewModulePropertiesEpoch != epoch) {
+    assert_m(nativeElement->getViewModuleProperties != nullptr,
+             "Failed to execute getViewModuleProperties(): dart method is nullptr.");
+    nativeElement->getViewModuleProperties(nativeElement, &m_viewModuleProperties);
+    m_viewModulePropertiesEpoch = epoch;
+  }
+  return m_viewModuleProperties.properties[static_cast<int64_t>(property)];
+}
+
 JSValueRef JSElement::getBoundingClientRect(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
                                             size_t argumentCount, const JSValueRef *arguments, JSValueRef *exception) {
   auto elementInstance = reinterpret_cast<ElementInstance *>(JSObjectGetPrivate(thisObject));
-  getDartMethod()->flushUICommand();
+  flushUICommandIfLayoutDirty(elementInstance->context);
   assert_m(elementInstance->nativeElement->getBoundingClientRect != nullptr,
            "Failed to execute getBoundingClientRect(): dart method is nullptr.");
   NativeBoundingClientRect *nativeBoundingClientRect =
@@ -189,12 +232,6 @@ JSValueRef JSElement::getBoundingClientRect(JSContextRef ctx, JSObjectRef functi
 
 JSValueRef ElementInstance::getProperty(std::string &name, JSValueRef *exception) {
   auto &propertyMap = JSElement::getElementPropertyMap();
-  auto &prototypePropertyMap = JSElement::getElementPrototypePropertyMap();
-  JSStringHolder nameStringHolder = JSStringHolder(context, name);
-
-  if (prototypePropertyMap.count(name) > 0) {
-    return JSObjectGetProperty(ctx, prototype<JSElement>()->prototypeObject, nameStringHolder.getString(), exception);
-  }
 
   if (propertyMap.count(name) == 0) {
     return NodeInstance::getProperty(name, exception);
@@ -211,90 +248,30 @@ JSValueRef ElementInstance::getProperty(std::string &name, JSValueRef *exception
   case JSElement::ElementProperty::style: {
     return nullptr;
   }
-  case JSElement::ElementProperty::offsetLeft: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::offsetLeft)));
-  }
-  case JSElement::ElementProperty::offsetTop: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::offsetTop)));
-  }
-  case JSElement::ElementProperty::offsetWidth: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::offsetWidth)));
-  }
-  case JSElement::ElementProperty::offsetHeight: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::offsetHeight)));
-  }
-  case JSElement::ElementProperty::clientWidth: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::clientWidth)));
-  }
-  case JSElement::ElementProperty::clientHeight: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::clientHeight)));
-  }
-  case JSElement::ElementProperty::clientTop: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::clientTop)));
-  }
-  case JSElement::ElementProperty::clientLeft: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::clientLeft)));
-  }
-  case JSElement::ElementProperty::scrollTop: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::scrollTop)));
-  }
-  case JSElement::ElementProperty::scrollLeft: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::scrollLeft)));
-  }
-  case JSElement::ElementProperty::scrollHeight: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::scrollHeight)));
-  }
-  case JSElement::ElementProperty::scrollWidth: {
-    getDartMethod()->flushUICommand();
-    assert_m(nativeElement->getViewModuleProperty != nullptr,
-             "Failed to execute getViewModuleProperty(): dart method is nullptr.");
-    return JSValueMakeNumber(_hostClass->ctx, nativeElement->getViewModuleProperty(
-                                                nativeElement, static_cast<int64_t>(ViewModuleProperty::scrollWidth)));
-  }
+  case JSElement::ElementProperty::offsetLeft:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::offsetLeft));
+  case JSElement::ElementProperty::offsetTop:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::offsetTop));
+  case JSElement::ElementProperty::offsetWidth:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::offsetWidth));
+  case JSElement::ElementProperty::offsetHeight:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::offsetHeight));
+  case JSElement::ElementProperty::clientWidth:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::clientWidth));
+  case JSElement::ElementProperty::clientHeight:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::clientHeight));
+  case JSElement::ElementProperty::clientTop:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::clientTop));
+  case JSElement::ElementProperty::clientLeft:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::clientLeft));
+  case JSElement::ElementProperty::scrollTop:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::scrollTop));
+  case JSElement::ElementProperty::scrollLeft:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::scrollLeft));
+  case JSElement::ElementProperty::scrollHeight:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::scrollHeight));
+  case JSElement::ElementProperty::scrollWidth:
+    return JSValueMakeNumber(_hostClass->ctx, getViewModuleProperty(ViewModuleProperty::scrollWidth));
   case JSElement::ElementProperty::children: {
     std::vector<JSValueRef> arguments;
     for (auto &childNode : childNodes) {
@@ -326,19 +303,21 @@ bool ElementInstance::setProperty(std::string &name, JSValueRef value, JSValueRe
     case JSElement::ElementProperty::attributes:
       return false;
     case JSElement::ElementProperty::scrollTop: {
-      getDartMethod()->flushUICommand();
+      flushUICommandIfLayoutDirty(context);
       assert_m(nativeElement->setViewModuleProperty != nullptr,
                "Failed to execute setScrollTop(): dart method is nullptr.");
       nativeElement->setViewModuleProperty(nativeElement, static_cast<int64_t>(ViewModuleProperty::scrollTop),
                                            JSValueToNumber(_hostClass->ctx, value, exception));
+      invalidateLayout(context);
       break;
     }
     case JSElement::ElementProperty::scrollLeft: {
-      getDartMethod()->flushUICommand();
+      flushUICommandIfLayoutDirty(context);
       assert_m(nativeElement->setViewModuleProperty != nullptr,
                "Failed to execute setScrollLeft(): dart method is nullptr.");
       nativeElement->setViewModuleProperty(nativeElement, static_cast<int64_t>(ViewModuleProperty::scrollLeft),
                                            JSValueToNumber(_hostClass->ctx, value, exception));
+      invalidateLayout(context);
       break;
     }
     default:
@@ -412,7 +391,7 @@ JSValueRef JSElement::setAttribute(JSContextRef ctx, JSObjectRef function, JSObj
   NativeString args_02{};
   buildUICommandArgs(name, valueStringRef, args_01, args_02);
 
-  ::foundation::UICommandBuffer::instance(elementInstance->_hostClass->contextId)
+  elementInstance->_hostClass->context->uiCommandBuffer()
     ->addCommand(elementInstance->eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
 
   return nullptr;
@@ -493,7 +472,7 @@ JSValueRef JSElement::removeAttribute(JSContextRef ctx, JSObjectRef function, JS
 
     NativeString args_01{};
     buildUICommandArgs(name, args_01);
-    ::foundation::UICommandBuffer::instance(element->_hostClass->contextId)
+    element->_hostClass->context->uiCommandBuffer()
       ->addCommand(element->eventTargetId, UICommand::removeProperty, args_01, nullptr);
   }
 
@@ -545,14 +524,13 @@ JSValueRef JSElement::toBlob(JSContextRef ctx, JSObjectRef function, JSObjectRef
 
     auto handleTransientToBlobCallback = [](void *ptr, int32_t contextId, const char *error, uint8_t *bytes,
                                             int32_t length) {
-      auto callbackContext = static_cast<BridgeCallback::Context *>(ptr);
-      JSContext &_context = callbackContext->_context;
+      auto callbackContext = JSBridge::getCallbackContext(contextId, ptr);
+      if (callbackContext == nullptr) return;
       JSContextRef ctx = callbackContext->_context.context();
 
       JSValueRef resolveValueRef = callbackContext->_callback;
       JSValueRef rejectValueRef = callbackContext->_secondaryCallback;
 
-      if (!checkContext(contextId, &_context)) return;
       if (error != nullptr) {
         JSStringRef errorStringRef = JSStringCreateWithUTF8CString(error);
         const JSValueRef arguments[] = {JSValueMakeString(ctx, errorStringRef)};
@@ -567,12 +545,15 @@ JSValueRef JSElement::toBlob(JSContextRef ctx, JSObjectRef function, JSObjectRef
 
         JSObjectCallAsFunction(ctx, resolveObjectRef, callbackContext->_context.global(), 1, arguments, nullptr);
       }
+
+      auto bridge = static_cast<JSBridge *>(callbackContext->_context.getOwner());
+      bridge->bridgeCallback->freeBridgeCallbackContext(ptr);
     };
 
     toBlobPromiseContext->bridge->bridgeCallback->registerCallback<void>(
       std::move(callbackContext), [toBlobPromiseContext, handleTransientToBlobCallback](
-                                    BridgeCallback::Context *callbackContext, int32_t contextId) {
-        getDartMethod()->toBlob(callbackContext, contextId, handleTransientToBlobCallback, toBlobPromiseContext->id,
+                                    BridgeCallback::Handle callbackHandle, int32_t contextId) {
+        getDartMethod()->toBlob(callbackHandle, contextId, handleTransientToBlobCallback, toBlobPromiseContext->id,
                                 toBlobPromiseContext->devicePixelRatio);
       });
 
@@ -587,9 +568,10 @@ JSValueRef JSElement::toBlob(JSContextRef ctx, JSObjectRef function, JSObjectRef
 JSValueRef JSElement::click(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
                             const JSValueRef *arguments, JSValueRef *exception) {
   auto elementInstance = reinterpret_cast<ElementInstance *>(JSObjectGetPrivate(thisObject));
-  getDartMethod()->flushUICommand();
+  flushUICommandIfLayoutDirty(elementInstance->context);
   assert_m(elementInstance->nativeElement->click != nullptr, "Failed to execute click(): dart method is nullptr.");
   elementInstance->nativeElement->click(elementInstance->nativeElement);
+  invalidateLayout(elementInstance->context);
 
   return nullptr;
 }
@@ -611,9 +593,10 @@ JSValueRef JSElement::scroll(JSContextRef ctx, JSObjectRef function, JSObjectRef
   }
 
   auto elementInstance = reinterpret_cast<ElementInstance *>(JSObjectGetPrivate(thisObject));
-  getDartMethod()->flushUICommand();
+  flushUICommandIfLayoutDirty(elementInstance->context);
   assert_m(elementInstance->nativeElement->scroll != nullptr, "Failed to execute scroll(): dart method is nullptr.");
   elementInstance->nativeElement->scroll(elementInstance->nativeElement, x, y);
+  invalidateLayout(elementInstance->context);
 
   return nullptr;
 }
@@ -635,10 +618,11 @@ JSValueRef JSElement::scrollBy(JSContextRef ctx, JSObjectRef function, JSObjectR
   }
 
   auto elementInstance = reinterpret_cast<ElementInstance *>(JSObjectGetPrivate(thisObject));
-  getDartMethod()->flushUICommand();
+  flushUICommandIfLayoutDirty(elementInstance->context);
   assert_m(elementInstance->nativeElement->scrollBy != nullptr,
            "Failed to execute scrollBy(): dart method is nullptr.");
   elementInstance->nativeElement->scrollBy(elementInstance->nativeElement, x, y);
+  invalidateLayout(elementInstance->context);
 
   return nullptr;
 }
@@ -674,8 +658,7 @@ JSValueRef JSElement::prototypeGetProperty(std::string &name, JSValueRef *except
 void ElementInstance::_notifyNodeRemoved(NodeInstance *insertionNode) {
   if (insertionNode->isConnected()) {
     traverseNode(this, [](NodeInstance *node) {
-      auto Element = JSElement::instance(node->context);
-      if (node->_hostClass == Element) {
+      if (node->nodeType == NodeType::ELEMENT_NODE) {
         auto element = reinterpret_cast<ElementInstance *>(node);
         element->_notifyChildRemoved();
       }
@@ -685,18 +668,12 @@ void ElementInstance::_notifyNodeRemoved(NodeInstance *insertionNode) {
   }
 }
 void ElementInstance::_notifyChildRemoved() {
-  auto attributes = *m_attributes;
-  std::string idString = "id";
-  if (attributes->hasAttribute(idString)) {
-    JSValueRef idRef = attributes->getAttribute(idString);
-    document()->removeElementById(idRef, this);
-  }
+  document()->unindexElement(this);
 }
 void ElementInstance::_notifyNodeInsert(NodeInstance *insertNode) {
   if (insertNode->isConnected()) {
     traverseNode(this, [](NodeInstance *node) {
-      auto Element = JSElement::instance(node->context);
-      if (node->_hostClass == Element) {
+      if (node->nodeType == NodeType::ELEMENT_NODE) {
         auto element = reinterpret_cast<ElementInstance *>(node);
         element->_notifyChildInsert();
       }
@@ -706,12 +683,7 @@ void ElementInstance::_notifyNodeInsert(NodeInstance *insertNode) {
   }
 }
 void ElementInstance::_notifyChildInsert() {
-  std::string idKey = "id";
-  auto attributes = *m_attributes;
-  if (attributes->hasAttribute(idKey)) {
-    JSValueRef idRef = attributes->getAttribute(idKey);
-    document()->addElementById(idRef, this);
-  }
+  document()->indexElement(this);
 }
 void ElementInstance::_didModifyAttribute(std::string &name, JSValueRef oldId, JSValueRef newId) {
   if (name == "id") {
@@ -720,14 +692,7 @@ void ElementInstance::_didModifyAttribute(std::string &name, JSValueRef oldId, J
 }
 void ElementInstance::_beforeUpdateId(JSValueRef oldId, JSValueRef newId) {
   if (oldId == newId || JSValueIsStrictEqual(ctx, oldId, newId)) return;
-
-  if (oldId != nullptr) {
-    document()->removeElementById(oldId, this);
-  }
-
-  if (newId != nullptr) {
-    document()->addElementById(newId, this);
-  }
+  document()->updateElementId(this, newId);
 }
 
 std::string ElementInstance::getRegisteredTagName() {
@@ -772,7 +737,7 @@ BoundingClientRect::BoundingClientRect(JSContext *context, NativeBoundingClientR
   : HostObject(context, "BoundingClientRect"), nativeBoundingClientRect(boundingClientRect) {}
 
 JSValueRef ElementInstance::getStringValueProperty(std::string &name) {
-  getDartMethod()->flushUICommand();
+  flushUICommandIfLayoutDirty(context);
   JSStringRef stringRef = JSStringCreateWithUTF8CString(name.c_str());
   NativeString *nativeString = stringRefToNativeString(stringRef);
   NativeString *returnedString = nativeElement->getStringValueProperty(nativeElement, nativeString);
@@ -26,7 +26,7 @@ JSAnchorElement::AnchorElementInstance::AnchorElementInstance(JSAnchorElement *j
   std::string tagName = "a";
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeAnchorElement);
 }
 
@@ -60,7 +60,7 @@ bool JSAnchorElement::AnchorElementInstance::setProperty(std::string &name, JSVa
     NativeString args_01{};
     NativeString args_02{};
     buildUICommandArgs(name, hrefString, args_01, args_02);
-    foundation::UICommandBuffer::instance(_hostClass->contextId)
+    _hostClass->context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
     return true;
   } else if (property == AnchorElementProperty::target) {
@@ -70,7 +70,7 @@ bool JSAnchorElement::AnchorElementInstance::setProperty(std::string &name, JSVa
     NativeString args_01{};
     NativeString args_02{};
     buildUICommandArgs(name, _target, args_01, args_02);
-    foundation::UICommandBuffer::instance(_hostClass->contextId)
+    _hostClass->context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
     return true;
   }
@@ -29,7 +29,7 @@ JSCanvasElement::CanvasElementInstance::CanvasElementInstance(JSCanvasElement *j
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
 
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeCanvasElement);
 }
 
@@ -82,7 +82,7 @@ bool JSCanvasElement::CanvasElementInstance::setProperty(std::string &name, JSVa
 
       buildUICommandArgs(name, widthString, args_01, args_02);
 
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
@@ -95,7 +95,7 @@ bool JSCanvasElement::CanvasElementInstance::setProperty(std::string &name, JSVa
       NativeString args_02{};
 
       buildUICommandArgs(name, heightString, args_01, args_02);
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
@@ -146,7 +146,7 @@ JSValueRef JSCanvasElement::getContext(JSContextRef ctx, JSObjectRef function,
     elementInstance->nativeCanvasElement->getContext(elementInstance->nativeCanvasElement, &contextId);
   auto canvasRenderContext2d = CanvasRenderingContext2D::instance(elementInstance->context);
   auto canvasRenderContext2dInstance = new CanvasRenderingContext2D::CanvasRenderingContext2DInstance(
-    canvasRenderContext2d, nativeCanvasRenderingContext2D);
+    canvasRenderContext2d, nativeCanvasRenderingContext2D, elementInstance->eventTargetId);
   return canvasRenderContext2dInstance->object;
 }
 
@@ -155,13 +155,261 @@ std::unordered_map<JSContext *, CanvasRenderingContext2D *> CanvasRenderingConte
 CanvasRenderingContext2D::CanvasRenderingContext2D(JSContext *context)
   : HostClass(context, "CanvasRenderingContext2D") {}
 
+static bool canvasDisplayListEnabled = true;
+
+void setCanvasDisplayListEnabled(bool enabled) {
+  canvasDisplayListEnabled = enabled;
+}
+
+CanvasDisplayList::CanvasDisplayList(NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D, bool direct)
+  : m_direct(direct) {
+  nativeDisplayList.nativeCanvasRenderingContext2D = nativeCanvasRenderingContext2D;
+}
+
+void CanvasDisplayList::record(CanvasDisplayListOp op, std::initializer_list<double> args) {
+  m_ops.emplace_back(static_cast<double>(op));
+  m_ops.insert(m_ops.end(), args);
+  if (m_direct) {
+    // Commands recorded before must reach dart side before the op is applied.
+    getDartMethod()->flushUICommand();
+    callNative();
+    reset();
+    return;
+  }
+  sync();
+}
+
+void CanvasDisplayList::callNative() {
+  auto native = nativeDisplayList.nativeCanvasRenderingContext2D;
+  const double *ops = m_ops.data();
+  size_t i = 0;
+  auto string = [&](double id) { return &m_strings[static_cast<size_t>(id)]; };
+  while (i < m_ops.size()) {
+    auto op = static_cast<CanvasDisplayListOp>(static_cast<int>(ops[i++]));
+    switch (op) {
+    case CanvasDisplayListOp::setDirection:
+      native->setDirection(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setFont:
+      native->setFont(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setFillStyle:
+      native->setFillStyle(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setStrokeStyle:
+      native->setStrokeStyle(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setLineCap:
+      native->setLineCap(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setLineDashOffset:
+      native->setLineDashOffset(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setLineJoin:
+      native->setLineJoin(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setLineWidth:
+      native->setLineWidth(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setMiterLimit:
+      native->setMiterLimit(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setTextAlign:
+      native->setTextAlign(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::setTextBaseline:
+      native->setTextBaseline(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::arc:
+      native->arc(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+      i += 6;
+      break;
+    case CanvasDisplayListOp::arcTo:
+      native->arcTo(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4]);
+      i += 5;
+      break;
+    case CanvasDisplayListOp::beginPath:
+      native->beginPath(native);
+      break;
+    case CanvasDisplayListOp::bezierCurveTo:
+      native->bezierCurveTo(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+      i += 6;
+      break;
+    case CanvasDisplayListOp::clearRect:
+      native->clearRect(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::clip:
+      native->clip(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::closePath:
+      native->closePath(native);
+      break;
+    case CanvasDisplayListOp::ellipse:
+      native->ellipse(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5], ops[i + 6],
+                      ops[i + 7]);
+      i += 8;
+      break;
+    case CanvasDisplayListOp::fill:
+      native->fill(native, string(ops[i++]));
+      break;
+    case CanvasDisplayListOp::fillRect:
+      native->fillRect(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::fillText:
+      native->fillText(native, string(ops[i]), ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::lineTo:
+      native->lineTo(native, ops[i], ops[i + 1]);
+      i += 2;
+      break;
+    case CanvasDisplayListOp::moveTo:
+      native->moveTo(native, ops[i], ops[i + 1]);
+      i += 2;
+      break;
+    case CanvasDisplayListOp::quadraticCurveTo:
+      native->quadraticCurveTo(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::rect:
+      native->rect(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::restore:
+      native->restore(native);
+      break;
+    case CanvasDisplayListOp::rotate:
+      native->rotate(native, ops[i++]);
+      break;
+    case CanvasDisplayListOp::resetTransform:
+      native->resetTransform(native);
+      break;
+    case CanvasDisplayListOp::save:
+      native->save(native);
+      break;
+    case CanvasDisplayListOp::scale:
+      native->scale(native, ops[i], ops[i + 1]);
+      i += 2;
+      break;
+    case CanvasDisplayListOp::stroke:
+      native->stroke(native);
+      break;
+    case CanvasDisplayListOp::strokeRect:
+      native->strokeRect(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::strokeText:
+      native->strokeText(native, string(ops[i]), ops[i + 1], ops[i + 2], ops[i + 3]);
+      i += 4;
+      break;
+    case CanvasDisplayListOp::setTransform:
+      native->setTransform(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+      i += 6;
+      break;
+    case CanvasDisplayListOp::transform:
+      native->transform(native, ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+      i += 6;
+      break;
+    case CanvasDisplayListOp::translate:
+      native->translate(native, ops[i], ops[i + 1]);
+      i += 2;
+      break;
+    }
+  }
+}
+
+double CanvasDisplayList::string(const uint16_t *string, size_t length) {
+  std::u16string_view key(reinterpret_cast<const char16_t *>(string), length);
+  auto it = m_stringIds.find(key);
+  if (it != m_stringIds.end()) return it->second;
+
+  // Deque never moves stored strings, so views kept in m_stringIds and NativeStrings stay valid.
+  auto &stored = m_stringStorage.emplace_back(key);
+  NativeString nativeString{};
+  nativeString.string = reinterpret_cast<const uint16_t *>(stored.data());
+  nativeString.length = stored.size();
+  int32_t stringId = m_strings.size();
+  m_strings.emplace_back(nativeString);
+  m_stringIds[std::u16string_view(stored.data(), stored.size())] = stringId;
+  sync();
+  return stringId;
+}
+
+bool CanvasDisplayList::isReplayed() {
+  return nativeDisplayList.replayed == 1;
+}
+
+void CanvasDisplayList::reset() {
+  m_ops.clear();
+  m_strings.clear();
+  m_stringIds.clear();
+  m_stringStorage.clear();
+  nativeDisplayList.replayed = 0;
+  sync();
+}
+
+void CanvasDisplayList::sync() {
+  nativeDisplayList.ops = m_ops.data();
+  nativeDisplayList.length = m_ops.size();
+  nativeDisplayList.strings = m_strings.data();
+  nativeDisplayList.stringCount = m_strings.size();
+}
+
 CanvasRenderingContext2D::CanvasRenderingContext2DInstance::CanvasRenderingContext2DInstance(
-  CanvasRenderingContext2D *canvasRenderContext2D, NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D)
-  : Instance(canvasRenderContext2D), nativeCanvasRenderingContext2D(nativeCanvasRenderingContext2D) {}
+  CanvasRenderingContext2D *canvasRenderContext2D, NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D,
+  int32_t canvasId)
+  : Instance(canvasRenderContext2D), nativeCanvasRenderingContext2D(nativeCanvasRenderingContext2D),
+    canvasId(canvasId) {}
 
 CanvasRenderingContext2D::CanvasRenderingContext2DInstance::~CanvasRenderingContext2DInstance() {
   ::foundation::UICommandCallbackQueue::instance()->registerCallback(
     [](void *ptr) { delete reinterpret_cast<NativeCanvasRenderingContext2D *>(ptr); }, nativeCanvasRenderingContext2D);
+  // Submitted display lists may not be replayed yet, release them after dart side consumed current commands.
+  auto displayLists = new std::vector<std::unique_ptr<CanvasDisplayList>>(std::move(m_displayLists));
+  ::foundation::UICommandCallbackQueue::instance()->registerCallback(
+    [](void *ptr) { delete reinterpret_cast<std::vector<std::unique_ptr<CanvasDisplayList>> *>(ptr); }, displayLists);
+}
+
+CanvasDisplayList *CanvasRenderingContext2D::CanvasRenderingContext2DInstance::getDisplayList() {
+  if (!canvasDisplayListEnabled) {
+    if (m_directDisplayList == nullptr) {
+      m_directDisplayList = std::make_unique<CanvasDisplayList>(nativeCanvasRenderingContext2D, true);
+    }
+    return m_directDisplayList.get();
+  }
+
+  auto buffer = _hostClass->context->uiCommandBuffer();
+  // Ops can be appended only while the list is the last command not yet published, otherwise they
+  // would be replayed before commands recorded after the list.
+  if (m_recordingDisplayList != nullptr && m_recordingSequence == buffer->commandSequence()) {
+    return m_recordingDisplayList;
+  }
+
+  m_recordingDisplayList = nullptr;
+  for (auto &displayList : m_displayLists) {
+    if (displayList->isReplayed()) {
+      displayList->reset();
+      m_recordingDisplayList = displayList.get();
+      break;
+    }
+  }
+
+  if (m_recordingDisplayList == nullptr) {
+    m_displayLists.emplace_back(std::make_unique<CanvasDisplayList>(nativeCanvasRenderingContext2D));
+    m_recordingDisplayList = m_displayLists.back().get();
+  }
+
+  buffer->addCommand(canvasId, UICommand::canvasDisplayList, &m_recordingDisplayList->nativeDisplayList);
+  m_recordingSequence = buffer->commandSequence();
+  return m_recordingDisplayList;
+}
+
+void CanvasRenderingContext2D::CanvasRenderingContext2DInstance::recordString(CanvasDisplayListOp op,
+                                                                              JSStringHolder &value) {
+  auto displayList = getDisplayList();
+  displayList->record(op, {displayList->string(value.ptr(), value.size())});
 }
 
 JSValueRef CanvasRenderingContext2D::CanvasRenderingContext2DInstance::getProperty(std::string &name,
@@ -229,139 +477,82 @@ bool CanvasRenderingContext2D::CanvasRenderingContext2DInstance::setProperty(std
   if (propertyMap.count(name) > 0) {
     auto property = propertyMap[name];
 
-    getDartMethod()->flushUICommand();
-
     switch (property) {
     case CanvasRenderingContext2DProperty::direction: {
       JSStringRef direction = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_direction.setString(direction);
 
-      NativeString nativeDirection{};
-      nativeDirection.string = m_direction.ptr();
-      nativeDirection.length = m_direction.size();
-      assert_m(nativeCanvasRenderingContext2D->setDirection != nullptr,
-               "Failed to execute setDirection(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setDirection(nativeCanvasRenderingContext2D, &nativeDirection);
+      recordString(CanvasDisplayListOp::setDirection, m_direction);
       break;
     }
     case CanvasRenderingContext2DProperty::font: {
       JSStringRef font = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_font.setString(font);
 
-      NativeString nativeFont{};
-      nativeFont.string = m_font.ptr();
-      nativeFont.length = m_font.size();
-      assert_m(nativeCanvasRenderingContext2D->setFont != nullptr,
-               "Failed to execute setFont(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setFont(nativeCanvasRenderingContext2D, &nativeFont);
+      recordString(CanvasDisplayListOp::setFont, m_font);
       break;
     }
     case CanvasRenderingContext2DProperty::fillStyle: {
       JSStringRef fillStyle = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_fillStyle.setString(fillStyle);
 
-      NativeString nativeFillStyle{};
-      nativeFillStyle.string = m_fillStyle.ptr();
-      nativeFillStyle.length = m_fillStyle.size();
-      assert_m(nativeCanvasRenderingContext2D->setFillStyle != nullptr,
-               "Failed to execute setFillStyle(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setFillStyle(nativeCanvasRenderingContext2D, &nativeFillStyle);
+      recordString(CanvasDisplayListOp::setFillStyle, m_fillStyle);
       break;
     }
     case CanvasRenderingContext2DProperty::strokeStyle: {
       JSStringRef strokeStyle = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_strokeStyle.setString(strokeStyle);
 
-      NativeString nativeStrokeStyle{};
-      nativeStrokeStyle.string = m_strokeStyle.ptr();
-      nativeStrokeStyle.length = m_strokeStyle.size();
-      assert_m(nativeCanvasRenderingContext2D->setStrokeStyle != nullptr,
-               "Failed to execute setStrokeStyle(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setStrokeStyle(nativeCanvasRenderingContext2D, &nativeStrokeStyle);
+      recordString(CanvasDisplayListOp::setStrokeStyle, m_strokeStyle);
       break;
     }
     case CanvasRenderingContext2DProperty::lineCap: {
       JSStringRef lineCap = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_lineCap.setString(lineCap);
 
-      NativeString nativeLineCap{};
-      nativeLineCap.string = m_lineCap.ptr();
-      nativeLineCap.length = m_lineCap.size();
-      assert_m(nativeCanvasRenderingContext2D->setLineCap != nullptr,
-               "Failed to execute setLineCap(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setLineCap(nativeCanvasRenderingContext2D, &nativeLineCap);
+      recordString(CanvasDisplayListOp::setLineCap, m_lineCap);
       break;
     }
     case CanvasRenderingContext2DProperty::lineDashOffset: {
       JSStringRef lineDashOffset = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_lineDashOffset.setString(lineDashOffset);
 
-      NativeString nativeLineDashOffset{};
-      nativeLineDashOffset.string = m_lineDashOffset.ptr();
-      nativeLineDashOffset.length = m_lineDashOffset.size();
-      assert_m(nativeCanvasRenderingContext2D->setLineDashOffset != nullptr,
-               "Failed to execute setLineDashOffset(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setLineDashOffset(nativeCanvasRenderingContext2D, &nativeLineDashOffset);
+      recordString(CanvasDisplayListOp::setLineDashOffset, m_lineDashOffset);
       break;
     }
     case CanvasRenderingContext2DProperty::lineJoin: {
       JSStringRef lineJoin = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_lineJoin.setString(lineJoin);
 
-      NativeString nativeLineJoin{};
-      nativeLineJoin.string = m_lineJoin.ptr();
-      nativeLineJoin.length = m_lineJoin.size();
-      assert_m(nativeCanvasRenderingContext2D->setLineJoin != nullptr,
-               "Failed to execute setLineJoin(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setLineJoin(nativeCanvasRenderingContext2D, &nativeLineJoin);
+      recordString(CanvasDisplayListOp::setLineJoin, m_lineJoin);
       break;
     }
     case CanvasRenderingContext2DProperty::lineWidth: {
       JSStringRef lineWidth = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_lineWidth.setString(lineWidth);
 
-      NativeString nativeLineWidth{};
-      nativeLineWidth.string = m_lineWidth.ptr();
-      nativeLineWidth.length = m_lineWidth.size();
-      assert_m(nativeCanvasRenderingContext2D->setLineWidth != nullptr,
-               "Failed to execute setLineWidth(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setLineWidth(nativeCanvasRenderingContext2D, &nativeLineWidth);
+      recordString(CanvasDisplayListOp::setLineWidth, m_lineWidth);
       break;
     }
     case CanvasRenderingContext2DProperty::miterLimit: {
       JSStringRef miterLimit = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_miterLimit.setString(miterLimit);
 
-      NativeString nativeMiterLimit{};
-      nativeMiterLimit.string = m_miterLimit.ptr();
-      nativeMiterLimit.length = m_miterLimit.size();
-      assert_m(nativeCanvasRenderingContext2D->setMiterLimit != nullptr,
-               "Failed to execute setMiterLimit(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setMiterLimit(nativeCanvasRenderingContext2D, &nativeMiterLimit);
+      recordString(CanvasDisplayListOp::setMiterLimit, m_miterLimit);
       break;
     }
     case CanvasRenderingContext2DProperty::textAlign: {
       JSStringRef textAlign = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_textAlign.setString(textAlign);
 
-      NativeString nativeTextAlign{};
-      nativeTextAlign.string = m_textAlign.ptr();
-      nativeTextAlign.length = m_textAlign.size();
-      assert_m(nativeCanvasRenderingContext2D->setTextAlign != nullptr,
-               "Failed to execute setTextAlign(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setTextAlign(nativeCanvasRenderingContext2D, &nativeTextAlign);
+      recordString(CanvasDisplayListOp::setTextAlign, m_textAlign);
       break;
     }
     case CanvasRenderingContext2DProperty::textBaseline: {
       JSStringRef textBaseline = JSValueToStringCopy(_hostClass->ctx, value, exception);
       m_textBaseline.setString(textBaseline);
 
-      NativeString nativeTextBaseline{};
-      nativeTextBaseline.string = m_textBaseline.ptr();
-      nativeTextBaseline.length = m_textBaseline.size();
-      assert_m(nativeCanvasRenderingContext2D->setTextBaseline != nullptr,
-               "Failed to execute setTextBaseline(): dart method is nullptr.");
-      nativeCanvasRenderingContext2D->setTextBaseline(nativeCanvasRenderingContext2D, &nativeTextBaseline);
+      recordString(CanvasDisplayListOp::setTextBaseline, m_textBaseline);
       break;
     }
     default:
@@ -402,10 +593,7 @@ JSValueRef CanvasRenderingContext2D::arc(JSContextRef ctx, JSObjectRef function,
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->arc != nullptr,
-           "Failed to execute arc(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->arc(instance->nativeCanvasRenderingContext2D, x, y, radius, startAngle, endAngle, counterclockwise ? 1 : 0);
+  instance->getDisplayList()->record(CanvasDisplayListOp::arc, {x, y, radius, startAngle, endAngle, counterclockwise ? 1.0 : 0.0});
   return nullptr;
 }
 
@@ -432,10 +620,7 @@ JSValueRef CanvasRenderingContext2D::arcTo(JSContextRef ctx, JSObjectRef functio
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->arcTo != nullptr,
-           "Failed to execute arcTo(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->arcTo(instance->nativeCanvasRenderingContext2D, x1, y1, x2, y2, radius);
+  instance->getDisplayList()->record(CanvasDisplayListOp::arcTo, {x1, y1, x2, y2, radius});
   return nullptr;
 }
 
@@ -447,10 +632,7 @@ JSValueRef CanvasRenderingContext2D::beginPath(JSContextRef ctx, JSObjectRef fun
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->beginPath != nullptr,
-           "Failed to execute beginPath(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->beginPath(instance->nativeCanvasRenderingContext2D);
+  instance->getDisplayList()->record(CanvasDisplayListOp::beginPath, {});
   return nullptr;
 }
 
@@ -477,10 +659,7 @@ JSValueRef CanvasRenderingContext2D::bezierCurveTo(JSContextRef ctx, JSObjectRef
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->bezierCurveTo != nullptr,
-           "Failed to execute bezierCurveTo(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->bezierCurveTo(instance->nativeCanvasRenderingContext2D, cp1x, cp1y, cp2x, cp2y, x, y);
+  instance->getDisplayList()->record(CanvasDisplayListOp::bezierCurveTo, {cp1x, cp1y, cp2x, cp2y, x, y});
   return nullptr;
 }
 
@@ -492,10 +671,7 @@ JSValueRef CanvasRenderingContext2D::closePath(JSContextRef ctx, JSObjectRef fun
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->closePath != nullptr,
-           "Failed to execute closePath(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->closePath(instance->nativeCanvasRenderingContext2D);
+  instance->getDisplayList()->record(CanvasDisplayListOp::closePath, {});
   return nullptr;
 }
 
@@ -522,10 +698,8 @@ JSValueRef CanvasRenderingContext2D::clip(JSContextRef ctx, JSObjectRef function
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->clip != nullptr,
-           "Failed to execute clip(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->clip(instance->nativeCanvasRenderingContext2D, &fillRuleNativeString);
+  auto displayList = instance->getDisplayList();
+  displayList->record(CanvasDisplayListOp::clip, {displayList->string(fillRuleNativeString.string, fillRuleNativeString.length)});
   return nullptr;
 }
 
@@ -567,6 +741,7 @@ JSValueRef CanvasRenderingContext2D::drawImage(JSContextRef ctx, JSObjectRef fun
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
+  // Image element is passed by pointer and can not be recorded, replay recorded ops first to keep the drawing order.
   getDartMethod()->flushUICommand();
   assert_m(instance->nativeCanvasRenderingContext2D->drawImage != nullptr,
            "Failed to execute drawImage(): dart method is nullptr.");
@@ -608,10 +783,7 @@ JSValueRef CanvasRenderingContext2D::ellipse(JSContextRef ctx, JSObjectRef funct
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->ellipse != nullptr,
-           "Failed to execute ellipse(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->ellipse(instance->nativeCanvasRenderingContext2D, x, y, radiusX, radiusY, rotation, startAngle, endAngle, counterclockwise ? 1 : 0);
+  instance->getDisplayList()->record(CanvasDisplayListOp::ellipse, {x, y, radiusX, radiusY, rotation, startAngle, endAngle, counterclockwise ? 1.0 : 0.0});
   return nullptr;
 }
 
@@ -639,10 +811,8 @@ JSValueRef CanvasRenderingContext2D::fill(JSContextRef ctx, JSObjectRef function
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->fill != nullptr,
-           "Failed to execute fill(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->fill(instance->nativeCanvasRenderingContext2D, &fillRuleNativeString);
+  auto displayList = instance->getDisplayList();
+  displayList->record(CanvasDisplayListOp::fill, {displayList->string(fillRuleNativeString.string, fillRuleNativeString.length)});
   return nullptr;
 }
 
@@ -665,10 +835,7 @@ JSValueRef CanvasRenderingContext2D::translate(JSContextRef ctx, JSObjectRef fun
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->translate != nullptr,
-           "Failed to execute translate(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->translate(instance->nativeCanvasRenderingContext2D, x, y);
+  instance->getDisplayList()->record(CanvasDisplayListOp::translate, {x, y});
   return nullptr;
 }
 
@@ -693,10 +860,7 @@ JSValueRef CanvasRenderingContext2D::fillRect(JSContextRef ctx, JSObjectRef func
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->fillRect != nullptr,
-           "Failed to execute fillRect(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->fillRect(instance->nativeCanvasRenderingContext2D, x, y, width, height);
+  instance->getDisplayList()->record(CanvasDisplayListOp::fillRect, {x, y, width, height});
   return nullptr;
 }
 
@@ -722,10 +886,7 @@ JSValueRef CanvasRenderingContext2D::rect(JSContextRef ctx, JSObjectRef function
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->rect != nullptr,
-           "Failed to execute rect(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->rect(instance->nativeCanvasRenderingContext2D, x, y, width, height);
+  instance->getDisplayList()->record(CanvasDisplayListOp::rect, {x, y, width, height});
   return nullptr;
 }
 
@@ -748,10 +909,7 @@ JSValueRef CanvasRenderingContext2D::rotate(JSContextRef ctx, JSObjectRef functi
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->rotate != nullptr,
-           "Failed to execute rotate(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->rotate(instance->nativeCanvasRenderingContext2D, angle);
+  instance->getDisplayList()->record(CanvasDisplayListOp::rotate, {angle});
   return nullptr;
 }
 
@@ -777,10 +935,7 @@ JSValueRef CanvasRenderingContext2D::clearRect(JSContextRef ctx, JSObjectRef fun
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->clearRect != nullptr,
-           "Failed to execute clearRect(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->clearRect(instance->nativeCanvasRenderingContext2D, x, y, width, height);
+  instance->getDisplayList()->record(CanvasDisplayListOp::clearRect, {x, y, width, height});
 
   return nullptr;
 }
@@ -804,10 +959,7 @@ JSValueRef CanvasRenderingContext2D::strokeRect(
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->strokeRect != nullptr,
-           "Failed to execute strokeRect(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->strokeRect(instance->nativeCanvasRenderingContext2D, x, y, width, height);
+  instance->getDisplayList()->record(CanvasDisplayListOp::strokeRect, {x, y, width, height});
 
   return nullptr;
 }
@@ -842,10 +994,8 @@ JSValueRef CanvasRenderingContext2D::fillText(JSContextRef ctx, JSObjectRef func
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->fillText != nullptr,
-           "Failed to execute fillText(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->fillText(instance->nativeCanvasRenderingContext2D, &text, x, y, maxWidth);
+  auto displayList = instance->getDisplayList();
+  displayList->record(CanvasDisplayListOp::fillText, {displayList->string(text.string, text.length), x, y, maxWidth});
   return nullptr;
 }
 
@@ -868,10 +1018,7 @@ JSValueRef CanvasRenderingContext2D::lineTo(JSContextRef ctx, JSObjectRef functi
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->lineTo != nullptr,
-           "Failed to execute lineTo(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->lineTo(instance->nativeCanvasRenderingContext2D, x, y);
+  instance->getDisplayList()->record(CanvasDisplayListOp::lineTo, {x, y});
   return nullptr;
 }
 
@@ -894,10 +1041,7 @@ JSValueRef CanvasRenderingContext2D::moveTo(JSContextRef ctx, JSObjectRef functi
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->moveTo != nullptr,
-           "Failed to execute moveTo(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->moveTo(instance->nativeCanvasRenderingContext2D, x, y);
+  instance->getDisplayList()->record(CanvasDisplayListOp::moveTo, {x, y});
   return nullptr;
 }
 
@@ -920,10 +1064,7 @@ JSValueRef CanvasRenderingContext2D::quadraticCurveTo(
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->quadraticCurveTo != nullptr,
-           "Failed to execute quadraticCurveTo(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->quadraticCurveTo(instance->nativeCanvasRenderingContext2D, cpx, cpy, x, y);
+  instance->getDisplayList()->record(CanvasDisplayListOp::quadraticCurveTo, {cpx, cpy, x, y});
 
   return nullptr;
 }
@@ -956,10 +1097,8 @@ JSValueRef CanvasRenderingContext2D::strokeText(
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->strokeText != nullptr,
-           "Failed to execute strokeText(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->strokeText(instance->nativeCanvasRenderingContext2D, &text, x, y, maxWidth);
+  auto displayList = instance->getDisplayList();
+  displayList->record(CanvasDisplayListOp::strokeText, {displayList->string(text.string, text.length), x, y, maxWidth});
   return nullptr;
 }
 
@@ -970,10 +1109,7 @@ JSValueRef CanvasRenderingContext2D::save(JSContextRef ctx, JSObjectRef function
                                           JSValueRef *exception) {
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->save != nullptr,
-           "Failed to execute save(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->save(instance->nativeCanvasRenderingContext2D);
+  instance->getDisplayList()->record(CanvasDisplayListOp::save, {});
   return nullptr;
 }
 
@@ -985,10 +1121,7 @@ JSValueRef CanvasRenderingContext2D::stroke(JSContextRef ctx, JSObjectRef functi
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->stroke != nullptr,
-           "Failed to execute stroke(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->stroke(instance->nativeCanvasRenderingContext2D);
+  instance->getDisplayList()->record(CanvasDisplayListOp::stroke, {});
   return nullptr;
 }
 
@@ -1012,10 +1145,7 @@ JSValueRef CanvasRenderingContext2D::scale(JSContextRef ctx, JSObjectRef functio
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->scale != nullptr,
-           "Failed to execute scale(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->scale(instance->nativeCanvasRenderingContext2D, x, y);
+  instance->getDisplayList()->record(CanvasDisplayListOp::scale, {x, y});
   return nullptr;
 }
 
@@ -1027,10 +1157,7 @@ JSValueRef CanvasRenderingContext2D::restore(JSContextRef ctx, JSObjectRef funct
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->restore != nullptr,
-           "Failed to execute restore(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->restore(instance->nativeCanvasRenderingContext2D);
+  instance->getDisplayList()->record(CanvasDisplayListOp::restore, {});
   return nullptr;
 }
 
@@ -1042,10 +1169,7 @@ JSValueRef CanvasRenderingContext2D::resetTransform(JSContextRef ctx, JSObjectRe
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->resetTransform != nullptr,
-           "Failed to execute resetTransform(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->resetTransform(instance->nativeCanvasRenderingContext2D);
+  instance->getDisplayList()->record(CanvasDisplayListOp::resetTransform, {});
   return nullptr;
 }
 
@@ -1072,10 +1196,7 @@ JSValueRef CanvasRenderingContext2D::setTransform(JSContextRef ctx, JSObjectRef
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->setTransform != nullptr,
-           "Failed to execute setTransform(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->setTransform(instance->nativeCanvasRenderingContext2D, a, b, c, d, e, f);
+  instance->getDisplayList()->record(CanvasDisplayListOp::setTransform, {a, b, c, d, e, f});
   return nullptr;
 }
 
@@ -1102,10 +1223,7 @@ JSValueRef CanvasRenderingContext2D::transform(JSContextRef ctx, JSObjectRef fun
   auto instance =
     reinterpret_cast<CanvasRenderingContext2D::CanvasRenderingContext2DInstance *>(JSObjectGetPrivate(thisObject));
 
-  getDartMethod()->flushUICommand();
-  assert_m(instance->nativeCanvasRenderingContext2D->transform != nullptr,
-           "Failed to execute transform(): dart method is nullptr.");
-  instance->nativeCanvasRenderingContext2D->transform(instance->nativeCanvasRenderingContext2D, a, b, c, d, e, f);
+  instance->getDisplayList()->record(CanvasDisplayListOp::transform, {a, b, c, d, e, f});
   return nullptr;
 }
 
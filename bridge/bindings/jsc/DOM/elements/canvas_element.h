@@ -8,6 +8,7 @@
 
 #include "bindings/jsc/DOM/element.h"
 #include "bindings/jsc/js_context_internal.h"
+#include <deque>
 
 namespace kraken::binding::jsc {
 
@@ -148,6 +149,90 @@ struct NativeCanvasRenderingContext2D {
   Translate translate{nullptr};
 };
 
+// Opcodes of canvas display list, must be as same as the CanvasDisplayListOp enum of dart side.
+// Each opcode is followed by a fixed count of doubles, strings are passed as index of the string table.
+enum class CanvasDisplayListOp {
+  setDirection,
+  setFont,
+  setFillStyle,
+  setStrokeStyle,
+  setLineCap,
+  setLineDashOffset,
+  setLineJoin,
+  setLineWidth,
+  setMiterLimit,
+  setTextAlign,
+  setTextBaseline,
+  arc,
+  arcTo,
+  beginPath,
+  bezierCurveTo,
+  clearRect,
+  clip,
+  closePath,
+  ellipse,
+  fill,
+  fillRect,
+  fillText,
+  lineTo,
+  moveTo,
+  quadraticCurveTo,
+  rect,
+  restore,
+  rotate,
+  resetTransform,
+  save,
+  scale,
+  stroke,
+  strokeRect,
+  strokeText,
+  setTransform,
+  transform,
+  translate
+};
+
+// Field's order must be as same as the NativeCanvasDisplayList class of dart side.
+struct NativeCanvasDisplayList {
+  NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D{nullptr};
+  double *ops{nullptr};
+  int64_t length{0};
+  NativeString *strings{nullptr};
+  int64_t stringCount{0};
+  // Set to 1 by dart side after all ops are replayed.
+  int64_t replayed{0};
+};
+
+// Canvas ops recorded at JS side, dart side replays the whole list when UICommand::canvasDisplayList is consumed
+// instead of being called once per op.
+class CanvasDisplayList {
+public:
+  CanvasDisplayList() = delete;
+  // A direct list is never submitted, every op calls NativeCanvasRenderingContext2D right after being recorded.
+  explicit CanvasDisplayList(NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D, bool direct = false);
+
+  void record(CanvasDisplayListOp op, std::initializer_list<double> args);
+  // Strings such as fillStyle and font repeat a lot, each distinct value is stored once per list.
+  double string(const uint16_t *string, size_t length);
+  bool isReplayed();
+  void reset();
+
+  NativeCanvasDisplayList nativeDisplayList;
+
+private:
+  void sync();
+  void callNative();
+
+  bool m_direct;
+  std::vector<double> m_ops;
+  std::vector<NativeString> m_strings;
+  std::deque<std::u16string> m_stringStorage;
+  std::unordered_map<std::u16string_view, int32_t> m_stringIds;
+};
+
+// Display lists are enabled by default. Disabling them calls the dart side once per op as before, benchmarks use
+// it to compare both paths.
+void setCanvasDisplayListEnabled(bool enabled);
+
 class CanvasRenderingContext2D : public HostClass {
 public:
   static std::unordered_map<JSContext *, CanvasRenderingContext2D *> instanceMap;
@@ -224,15 +309,24 @@ public:
 
     CanvasRenderingContext2DInstance() = delete;
     explicit CanvasRenderingContext2DInstance(CanvasRenderingContext2D *canvasRenderContext2D,
-                                              NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D);
+                                              NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D,
+                                              int32_t canvasId);
     ~CanvasRenderingContext2DInstance() override;
     JSValueRef getProperty(std::string &name, JSValueRef *exception) override;
     bool setProperty(std::string &name, JSValueRef value, JSValueRef *exception) override;
     void getPropertyNames(JSPropertyNameAccumulatorRef accumulator) override;
 
     NativeCanvasRenderingContext2D *nativeCanvasRenderingContext2D;
+    // Display list which accepts new ops, a new one is submitted when other commands are recorded after it.
+    CanvasDisplayList *getDisplayList();
+    void recordString(CanvasDisplayListOp op, JSStringHolder &value);
 
   private:
+    int32_t canvasId;
+    std::vector<std::unique_ptr<CanvasDisplayList>> m_displayLists;
+    std::unique_ptr<CanvasDisplayList> m_directDisplayList;
+    CanvasDisplayList *m_recordingDisplayList{nullptr};
+    uint64_t m_recordingSequence{0};
     JSStringHolder m_direction{context, ""};
     JSStringHolder m_font{context, ""};
     JSStringHolder m_fillStyle{context, ""};
@@ -32,7 +32,7 @@ JSImageElement::ImageElementInstance::ImageElementInstance(JSImageElement *jsAnc
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
 
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeImageElement);
 }
 
@@ -82,7 +82,7 @@ bool JSImageElement::ImageElementInstance::setProperty(std::string &name, JSValu
       NativeString args_01{};
       NativeString args_02{};
       buildUICommandArgs(name, string, args_01, args_02);
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
@@ -93,7 +93,7 @@ bool JSImageElement::ImageElementInstance::setProperty(std::string &name, JSValu
       NativeString args_01{};
       NativeString args_02{};
       buildUICommandArgs(name, src, args_01, args_02);
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
@@ -104,7 +104,7 @@ bool JSImageElement::ImageElementInstance::setProperty(std::string &name, JSValu
       NativeString args_01{};
       NativeString args_02{};
       buildUICommandArgs(name, loading, args_01, args_02);
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
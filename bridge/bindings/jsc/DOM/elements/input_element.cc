@@ -61,7 +61,7 @@ JSInputElement::InputElementInstance::InputElementInstance(JSInputElement *jsAnc
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
 
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeInputElement);
 }
 
@@ -106,7 +106,7 @@ bool JSInputElement::InputElementInstance::setProperty(std::string &name, JSValu
     NativeString args_01{};
     NativeString args_02{};
     buildUICommandArgs(name, string, args_01, args_02);
-    foundation::UICommandBuffer::instance(_hostClass->contextId)
+    _hostClass->context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
     return true;
   } else {
@@ -26,7 +26,7 @@ JSObjectElement::ObjectElementInstance::ObjectElementInstance(JSObjectElement *j
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
 
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeObjectElement);
 }
 
@@ -64,7 +64,7 @@ bool JSObjectElement::ObjectElementInstance::setProperty(std::string &name, JSVa
       NativeString args_02{};
 
       buildUICommandArgs(name, dataStringRef, args_01, args_02);
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId,UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
@@ -76,7 +76,7 @@ bool JSObjectElement::ObjectElementInstance::setProperty(std::string &name, JSVa
       NativeString args_02{};
 
       buildUICommandArgs(name, typeStringRef, args_01, args_02);
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(eventTargetId,UICommand::setProperty, args_01, args_02, nullptr);
       break;
     }
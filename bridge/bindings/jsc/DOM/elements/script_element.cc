@@ -27,7 +27,7 @@ JSScriptElement::ScriptElementInstance::ScriptElementInstance(JSScriptElement *j
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
 
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeElement);
 }
 
@@ -59,7 +59,7 @@ bool JSScriptElement::ScriptElementInstance::setProperty(std::string &name, JSVa
     NativeString args_01{};
     NativeString args_02{};
     buildUICommandArgs(name, srcString, args_01, args_02);
-    foundation::UICommandBuffer::instance(_hostClass->contextId)
+    _hostClass->context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
     return true;
   }
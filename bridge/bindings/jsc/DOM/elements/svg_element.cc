@@ -33,7 +33,7 @@ JSSVGElement::SVGElementInstance::SVGElementInstance(JSSVGElement *jsSVGElement)
   NativeString args_01{};
   buildUICommandArgs(tagName, args_01);
 
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createElement, args_01, nativeSVGElement);
 }
 
@@ -42,8 +42,10 @@ JSObjectRef JSEvent::instanceConstructor(JSContextRef ctx, JSObjectRef construct
   const JSValueRef eventTypeValueRef = arguments[0];
   JSStringRef eventTypeStringRef = JSValueToStringCopy(ctx, eventTypeValueRef, exception);
   std::string &&eventType = JSStringToStdString(eventTypeStringRef);
-  auto nativeEvent = new NativeEvent(stringToNativeString(eventType));
+  auto nativeEvent = context->eventPayloadPool()->acquireEvent(eventType);
   auto event = JSEvent::buildEventInstance(eventType, context, nativeEvent, false);
+  // Subclasses built from a plain payload free it themselves, only plain events hand it back.
+  event->pooledPayload = eventCreatorMap.count(eventType) == 0;
 
   return event->object;
 }
@@ -76,11 +78,154 @@ JSValueRef JSEvent::getProperty(std::string &name, JSValueRef *exception) {
   return HostClass::getProperty(name, exception);
 }
 
+int32_t EventTypeAtoms::intern(const uint16_t *string, size_t length) {
+  int32_t atom = find(string, length);
+  if (atom != NOT_INTERNED) return atom;
+
+  auto &eventType = m_eventTypes.emplace_back(reinterpret_cast<const char16_t *>(string), length);
+  atom = m_eventTypes.size() - 1;
+  m_atoms[std::u16string_view(eventType)] = atom;
+  m_utf8Atoms[toUTF8(eventType)] = atom;
+  return atom;
+}
+
+int32_t EventTypeAtoms::intern(const std::string &eventType) {
+  int32_t atom = find(eventType);
+  if (atom != NOT_INTERNED) return atom;
+
+  std::u16string u16EventType;
+  fromUTF8(eventType, u16EventType);
+  return intern(reinterpret_cast<const uint16_t *>(u16EventType.c_str()), u16EventType.length());
+}
+
+int32_t EventTypeAtoms::find(const uint16_t *string, size_t length) const {
+  auto it = m_atoms.find(std::u16string_view(reinterpret_cast<const char16_t *>(string), length));
+  return it != m_atoms.end() ? it->second : NOT_INTERNED;
+}
+
+int32_t EventTypeAtoms::find(const std::string &eventType) const {
+  auto it = m_utf8Atoms.find(eventType);
+  return it != m_utf8Atoms.end() ? it->second : NOT_INTERNED;
+}
+
+namespace {
+// Compares the type string of a payload with the UTF-8 type of a script created event without converting either,
+// non ASCII types never match and just get a new string.
+bool isSameEventType(NativeString *type, const std::string &eventType) {
+  if (type->length != eventType.size()) return false;
+  for (size_t i = 0; i < eventType.size(); i++) {
+    auto c = static_cast<unsigned char>(eventType[i]);
+    if (c >= 0x80 || type->string[i] != c) return false;
+  }
+  return true;
+}
+} // namespace
+
+EventPayloadPool::~EventPayloadPool() {
+  for (NativeEvent *nativeEvent : m_events) {
+    nativeEvent->type->free();
+    delete nativeEvent;
+  }
+  for (NativeInputEvent *nativeInputEvent : m_inputEvents) delete nativeInputEvent;
+  for (NativeTouchEvent *nativeTouchEvent : m_touchEvents) delete nativeTouchEvent;
+}
+
+NativeEvent *EventPayloadPool::acquireEvent(std::string &eventType) {
+  if (m_events.empty()) {
+    m_stats.misses++;
+    return new NativeEvent(stringToNativeString(eventType));
+  }
+
+  // Prefer a payload which already carries the type string, the most recently released one otherwise.
+  size_t index = m_events.size() - 1;
+  for (size_t i = m_events.size(); i > 0; i--) {
+    if (isSameEventType(m_events[i - 1]->type, eventType)) {
+      index = i - 1;
+      break;
+    }
+  }
+
+  NativeEvent *nativeEvent = m_events[index];
+  m_events[index] = m_events.back();
+  m_events.pop_back();
+  m_stats.hits++;
+
+  NativeString *type = nativeEvent->type;
+  if (!isSameEventType(type, eventType)) {
+    type->free();
+    type = stringToNativeString(eventType);
+  }
+  *nativeEvent = NativeEvent(type);
+  return nativeEvent;
+}
+
+void EventPayloadPool::releaseEvent(NativeEvent *nativeEvent) {
+  if (m_events.size() >= MAX_POOLED_EVENTS) {
+    m_stats.dropped++;
+    nativeEvent->type->free();
+    delete nativeEvent;
+    return;
+  }
+
+  m_events.push_back(nativeEvent);
+  m_stats.recycled++;
+}
+
+NativeInputEvent *EventPayloadPool::acquireInputEvent(NativeEvent *nativeEvent) {
+  if (m_inputEvents.empty()) {
+    m_stats.misses++;
+    return new NativeInputEvent(nativeEvent);
+  }
+
+  NativeInputEvent *nativeInputEvent = m_inputEvents.back();
+  m_inputEvents.pop_back();
+  m_stats.hits++;
+  *nativeInputEvent = NativeInputEvent(nativeEvent);
+  return nativeInputEvent;
+}
+
+void EventPayloadPool::releaseInputEvent(NativeInputEvent *nativeInputEvent) {
+  if (m_inputEvents.size() >= MAX_POOLED_EVENTS) {
+    m_stats.dropped++;
+    delete nativeInputEvent;
+    return;
+  }
+  m_inputEvents.push_back(nativeInputEvent);
+  m_stats.recycled++;
+}
+
+NativeTouchEvent *EventPayloadPool::acquireTouchEvent(NativeEvent *nativeEvent) {
+  if (m_touchEvents.empty()) {
+    m_stats.misses++;
+    return new NativeTouchEvent(nativeEvent);
+  }
+
+  NativeTouchEvent *nativeTouchEvent = m_touchEvents.back();
+  m_touchEvents.pop_back();
+  m_stats.hits++;
+  *nativeTouchEvent = NativeTouchEvent(nativeEvent);
+  return nativeTouchEvent;
+}
+
+void EventPayloadPool::releaseTouchEvent(NativeTouchEvent *nativeTouchEvent) {
+  if (m_touchEvents.size() >= MAX_POOLED_EVENTS) {
+    m_stats.dropped++;
+    delete nativeTouchEvent;
+    return;
+  }
+  m_touchEvents.push_back(nativeTouchEvent);
+  m_stats.recycled++;
+}
+
 EventInstance::EventInstance(JSEvent *jsEvent, NativeEvent *nativeEvent)
-  : Instance(jsEvent), nativeEvent(nativeEvent) {}
+  : Instance(jsEvent), nativeEvent(nativeEvent) {
+  eventTypeAtom = context->eventTypeAtoms()->find(nativeEvent->type->string, nativeEvent->type->length);
+}
 
 EventInstance::EventInstance(JSEvent *jsEvent, std::string eventType, JSValueRef eventInitValueRef, JSValueRef *exception) : Instance(jsEvent) {
-  nativeEvent = new NativeEvent(stringToNativeString(eventType));
+  nativeEvent = context->eventPayloadPool()->acquireEvent(eventType);
+  pooledPayload = true;
+  eventTypeAtom = context->eventTypeAtoms()->find(eventType);
   auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
   nativeEvent->timeStamp = ms.count();
 
@@ -164,7 +309,7 @@ JSValueRef JSEvent::initEvent(JSContextRef ctx, JSObjectRef function, JSObjectRe
   std::string type = JSStringToStdString(typeStringRef);
 
   auto eventInstance = static_cast<EventInstance *>(JSObjectGetPrivate(thisObject));
-  eventInstance->nativeEvent->type = stringToNativeString(type);
+  eventInstance->setType(stringToNativeString(type));
   eventInstance->nativeEvent->bubbles = JSValueToBoolean(ctx, bubblesValueRef) ? 1 : 0;
   eventInstance->nativeEvent->cancelable = JSValueToBoolean(ctx, cancelableValueRef) ? 1 : 0;
 
@@ -220,7 +365,24 @@ bool EventInstance::setProperty(std::string &name, JSValueRef value, JSValueRef
   }
 }
 
+void EventInstance::setType(NativeString *type) {
+  nativeEvent->type->free();
+  nativeEvent->type = type;
+  eventTypeAtom = context->eventTypeAtoms()->find(type->string, type->length);
+}
+
+int32_t EventInstance::resolveEventTypeAtom() {
+  if (eventTypeAtom == EventTypeAtoms::NOT_INTERNED) {
+    eventTypeAtom = context->eventTypeAtoms()->find(nativeEvent->type->string, nativeEvent->type->length);
+  }
+  return eventTypeAtom;
+}
+
 EventInstance::~EventInstance() {
+  if (pooledPayload && context->isValid()) {
+    context->eventPayloadPool()->releaseEvent(nativeEvent);
+    return;
+  }
   nativeEvent->type->free();
   delete nativeEvent;
 }
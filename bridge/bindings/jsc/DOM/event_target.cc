@@ -6,7 +6,7 @@
 #include "dart_methods.h"
 #include "document.h"
 #include "event.h"
-#include <codecvt>
+#include "foundation/trace_event.h"
 
 namespace kraken::binding::jsc {
 
@@ -30,10 +30,43 @@ JSEventTarget::~JSEventTarget() {
   instanceMap.erase(context);
 }
 
-JSEventTarget::JSEventTarget(JSContext *context, const char *name) : HostClass(context, name) {}
+bool JSEventTarget::hasEventListeners(int32_t eventTypeAtom) {
+  return eventListenerCount(eventTypeAtom) > 0;
+}
+
+int32_t JSEventTarget::eventListenerCount(int32_t eventTypeAtom) {
+  if (eventTypeAtom < 0 || static_cast<size_t>(eventTypeAtom) >= m_eventListenerCounts.size()) return 0;
+  return m_eventListenerCounts[eventTypeAtom];
+}
+
+void JSEventTarget::updateEventListenerCount(int32_t eventTypeAtom, int32_t delta) {
+  if (static_cast<size_t>(eventTypeAtom) >= m_eventListenerCounts.size()) {
+    m_eventListenerCounts.resize(eventTypeAtom + 1, 0);
+  }
+  m_eventListenerCounts[eventTypeAtom] += delta;
+}
+
+const JSStaticFunction JSEventTarget::prototypeStaticFunctions[] = {
+  {"addEventListener", addEventListener, kJSPropertyAttributeNone},
+  {"removeEventListener", removeEventListener, kJSPropertyAttributeNone},
+  {"dispatchEvent", dispatchEvent, kJSPropertyAttributeNone},
+#ifdef IS_TEST
+  {"__kraken_clear_event_listeners__", clearListeners, kJSPropertyAttributeNone},
+#endif
+  {nullptr, nullptr, 0}};
+
+JSClassRef JSEventTarget::prototypeClass() {
+  return getPrototypeClassRef("EventTarget", nullptr, prototypeStaticFunctions);
+}
+
+JSEventTarget::JSEventTarget(JSContext *context, const char *name) : HostClass(context, name) {
+  setPrototypeClass(prototypeClass());
+}
 JSEventTarget::JSEventTarget(JSContext *context, const JSStaticFunction *staticFunction,
                              const JSStaticValue *staticValue)
-  : HostClass(context, nullptr, "EventTarget", staticFunction, staticValue) {}
+  : HostClass(context, nullptr, "EventTarget", staticFunction, staticValue) {
+  setPrototypeClass(prototypeClass());
+}
 
 JSObjectRef JSEventTarget::instanceConstructor(JSContextRef ctx, JSObjectRef constructor, size_t argumentCount,
                                                const JSValueRef *arguments, JSValueRef *exception) {
@@ -75,14 +108,26 @@ EventTargetInstance::EventTargetInstance(JSEventTarget *eventTarget, int64_t id)
 
 EventTargetInstance::~EventTargetInstance() {
   // Recycle eventTarget object could be triggered by hosting JSContext been released or reference count set to 0.
-  foundation::UICommandBuffer::instance(_hostClass->contextId)
-      ->addCommand(eventTargetId, UICommand::disposeEventTarget, nullptr, false);
+  // A context in a shared group is finalized after release, when its id may already belong to another page.
+  if (context->isValid() || !context->isInSharedGroup()) {
+    _hostClass->context->uiCommandBuffer()
+        ->addCommand(eventTargetId, UICommand::disposeEventTarget, nullptr, false);
+  }
 
   // Release handler callbacks.
   if (context->isValid()) {
-    for (auto &it : _eventHandlers) {
-      for (auto &handler : it.second) {
-        JSValueUnprotect(_hostClass->ctx, handler);
+    auto EventTarget = JSEventTarget::instance(context);
+    for (auto &handlers : _eventHandlers) {
+      if (handlers.listeners != nullptr) {
+        for (auto &handler : *handlers.listeners) {
+          JSValueUnprotect(_hostClass->ctx, handler);
+        }
+        EventTarget->updateEventListenerCount(handlers.eventTypeAtom,
+                                              -static_cast<int32_t>(handlers.listeners->size()));
+      }
+      if (handlers.propertyHandler != nullptr) {
+        JSValueUnprotect(_hostClass->ctx, handlers.propertyHandler);
+        EventTarget->updateEventListenerCount(handlers.eventTypeAtom, -1);
       }
     }
   }
@@ -128,19 +173,16 @@ JSValueRef JSEventTarget::addEventListener(JSContextRef ctx, JSObjectRef functio
     return nullptr;
   }
 
-  std::string eventType = JSStringToStdString(JSValueToStringCopy(ctx, eventNameValueRef, exception));
+  JSStringRef eventTypeStringRef = JSValueToStringCopy(ctx, eventNameValueRef, exception);
+  std::string eventType = JSStringToStdString(eventTypeStringRef);
+  int32_t eventTypeAtom = eventTargetInstance->context->eventTypeAtoms()->intern(
+    JSStringGetCharactersPtr(eventTypeStringRef), JSStringGetLength(eventTypeStringRef));
 
-  // Init list.
-  if (eventTargetInstance->_eventHandlers.count(eventType) == 0) {
-    eventTargetInstance->_eventHandlers[eventType] = std::forward_list<JSObjectRef>();
-  }
-
-  JSObjectRef &propertyHandlers = eventTargetInstance->_propertyEventHandler[eventType];
+  auto &eventHandlers = eventTargetInstance->ensureEventHandlers(eventTypeAtom);
+  std::vector<JSObjectRef> &handlers = eventTargetInstance->mutableListeners(eventHandlers);
 
   // Dart needs to be notified for the first registration event.
-  if (eventTargetInstance->_eventHandlers[eventType].empty() || JSObjectIsFunction(ctx, propertyHandlers)) {
-    int32_t contextId = eventTargetInstance->_hostClass->contextId;
-
+  if (handlers.empty() || JSObjectIsFunction(ctx, eventHandlers.propertyHandler)) {
     NativeString args_01{};
     buildUICommandArgs(eventType, args_01);
 
@@ -149,14 +191,14 @@ JSValueRef JSEventTarget::addEventListener(JSContextRef ctx, JSObjectRef functio
       std::find(EventTarget->m_jsOnlyEvents.begin(), EventTarget->m_jsOnlyEvents.end(), eventType) != EventTarget->m_jsOnlyEvents.end();
 
     if (!isJsOnlyEvent) {
-      foundation::UICommandBuffer::instance(contextId)->addCommand(
+      eventTargetInstance->context->uiCommandBuffer()->addCommand(
         eventTargetInstance->eventTargetId, UICommand::addEvent, args_01, nullptr);
     };
   }
 
-  std::forward_list<JSObjectRef> &handlers = eventTargetInstance->_eventHandlers[eventType];
   JSValueProtect(ctx, callbackObjectRef);
-  handlers.emplace_after(handlers.cbefore_begin(), callbackObjectRef);
+  handlers.emplace_back(callbackObjectRef);
+  JSEventTarget::instance(eventTargetInstance->context)->updateEventListenerCount(eventTypeAtom, 1);
 
   return nullptr;
 }
@@ -212,28 +254,27 @@ JSValueRef JSEventTarget::removeEventListener(JSContextRef ctx, JSObjectRef func
     return nullptr;
   }
 
-  std::string eventType = JSStringToStdString(JSValueToStringCopy(ctx, eventNameValueRef, exception));
+  JSStringRef eventTypeStringRef = JSValueToStringCopy(ctx, eventNameValueRef, exception);
+  std::string eventType = JSStringToStdString(eventTypeStringRef);
+  int32_t eventTypeAtom = eventTargetInstance->context->eventTypeAtoms()->find(
+    JSStringGetCharactersPtr(eventTypeStringRef), JSStringGetLength(eventTypeStringRef));
 
-  if (eventTargetInstance->_eventHandlers.count(eventType) == 0) {
+  auto eventHandlers = eventTargetInstance->getEventHandlers(eventTypeAtom);
+  if (eventHandlers == nullptr || eventHandlers->listeners == nullptr) {
     return nullptr;
   }
 
-  std::forward_list<JSObjectRef> &handlers = eventTargetInstance->_eventHandlers[eventType];
-
-  handlers.remove_if([&callbackObjectRef, &ctx](JSObjectRef function) {
-    if (function == callbackObjectRef) {
-      JSValueUnprotect(ctx, callbackObjectRef);
-      return true;
-    }
-    return false;
-  });
-
-  JSObjectRef &propertyHandlers = eventTargetInstance->_propertyEventHandler[eventType];
+  std::vector<JSObjectRef> &handlers = eventTargetInstance->mutableListeners(*eventHandlers);
+  auto it = std::remove(handlers.begin(), handlers.end(), callbackObjectRef);
+  for (auto removed = it; removed != handlers.end(); removed++) {
+    JSValueUnprotect(ctx, callbackObjectRef);
+  }
+  JSEventTarget::instance(eventTargetInstance->context)
+    ->updateEventListenerCount(eventTypeAtom, -static_cast<int32_t>(std::distance(it, handlers.end())));
+  handlers.erase(it, handlers.end());
 
-  if (handlers.empty() && JSObjectIsFunction(ctx, propertyHandlers)) {
+  if (handlers.empty() && JSObjectIsFunction(ctx, eventHandlers->propertyHandler)) {
     // Dart needs to be notified for handles is empty.
-    int32_t contextId = eventTargetInstance->_hostClass->contextId;
-
     NativeString args_01{};
     buildUICommandArgs(eventType, args_01);
 
@@ -242,7 +283,7 @@ JSValueRef JSEventTarget::removeEventListener(JSContextRef ctx, JSObjectRef func
       std::find(EventTarget->m_jsOnlyEvents.begin(), EventTarget->m_jsOnlyEvents.end(), eventType) != EventTarget->m_jsOnlyEvents.end();
 
     if (!isJsOnlyEvent) {
-      foundation::UICommandBuffer::instance(contextId)->addCommand(
+      eventTargetInstance->context->uiCommandBuffer()->addCommand(
         eventTargetInstance->eventTargetId, UICommand::removeEvent, args_01, nullptr);
     };
   }
@@ -272,52 +313,71 @@ JSValueRef JSEventTarget::dispatchEvent(JSContextRef ctx, JSObjectRef function,
 }
 
 bool EventTargetInstance::dispatchEvent(EventInstance *event) {
-  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t *>(event->nativeEvent->type->string),
-                                            event->nativeEvent->type->length);
-  std::string eventType = toUTF8(u16EventType);
+  // Nobody in this context listens to it, skip walking the tree.
+  if (!JSEventTarget::instance(context)->hasEventListeners(event->resolveEventTypeAtom())) return event->_cancelled;
 
-  // Modify the currentTarget to this.
-  event->nativeEvent->currentTarget = this;
+  foundation::TraceScope trace("EventTarget.dispatchEvent", context->getContextId());
+  if (trace.isActive()) {
+    std::u16string eventType(reinterpret_cast<const char16_t *>(event->nativeEvent->type->string),
+                             event->nativeEvent->type->length);
+    trace.setDetail(foundation::TraceLog::internString(toUTF8(eventType)));
+  }
 
-  internalDispatchEvent(event);
+  EventTargetInstance *target = this;
 
   // Bubble event to root event target.
-  if (event->nativeEvent->bubbles == 1 && !event->_propagationStopped) {
-    auto node = reinterpret_cast<NodeInstance *>(event->nativeEvent->currentTarget);
-    NodeInstance* parent = node->parentNode;
+  while (target != nullptr) {
+    // Modify the currentTarget to this.
+    event->nativeEvent->currentTarget = target;
+    target->internalDispatchEvent(event);
 
-    if (parent != nullptr) {
-      parent->dispatchEvent(event);
-    }
+    if (event->nativeEvent->bubbles != 1 || event->_propagationStopped) break;
+    target = target->parentEventTarget();
   }
 
   return event->_cancelled;
 }
 
+bool EventTargetInstance::hasEventListener(int32_t eventTypeAtom) {
+  if (!JSEventTarget::instance(context)->hasEventListeners(eventTypeAtom)) return false;
+
+  for (EventTargetInstance *target = this; target != nullptr; target = target->parentEventTarget()) {
+    auto eventHandlers = target->getEventHandlers(eventTypeAtom);
+    if (eventHandlers == nullptr) continue;
+    if (eventHandlers->propertyHandler != nullptr) return true;
+    if (eventHandlers->listeners != nullptr && !eventHandlers->listeners->empty()) return true;
+  }
+
+  return false;
+}
+
+EventTargetInstance *EventTargetInstance::parentEventTarget() {
+  return nullptr;
+}
+
 JSValueRef JSEventTarget::clearListeners(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
                                          size_t argumentCount, const JSValueRef *arguments, JSValueRef *exception) {
   auto eventTargetInstance = static_cast<EventTargetInstance *>(JSObjectGetPrivate(thisObject));
   assert_m(eventTargetInstance != nullptr, "this object is not a instance of eventTarget.");
 
-  for (auto &it : eventTargetInstance->_eventHandlers) {
-    for (auto &handler : it.second) {
+  auto EventTarget = JSEventTarget::instance(eventTargetInstance->context);
+  for (auto &handlers : eventTargetInstance->_eventHandlers) {
+    if (handlers.listeners == nullptr) continue;
+    for (auto &handler : *handlers.listeners) {
       JSValueUnprotect(eventTargetInstance->_hostClass->ctx, handler);
     }
+    EventTarget->updateEventListenerCount(handlers.eventTypeAtom, -static_cast<int32_t>(handlers.listeners->size()));
+    // Dispatches in progress keep their own copy.
+    handlers.listeners = nullptr;
   }
 
-  eventTargetInstance->_eventHandlers.clear();
   return nullptr;
 }
 
 JSValueRef EventTargetInstance::getProperty(std::string &name, JSValueRef *exception) {
   auto &propertyMap = JSEventTarget::getEventTargetPropertyMap();
-  auto &prototypePropertyMap = JSEventTarget::getEventTargetPrototypePropertyMap();
-
-  if (prototypePropertyMap.count(name) > 0) {
-    JSStringHolder nameStringHolder = JSStringHolder(context, name);
-    return JSObjectGetProperty(ctx, prototype<JSEventTarget>()->prototypeObject, nameStringHolder.getString(), exception);
-  }
 
+  // Methods are found by JSC on the prototype of instances.
   if (propertyMap.count(name) > 0) {
     auto &property = propertyMap[name];
 
@@ -348,31 +408,42 @@ bool EventTargetInstance::setProperty(std::string &name, JSValueRef value, JSVal
 
 JSValueRef EventTargetInstance::getPropertyHandler(std::string &name, JSValueRef *exception) {
   std::string eventType = name.substr(2);
+  auto eventHandlers = getEventHandlers(context->eventTypeAtoms()->find(eventType));
 
-  if (_propertyEventHandler.count(eventType) == 0) {
+  if (eventHandlers == nullptr || eventHandlers->propertyHandler == nullptr) {
     return JSValueMakeNull(ctx);
   }
-  return _propertyEventHandler[eventType];
+  return eventHandlers->propertyHandler;
 }
 
 void EventTargetInstance::setPropertyHandler(std::string &name, JSValueRef value,
                                                             JSValueRef *exception) {
   std::string eventType = name.substr(2);
+  bool isHandler = !JSValueIsNull(ctx, value) && !JSValueIsUndefined(ctx, value);
+  // Clearing a handler of a type nobody listened to has nothing to remove.
+  int32_t eventTypeAtom =
+    isHandler ? context->eventTypeAtoms()->intern(eventType) : context->eventTypeAtoms()->find(eventType);
+  if (eventTypeAtom == EventTypeAtoms::NOT_INTERNED) return;
+  auto &eventHandlers = ensureEventHandlers(eventTypeAtom);
+  auto EventTarget = JSEventTarget::instance(context);
 
   // We need to remove previous eventHandler when setting new eventHandler with same eventType.
-  if (_propertyEventHandler.count(eventType) > 0) {
-    JSValueUnprotect(ctx, _propertyEventHandler[eventType]);
-    _propertyEventHandler.erase(eventType);
+  if (eventHandlers.propertyHandler != nullptr) {
+    JSValueUnprotect(ctx, eventHandlers.propertyHandler);
+    eventHandlers.propertyHandler = nullptr;
+    EventTarget->updateEventListenerCount(eventTypeAtom, -1);
   }
 
   // When evaluate scripts like 'element.onclick = null', we needs to remove the event handlers callbacks
-  if (JSValueIsNull(ctx, value)) {
+  if (!isHandler) {
     return;
   }
 
   JSObjectRef handlerObjectRef = JSValueToObject(_hostClass->ctx, value, exception);
+  if (handlerObjectRef == nullptr) return;
   JSValueProtect(_hostClass->ctx, handlerObjectRef);
-  _propertyEventHandler[eventType] = handlerObjectRef;
+  eventHandlers.propertyHandler = handlerObjectRef;
+  EventTarget->updateEventListenerCount(eventTypeAtom, 1);
 
   auto Event = reinterpret_cast<JSEventTarget *>(_hostClass);
   auto isJsOnlyEvent = std::find(Event->m_jsOnlyEvents.begin(), Event->m_jsOnlyEvents.end(), name.substr(2)) !=
@@ -380,12 +451,11 @@ void EventTargetInstance::setPropertyHandler(std::string &name, JSValueRef value
 
   if (isJsOnlyEvent) return;
 
-  if (_eventHandlers.empty()) {
-    int32_t contextId = _hostClass->contextId;
+  if (!hasEventListeners()) {
     NativeString args_01{};
     buildUICommandArgs(eventType, args_01);
     int32_t type = JSObjectIsFunction(ctx, handlerObjectRef) ? UICommand::addEvent : UICommand::removeEvent;
-    foundation::UICommandBuffer::instance(contextId)->addCommand(eventTargetId, type, args_01, nullptr);
+    context->uiCommandBuffer()->addCommand(eventTargetId, type, args_01, nullptr);
   }
 }
 
@@ -399,14 +469,42 @@ void EventTargetInstance::getPropertyNames(JSPropertyNameAccumulatorRef accumula
   }
 }
 
+EventTargetInstance::EventHandlers *EventTargetInstance::getEventHandlers(int32_t eventTypeAtom) {
+  for (auto &handlers : _eventHandlers) {
+    if (handlers.eventTypeAtom == eventTypeAtom) return &handlers;
+  }
+  return nullptr;
+}
+
+EventTargetInstance::EventHandlers &EventTargetInstance::ensureEventHandlers(int32_t eventTypeAtom) {
+  auto handlers = getEventHandlers(eventTypeAtom);
+  if (handlers != nullptr) return *handlers;
+  return _eventHandlers.emplace_back(EventHandlers{eventTypeAtom, nullptr, nullptr});
+}
+
+std::vector<JSObjectRef> &EventTargetInstance::mutableListeners(EventHandlers &handlers) {
+  if (handlers.listeners == nullptr) {
+    handlers.listeners = std::make_shared<std::vector<JSObjectRef>>();
+  } else if (handlers.listeners.use_count() > 1) {
+    // Listeners are mutated by a listener during dispatch, leave the list being dispatched untouched.
+    handlers.listeners = std::make_shared<std::vector<JSObjectRef>>(*handlers.listeners);
+  }
+  return *handlers.listeners;
+}
+
+bool EventTargetInstance::hasEventListeners() {
+  for (auto &handlers : _eventHandlers) {
+    if (handlers.listeners != nullptr) return true;
+  }
+  return false;
+}
+
 bool EventTargetInstance::internalDispatchEvent(EventInstance *eventInstance) {
-  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t *>(eventInstance->nativeEvent->type->string),
-                                               eventInstance->nativeEvent->type->length);
-  std::string eventType = toUTF8(u16EventType);
-  auto stack = _eventHandlers[eventType];
+  auto eventHandlers = getEventHandlers(eventInstance->eventTypeAtom);
+  if (eventHandlers == nullptr) return eventInstance->_cancelled;
 
   // Dispatch event listeners writen by addEventListener
-  auto _dispatchEvent = [&eventInstance, this](JSObjectRef& handler) {
+  auto _dispatchEvent = [&eventInstance, this](JSObjectRef handler) {
     if (eventInstance->_propagationImmediatelyStopped) return;
 
     JSValueRef exception = nullptr;
@@ -416,13 +514,18 @@ bool EventTargetInstance::internalDispatchEvent(EventInstance *eventInstance) {
     context->handleException(exception);
   };
 
-  for (auto &handler : stack) {
-    _dispatchEvent(handler);
+  // Hold a reference instead of copying, listeners mutating the list will copy it instead.
+  std::shared_ptr<std::vector<JSObjectRef>> listeners = eventHandlers->listeners;
+  if (listeners != nullptr) {
+    for (auto &handler : *listeners) {
+      _dispatchEvent(handler);
+    }
   }
 
-  // Dispatch event listener white by 'on' prefix property.
-  if (_propertyEventHandler.count(eventType) > 0) {
-    _dispatchEvent(_propertyEventHandler[eventType]);
+  // Dispatch event listener white by 'on' prefix property. Listeners may add new types, look it up again.
+  eventHandlers = getEventHandlers(eventInstance->eventTypeAtom);
+  if (eventHandlers->propertyHandler != nullptr) {
+    _dispatchEvent(eventHandlers->propertyHandler);
   }
 
   // do not dispatch event when event has been canceled
@@ -436,6 +539,8 @@ void NativeEventTarget::dispatchEventImpl(NativeEventTarget *nativeEventTarget,
   assert_m(nativeEventTarget->instance != nullptr, "NativeEventTarget should have owner");
   EventTargetInstance *eventTargetInstance = nativeEventTarget->instance;
   JSContext *context = eventTargetInstance->context;
+  // Events such as scroll and resize come with layout changes, geometry read before is outdated.
+  context->uiCommandBuffer()->invalidateLayout();
   std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t *>(nativeEventType->string),
                                                nativeEventType->length);
   std::string eventType = toUTF8(u16EventType);
@@ -444,4 +549,11 @@ void NativeEventTarget::dispatchEventImpl(NativeEventTarget *nativeEventTarget,
   eventTargetInstance->dispatchEvent(eventInstance);
 }
 
+int32_t NativeEventTarget::hasEventListenerImpl(NativeEventTarget *nativeEventTarget, NativeString *nativeEventType) {
+  assert_m(nativeEventTarget->instance != nullptr, "NativeEventTarget should have owner");
+  int32_t eventTypeAtom =
+    nativeEventTarget->instance->context->eventTypeAtoms()->find(nativeEventType->string, nativeEventType->length);
+  return nativeEventTarget->instance->hasEventListener(eventTypeAtom) ? 1 : 0;
+}
+
 } // namespace kraken::binding::jsc
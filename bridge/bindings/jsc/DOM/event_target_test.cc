@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "bindings/jsc/DOM/event.h"
+#include "bindings/jsc/DOM/event_target.h"
+#include "bindings/jsc/js_context_internal.h"
+#include "dart_methods.h"
+#include <thread>
+
+using namespace kraken::binding::jsc;
+
+namespace {
+
+// Listener counts of a context are kept by JSEventTarget, every event target of the context updates them.
+class EventListenerCountTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Event targets record UI commands, which request a batch update from dart. Debug builds only hand out dart
+    // methods on the UI thread.
+    setUIThreadId(std::this_thread::get_id());
+    kraken::getDartMethod()->requestBatchUpdate = [](int32_t contextId) {};
+    m_context = createJSContext(0, [](int32_t contextId, const char *errmsg) { ADD_FAILURE() << errmsg; }, nullptr);
+    m_eventTarget = JSEventTarget::instance(m_context.get());
+    m_clickAtom = m_context->eventTypeAtoms()->intern("click");
+  }
+
+  void TearDown() override {
+    m_context.reset();
+  }
+
+  EventTargetInstance *createTarget(const char *name) {
+    auto instance = new EventTargetInstance(m_eventTarget);
+    JSStringRef nameRef = JSStringCreateWithUTF8CString(name);
+    JSObjectSetProperty(m_context->context(), m_context->global(), nameRef, instance->object,
+                        kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(nameRef);
+    return instance;
+  }
+
+  // Mirrors the finalizer of a garbage collected event target.
+  void disposeTarget(EventTargetInstance *instance) {
+    JSObjectSetPrivate(instance->object, nullptr);
+    delete instance;
+  }
+
+  void evaluate(const char *code) {
+    JSStringRef codeRef = JSStringCreateWithUTF8CString(code);
+    JSValueRef exception = nullptr;
+    JSEvaluateScript(m_context->context(), codeRef, nullptr, nullptr, 0, &exception);
+    JSStringRelease(codeRef);
+    EXPECT_EQ(exception, nullptr) << code;
+  }
+
+  int32_t clickListeners() {
+    return m_eventTarget->eventListenerCount(m_clickAtom);
+  }
+
+  std::unique_ptr<JSContext> m_context;
+  JSEventTarget *m_eventTarget{nullptr};
+  int32_t m_clickAtom{-1};
+};
+
+} // namespace
+
+TEST_F(EventListenerCountTest, countAddedAndRemovedListeners) {
+  createTarget("target");
+  EXPECT_FALSE(m_eventTarget->hasEventListeners(m_clickAtom));
+
+  evaluate("function a() {} function b() {} target.addEventListener('click', a); "
+           "target.addEventListener('click', b);");
+  EXPECT_EQ(clickListeners(), 2);
+  EXPECT_TRUE(m_eventTarget->hasEventListeners(m_clickAtom));
+
+  // Removing an unknown listener or another type does not change the count.
+  evaluate("target.removeEventListener('click', function() {}); target.removeEventListener('touchstart', a);");
+  EXPECT_EQ(clickListeners(), 2);
+
+  evaluate("target.removeEventListener('click', a);");
+  EXPECT_EQ(clickListeners(), 1);
+  evaluate("target.removeEventListener('click', b);");
+  EXPECT_EQ(clickListeners(), 0);
+  EXPECT_FALSE(m_eventTarget->hasEventListeners(m_clickAtom));
+}
+
+TEST_F(EventListenerCountTest, countPropertyHandlers) {
+  createTarget("target");
+
+  evaluate("target.onclick = function() {};");
+  EXPECT_EQ(clickListeners(), 1);
+  // Replacing a handler keeps a single one.
+  evaluate("target.onclick = function() {};");
+  EXPECT_EQ(clickListeners(), 1);
+
+  evaluate("target.onclick = null;");
+  EXPECT_EQ(clickListeners(), 0);
+  evaluate("target.onclick = undefined;");
+  EXPECT_EQ(clickListeners(), 0);
+
+  evaluate("target.onclick = function() {}; target.addEventListener('click', function() {});");
+  EXPECT_EQ(clickListeners(), 2);
+  evaluate("target.__kraken_clear_event_listeners__();");
+  EXPECT_EQ(clickListeners(), 0);
+}
+
+TEST_F(EventListenerCountTest, releaseCountsOfDisposedTargets) {
+  auto first = createTarget("first");
+  createTarget("second");
+
+  evaluate("first.addEventListener('click', function() {}); first.onclick = function() {}; "
+           "second.addEventListener('click', function() {});");
+  EXPECT_EQ(clickListeners(), 3);
+
+  disposeTarget(first);
+  EXPECT_EQ(clickListeners(), 1);
+  EXPECT_TRUE(m_eventTarget->hasEventListeners(m_clickAtom));
+}
+
+TEST_F(EventListenerCountTest, internOnlyTypesWithListeners) {
+  createTarget("target");
+  EventTypeAtoms *atoms = m_context->eventTypeAtoms();
+
+  // Reading handlers, clearing them and removing listeners never intern a type.
+  evaluate("target.onfoo; target.onbar = null; target.removeEventListener('baz', function() {});");
+  EXPECT_EQ(atoms->find("foo"), EventTypeAtoms::NOT_INTERNED);
+  EXPECT_EQ(atoms->find("bar"), EventTypeAtoms::NOT_INTERNED);
+  EXPECT_EQ(atoms->find("baz"), EventTypeAtoms::NOT_INTERNED);
+
+  evaluate("target.onfoo = function() {};");
+  EXPECT_NE(atoms->find("foo"), EventTypeAtoms::NOT_INTERNED);
+}
+
+TEST_F(EventListenerCountTest, dispatchEventsCreatedBeforeTheirListeners) {
+  createTarget("target");
+  JSValueRef exception = nullptr;
+  auto event = new EventInstance(JSEvent::instance(m_context.get()), "custom", nullptr, &exception);
+  EXPECT_EQ(event->eventTypeAtom, EventTypeAtoms::NOT_INTERNED);
+  JSStringRef nameRef = JSStringCreateWithUTF8CString("event");
+  JSObjectSetProperty(m_context->context(), m_context->global(), nameRef, event->object, kJSPropertyAttributeNone,
+                      nullptr);
+  JSStringRelease(nameRef);
+
+  evaluate("var received = 0; target.addEventListener('custom', function() { received++; }); "
+           "target.dispatchEvent(event); if (received !== 1) throw new Error('listener was not called');");
+}
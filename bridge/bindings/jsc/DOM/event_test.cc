@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "bindings/jsc/DOM/event.h"
+#include "bindings/jsc/js_context_internal.h"
+
+using namespace kraken::binding::jsc;
+
+namespace {
+
+class EventPayloadPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    m_context = createJSContext(0, [](int32_t contextId, const char *errmsg) { ADD_FAILURE() << errmsg; }, nullptr);
+    m_pool = m_context->eventPayloadPool();
+  }
+
+  void TearDown() override {
+    m_context.reset();
+  }
+
+  EventInstance *createEvent(const char *type) {
+    JSValueRef exception = nullptr;
+    auto event = new EventInstance(JSEvent::instance(m_context.get()), type, nullptr, &exception);
+    EXPECT_EQ(exception, nullptr);
+    return event;
+  }
+
+  // Mirrors the finalizer of a garbage collected event.
+  void disposeEvent(EventInstance *event) {
+    JSObjectSetPrivate(event->object, nullptr);
+    delete event;
+  }
+
+  std::unique_ptr<JSContext> m_context;
+  EventPayloadPool *m_pool{nullptr};
+};
+
+} // namespace
+
+TEST_F(EventPayloadPoolTest, reusePayloadsOfFinalizedEvents) {
+  auto first = createEvent("click");
+  NativeEvent *payload = first->nativeEvent;
+  NativeString *type = payload->type;
+  payload->defaultPrevented = 1;
+  EXPECT_EQ(m_pool->stats().misses, 1);
+
+  disposeEvent(first);
+  EXPECT_EQ(m_pool->stats().recycled, 1);
+
+  // The payload and its type string come back with the other fields reset.
+  auto second = createEvent("click");
+  EXPECT_EQ(second->nativeEvent, payload);
+  EXPECT_EQ(second->nativeEvent->type, type);
+  EXPECT_EQ(second->nativeEvent->defaultPrevented, 0);
+  EXPECT_NE(second->nativeEvent->timeStamp, 0);
+  EXPECT_EQ(m_pool->stats().hits, 1);
+
+  // Payloads of other types are not shared.
+  auto third = createEvent("scroll");
+  EXPECT_NE(third->nativeEvent, payload);
+  EXPECT_EQ(m_pool->stats().misses, 2);
+
+  disposeEvent(second);
+  disposeEvent(third);
+}
+
+TEST_F(EventPayloadPoolTest, dropPayloadsOnceThePoolIsFull) {
+  std::vector<EventInstance *> events;
+  for (size_t i = 0; i <= EventPayloadPool::MAX_POOLED_EVENTS; i++) {
+    events.push_back(createEvent("click"));
+  }
+  for (auto event : events) {
+    disposeEvent(event);
+  }
+
+  EXPECT_EQ(m_pool->stats().recycled, EventPayloadPool::MAX_POOLED_EVENTS);
+  EXPECT_EQ(m_pool->stats().dropped, 1);
+}
+
+TEST_F(EventPayloadPoolTest, freePayloadsAllocatedByDart) {
+  std::string click = "click";
+  auto nativeEvent = new NativeEvent(stringToNativeString(click));
+  disposeEvent(new EventInstance(JSEvent::instance(m_context.get()), nativeEvent));
+
+  EXPECT_EQ(m_pool->stats().recycled, 0);
+  EXPECT_EQ(m_pool->stats().dropped, 0);
+}
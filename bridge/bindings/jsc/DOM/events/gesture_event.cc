@@ -175,7 +175,7 @@ JSValueRef JSGestureEvent::initGestureEvent(JSContextRef ctx, JSObjectRef functi
   auto eventInstance = static_cast<GestureEventInstance *>(JSObjectGetPrivate(thisObject));
 
   JSStringRef typeStringRef = JSValueToStringCopy(ctx, arguments[0], exception);
-  eventInstance->nativeEvent->type = stringRefToNativeString(typeStringRef);
+  eventInstance->setType(stringRefToNativeString(typeStringRef));
 
   if (argumentCount <= 2) {
     bool canBubble = JSValueToBoolean(ctx, arguments[1]);
@@ -49,7 +49,7 @@ InputEventInstance::InputEventInstance(JSInputEvent *jsInputEvent, NativeInputEv
 InputEventInstance::InputEventInstance(JSInputEvent *jsInputEvent, JSStringRef data, JSValueRef inputEventInitRef,
                                        JSValueRef *exception)
   : EventInstance(jsInputEvent, "input", inputEventInitRef, exception) {
-  nativeInputEvent = new NativeInputEvent(nativeEvent);
+  nativeInputEvent = context->eventPayloadPool()->acquireInputEvent(nativeEvent);
 
   if (inputEventInitRef != nullptr) {
     JSObjectRef inputInit = JSValueToObject(ctx, inputEventInitRef, exception);
@@ -106,7 +106,11 @@ bool InputEventInstance::setProperty(std::string &name, JSValueRef value, JSValu
 InputEventInstance::~InputEventInstance() {
   nativeInputEvent->data->free();
   nativeInputEvent->inputType->free();
-  delete nativeInputEvent;
+  if (pooledPayload && context->isValid()) {
+    context->eventPayloadPool()->releaseInputEvent(nativeInputEvent);
+  } else {
+    delete nativeInputEvent;
+  }
 }
 
 void InputEventInstance::getPropertyNames(JSPropertyNameAccumulatorRef accumulator) {
@@ -132,7 +132,7 @@ JSValueRef JSMouseEvent::initMouseEvent(JSContextRef ctx, JSObjectRef function,
   auto eventInstance = static_cast<MouseEventInstance *>(JSObjectGetPrivate(thisObject));
 
   JSStringRef typeStringRef = JSValueToStringCopy(ctx, arguments[0], exception);
-  eventInstance->nativeEvent->type = stringRefToNativeString(typeStringRef);
+  eventInstance->setType(stringRefToNativeString(typeStringRef));
 
   if (argumentCount <= 2) {
     bool canBubble = JSValueToBoolean(ctx, arguments[1]);
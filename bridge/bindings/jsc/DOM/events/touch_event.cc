@@ -37,15 +37,35 @@ JSValueRef JSTouchEvent::getProperty(std::string &name, JSValueRef *exception) {
 }
 
 TouchEventInstance::TouchEventInstance(JSTouchEvent *jsTouchEvent, NativeTouchEvent *nativeTouchEvent)
-  : EventInstance(jsTouchEvent, nativeTouchEvent->nativeEvent), nativeTouchEvent(nativeTouchEvent) {
-  m_touches = new JSTouchList(jsTouchEvent->context, nativeTouchEvent->touches, nativeTouchEvent->touchLength);
-  m_targetTouches = new JSTouchList(jsTouchEvent->context, nativeTouchEvent->targetTouches, nativeTouchEvent->targetTouchesLength);
-  m_changedTouches = new JSTouchList(jsTouchEvent->context, nativeTouchEvent->changedTouches, nativeTouchEvent->changedTouchesLength);
-}
+  : EventInstance(jsTouchEvent, nativeTouchEvent->nativeEvent), nativeTouchEvent(nativeTouchEvent),
+    m_jsTouchEvent(jsTouchEvent) {}
 
 TouchEventInstance::TouchEventInstance(JSTouchEvent *jsTouchEvent, JSStringRef data)
-  : EventInstance(jsTouchEvent, "touch", nullptr, nullptr) {
-  nativeTouchEvent = new NativeTouchEvent(nativeEvent);
+  : EventInstance(jsTouchEvent, "touch", nullptr, nullptr), m_jsTouchEvent(jsTouchEvent) {
+  nativeTouchEvent = context->eventPayloadPool()->acquireTouchEvent(nativeEvent);
+}
+
+JSObjectRef TouchEventInstance::ensureTouchList(JSTouchList *&touchList, NativeTouch **touches, int64_t length) {
+  if (touchList == nullptr) {
+    touchList = new JSTouchList(context, touches, length);
+    // Keep the list alive as long as this event, so the same object is returned on every read.
+    JSValueProtect(ctx, touchList->jsObject);
+    m_jsTouchEvent->touchListCreatedCount++;
+  }
+  return touchList->jsObject;
+}
+
+void TouchEventInstance::releaseTouchList(JSTouchList *touchList, NativeTouch **touches, int64_t length) {
+  if (touchList != nullptr) {
+    if (context->isValid()) JSValueUnprotect(ctx, touchList->jsObject);
+    return;
+  }
+
+  // JSTouch owns its native touch, so touches of a list which was never created are released here.
+  for (int64_t i = 0; i < length; i++) {
+    delete touches[i];
+  }
+  if (context->isValid()) m_jsTouchEvent->touchListDeferredCount++;
 }
 
 JSValueRef TouchEventInstance::getProperty(std::string &name, JSValueRef *exception) {
@@ -57,11 +77,12 @@ JSValueRef TouchEventInstance::getProperty(std::string &name, JSValueRef *except
 
   switch (property) {
   case JSTouchEvent::TouchEventProperty::touches:
-    return m_touches->jsObject;
+    return ensureTouchList(m_touches, nativeTouchEvent->touches, nativeTouchEvent->touchLength);
   case JSTouchEvent::TouchEventProperty::targetTouches:
-    return m_targetTouches->jsObject;
+    return ensureTouchList(m_targetTouches, nativeTouchEvent->targetTouches, nativeTouchEvent->targetTouchesLength);
   case JSTouchEvent::TouchEventProperty::changedTouches:
-    return m_changedTouches->jsObject;
+    return ensureTouchList(m_changedTouches, nativeTouchEvent->changedTouches,
+                           nativeTouchEvent->changedTouchesLength);
   case JSTouchEvent::TouchEventProperty::altKey:
     return JSValueMakeBoolean(ctx, nativeTouchEvent->altKey == 1);
   case JSTouchEvent::TouchEventProperty::metaKey:
@@ -85,7 +106,14 @@ bool TouchEventInstance::setProperty(std::string &name, JSValueRef value, JSValu
 }
 
 TouchEventInstance::~TouchEventInstance() {
-  delete nativeTouchEvent;
+  releaseTouchList(m_touches, nativeTouchEvent->touches, nativeTouchEvent->touchLength);
+  releaseTouchList(m_targetTouches, nativeTouchEvent->targetTouches, nativeTouchEvent->targetTouchesLength);
+  releaseTouchList(m_changedTouches, nativeTouchEvent->changedTouches, nativeTouchEvent->changedTouchesLength);
+  if (pooledPayload && context->isValid()) {
+    context->eventPayloadPool()->releaseTouchEvent(nativeTouchEvent);
+  } else {
+    delete nativeTouchEvent;
+  }
 }
 
 void TouchEventInstance::getPropertyNames(JSPropertyNameAccumulatorRef accumulator) {
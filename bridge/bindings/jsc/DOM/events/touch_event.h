@@ -35,6 +35,10 @@ public:
 
   JSValueRef getProperty(std::string &name, JSValueRef *exception) override;
 
+  // TouchList objects created because script read them, and lists never materialized before the event was released.
+  int64_t touchListCreatedCount{0};
+  int64_t touchListDeferredCount{0};
+
 protected:
   JSTouchEvent() = delete;
   ~JSTouchEvent();
@@ -54,9 +58,14 @@ public:
   NativeTouchEvent *nativeTouchEvent;
 
 private:
-  JSTouchList *m_touches;
-  JSTouchList *m_targetTouches;
-  JSTouchList *m_changedTouches;
+  JSObjectRef ensureTouchList(JSTouchList *&touchList, NativeTouch **touches, int64_t length);
+  void releaseTouchList(JSTouchList *touchList, NativeTouch **touches, int64_t length);
+
+  JSTouchEvent *m_jsTouchEvent;
+  // Touch lists are created the first time script reads them, most touch listeners only look at one of them.
+  JSTouchList *m_touches{nullptr};
+  JSTouchList *m_targetTouches{nullptr};
+  JSTouchList *m_changedTouches{nullptr};
 };
 
 class JSTouchList : public HostObject {
@@ -112,19 +121,19 @@ struct NativeTouchEvent {
 
   NativeEvent *nativeEvent;
 
-  NativeTouch **touches;
-  int64_t touchLength;
+  NativeTouch **touches{nullptr};
+  int64_t touchLength{0};
 
-  NativeTouch **targetTouches;
-  int64_t targetTouchesLength;
+  NativeTouch **targetTouches{nullptr};
+  int64_t targetTouchesLength{0};
 
-  NativeTouch **changedTouches;
-  int64_t changedTouchesLength;
+  NativeTouch **changedTouches{nullptr};
+  int64_t changedTouchesLength{0};
 
-  int64_t altKey;
-  int64_t metaKey;
-  int64_t ctrlKey;
-  int64_t shiftKey;
+  int64_t altKey{0};
+  int64_t metaKey{0};
+  int64_t ctrlKey{0};
+  int64_t shiftKey{0};
 };
 
 } // namespace kraken::binding::jsc
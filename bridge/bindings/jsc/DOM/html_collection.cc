@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "html_collection.h"
+
+namespace kraken::binding::jsc {
+
+void JSHTMLCollection::ensureElements() {
+  if (m_elementIndexVersion == m_document->elementIndexVersion()) return;
+  m_elements.clear();
+  m_document->collectElementsByTagName(m_tagName, m_elements);
+  m_elementIndexVersion = m_document->elementIndexVersion();
+}
+
+size_t JSHTMLCollection::internalLength() {
+  // Length comes from the index directly, no need to walk the tree for it.
+  if (m_elementIndexVersion == m_document->elementIndexVersion()) return m_elements.size();
+  return m_document->countElementsByTagName(m_tagName);
+}
+
+ElementInstance *JSHTMLCollection::internalItem(size_t index) {
+  ensureElements();
+  if (index >= m_elements.size()) return nullptr;
+  return m_elements[index];
+}
+
+JSValueRef JSHTMLCollection::getProperty(std::string &name, JSValueRef *exception) {
+  auto &propertyMap = getHTMLCollectionPropertyMap();
+
+  if (propertyMap.count(name) > 0) {
+    auto &property = propertyMap[name];
+
+    switch (property) {
+    case HTMLCollectionProperty::item:
+      return nullptr;
+    case HTMLCollectionProperty::length:
+      return JSValueMakeNumber(ctx, internalLength());
+    }
+  }
+
+  if (isNumberIndex(name)) {
+    ElementInstance *element = internalItem(std::stoul(name));
+    return element != nullptr ? element->object : nullptr;
+  }
+
+  return HostObject::getProperty(name, exception);
+}
+
+JSValueRef JSHTMLCollection::item(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                                  const JSValueRef *arguments, JSValueRef *exception) {
+  if (argumentCount < 1) {
+    throwJSError(ctx, "Failed to execute 'item' on 'HTMLCollection': 1 argument required, but only 0 present.",
+                 exception);
+    return nullptr;
+  }
+
+  double index = JSValueToNumber(ctx, arguments[0], exception);
+  auto collection = reinterpret_cast<JSHTMLCollection *>(JSObjectGetPrivate(function));
+  if (index < 0) return JSValueMakeNull(ctx);
+
+  ElementInstance *element = collection->internalItem(index);
+  return element != nullptr ? element->object : JSValueMakeNull(ctx);
+}
+
+void JSHTMLCollection::getPropertyNames(JSPropertyNameAccumulatorRef accumulator) {
+  for (auto &property : getHTMLCollectionPropertyNames()) {
+    JSPropertyNameAccumulatorAddName(accumulator, property);
+  }
+
+  size_t length = internalLength();
+  for (size_t i = 0; i < length; i++) {
+    JSStringHolder indexStringHolder = JSStringHolder(context, std::to_string(i));
+    JSPropertyNameAccumulatorAddName(accumulator, indexStringHolder.getString());
+  }
+}
+
+} // namespace kraken::binding::jsc
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_HTML_COLLECTION_H
+#define KRAKENBRIDGE_HTML_COLLECTION_H
+
+#include "bindings/jsc/DOM/element.h"
+#include "bindings/jsc/host_object_internal.h"
+#include "bindings/jsc/js_context_internal.h"
+#include <vector>
+
+namespace kraken::binding::jsc {
+
+// Live view of connected elements with the same tag name, elements are only collected again after the document
+// indexes changed.
+class JSHTMLCollection : public HostObject {
+public:
+  JSHTMLCollection() = delete;
+  explicit JSHTMLCollection(JSContext *context, DocumentInstance *document, std::string tagName)
+    : HostObject(context, "HTMLCollection"), m_document(document), m_tagName(std::move(tagName)){};
+  DEFINE_OBJECT_PROPERTY(HTMLCollection, 2, length, item)
+
+  static JSValueRef item(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                         const JSValueRef arguments[], JSValueRef *exception);
+
+  JSValueRef getProperty(std::string &name, JSValueRef *exception) override;
+  void getPropertyNames(JSPropertyNameAccumulatorRef accumulator) override;
+
+  size_t internalLength();
+  ElementInstance *internalItem(size_t index);
+
+private:
+  void ensureElements();
+
+  DocumentInstance *m_document;
+  std::string m_tagName;
+  std::vector<ElementInstance *> m_elements;
+  uint64_t m_elementIndexVersion{0};
+  JSFunctionHolder m_item{context, jsObject, this, "item", item};
+};
+
+} // namespace kraken::binding::jsc
+
+#endif // KRAKENBRIDGE_HTML_COLLECTION_H
@@ -13,8 +13,25 @@ void bindNode(std::unique_ptr<JSContext> &context) {
   JSC_GLOBAL_SET_PROPERTY(context, "Node", node->classObject);
 }
 
-JSNode::JSNode(JSContext *context) : JSEventTarget(context, "Node") {}
-JSNode::JSNode(JSContext *context, const char *name) : JSEventTarget(context, name) {}
+const JSStaticFunction JSNode::prototypeStaticFunctions[] = {
+  {"cloneNode", cloneNode, kJSPropertyAttributeNone},
+  {"removeChild", removeChild, kJSPropertyAttributeNone},
+  {"appendChild", appendChild, kJSPropertyAttributeNone},
+  {"remove", remove, kJSPropertyAttributeNone},
+  {"insertBefore", insertBefore, kJSPropertyAttributeNone},
+  {"replaceChild", replaceChild, kJSPropertyAttributeNone},
+  {nullptr, nullptr, 0}};
+
+JSClassRef JSNode::prototypeClass() {
+  return getPrototypeClassRef("Node", JSEventTarget::prototypeClass(), prototypeStaticFunctions);
+}
+
+JSNode::JSNode(JSContext *context) : JSEventTarget(context, "Node") {
+  setPrototypeClass(prototypeClass());
+}
+JSNode::JSNode(JSContext *context, const char *name) : JSEventTarget(context, name) {
+  setPrototypeClass(prototypeClass());
+}
 
 std::unordered_map<JSContext *, JSNode *> JSNode::instanceMap{};
 
@@ -29,6 +46,98 @@ JSNode::~JSNode() {
   instanceMap.erase(context);
 }
 
+ChildNodeList::iterator &ChildNodeList::iterator::operator++() {
+  m_node = m_node->m_nextSibling;
+  return *this;
+}
+
+NodeInstance *ChildNodeList::operator[](size_t index) {
+  if (!m_indexCacheValid) {
+    m_indexCache.clear();
+    m_indexCache.reserve(m_size);
+    for (auto node = m_first; node != nullptr; node = node->m_nextSibling) {
+      m_indexCache.emplace_back(node);
+    }
+    m_indexCacheValid = true;
+  }
+  return m_indexCache[index];
+}
+
+void ChildNodeList::append(NodeInstance *node) {
+  node->m_previousSibling = m_last;
+  node->m_nextSibling = nullptr;
+  if (m_last != nullptr) {
+    m_last->m_nextSibling = node;
+  } else {
+    m_first = node;
+  }
+  m_last = node;
+  m_size++;
+  releaseArray();
+  // Appending keeps existing indexes, extend the cache instead of dropping it.
+  if (m_indexCacheValid) m_indexCache.emplace_back(node);
+}
+
+void ChildNodeList::insertBefore(NodeInstance *node, NodeInstance *referenceNode) {
+  node->m_previousSibling = referenceNode->m_previousSibling;
+  node->m_nextSibling = referenceNode;
+  if (referenceNode->m_previousSibling != nullptr) {
+    referenceNode->m_previousSibling->m_nextSibling = node;
+  } else {
+    m_first = node;
+  }
+  referenceNode->m_previousSibling = node;
+  m_size++;
+  releaseArray();
+  m_indexCacheValid = false;
+}
+
+void ChildNodeList::remove(NodeInstance *node) {
+  if (node->m_previousSibling != nullptr) {
+    node->m_previousSibling->m_nextSibling = node->m_nextSibling;
+  } else {
+    m_first = node->m_nextSibling;
+  }
+  if (node->m_nextSibling != nullptr) {
+    node->m_nextSibling->m_previousSibling = node->m_previousSibling;
+  } else {
+    m_last = node->m_previousSibling;
+  }
+  node->m_previousSibling = nullptr;
+  node->m_nextSibling = nullptr;
+  m_size--;
+  m_indexCacheValid = false;
+  releaseArray();
+}
+
+JSObjectRef ChildNodeList::array(JSContextRef ctx) {
+  if (m_array != nullptr) return m_array;
+
+  std::vector<JSValueRef> nodes;
+  nodes.reserve(m_size);
+  for (auto node = m_first; node != nullptr; node = node->m_nextSibling) {
+    nodes.emplace_back(node->object);
+  }
+  // Protected until the list changes, so a stale array never keeps removed children alive.
+  m_array = JSObjectMakeArray(ctx, nodes.size(), nodes.data(), nullptr);
+  // The same array is returned by later reads, it is frozen like a NodeList so script can not reorder it.
+  JSObjectRef objectConstructor =
+    JSValueToObject(ctx, getObjectPropertyValue(ctx, "Object", JSContextGetGlobalObject(ctx), nullptr), nullptr);
+  JSObjectRef freeze = JSValueToObject(ctx, getObjectPropertyValue(ctx, "freeze", objectConstructor, nullptr), nullptr);
+  JSValueRef arguments[] = {m_array};
+  JSObjectCallAsFunction(ctx, freeze, objectConstructor, 1, arguments, nullptr);
+  m_arrayContext = ctx;
+  JSValueProtect(ctx, m_array);
+  return m_array;
+}
+
+void ChildNodeList::releaseArray() {
+  if (m_array == nullptr) return;
+  JSValueUnprotect(m_arrayContext, m_array);
+  m_array = nullptr;
+  m_arrayContext = nullptr;
+}
+
 NodeInstance::~NodeInstance() {
   // The this node is finalized, should tell all children this parent will no longer protecting them.
   if (context->isValid()) {
@@ -38,6 +147,7 @@ NodeInstance::~NodeInstance() {
       assert(node->_referenceCount <= 0 &&
              ("Node recycled with a dangling node " + std::to_string(node->eventTargetId)).c_str());
     }
+    childNodes.releaseArray();
   }
 
   foundation::UICommandCallbackQueue::instance()->registerCallback(
@@ -79,58 +189,33 @@ DocumentInstance *NodeInstance::ownerDocument() {
 }
 
 NodeInstance *NodeInstance::firstChild() {
-  if (childNodes.empty()) {
-    return nullptr;
-  }
   return childNodes.front();
 }
 
 NodeInstance *NodeInstance::lastChild() {
-  if (childNodes.empty()) {
-    return nullptr;
-  }
   return childNodes.back();
 }
 
+EventTargetInstance *NodeInstance::parentEventTarget() {
+  return parentNode;
+}
+
 NodeInstance *NodeInstance::previousSibling() {
   if (parentNode == nullptr) return nullptr;
-
-  auto &&parentChildNodes = parentNode->childNodes;
-  auto it = std::find(parentChildNodes.begin(), parentChildNodes.end(), this);
-
-  if (parentChildNodes.size() < 2) {
-    return nullptr;
-  }
-
-  if (it != parentChildNodes.begin()) {
-    return *(it - 1);
-  }
-
-  return nullptr;
+  return m_previousSibling;
 }
 
 NodeInstance *NodeInstance::nextSibling() {
   if (parentNode == nullptr) return nullptr;
-
-  auto &&parentChildNodes = parentNode->childNodes;
-  auto it = std::find(parentChildNodes.begin(), parentChildNodes.end(), this);
-
-  if ((it + 1) != parentChildNodes.end()) {
-    return *(it + 1);
-  }
-
-  return nullptr;
+  return m_nextSibling;
 }
 
 void NodeInstance::ensureDetached(NodeInstance *node) {
   if (node->parentNode != nullptr) {
-    auto it = std::find(node->parentNode->childNodes.begin(), node->parentNode->childNodes.end(), node);
-    if (it != node->parentNode->childNodes.end()) {
-      node->_notifyNodeRemoved(node->parentNode);
-      node->parentNode->childNodes.erase(it);
-      node->parentNode = nullptr;
-      node->unrefer();
-    }
+    node->_notifyNodeRemoved(node->parentNode);
+    node->parentNode->childNodes.remove(node);
+    node->parentNode = nullptr;
+    node->unrefer();
   }
 }
 
@@ -169,7 +254,7 @@ JSValueRef JSNode::copyNodeValue(JSContextRef ctx, NodeInstance *node) {
     NativeString args_01{};
     buildUICommandArgs(newNodeEventTargetId, args_01);
 
-    foundation::UICommandBuffer::instance(newElement->contextId)
+    newElement->context->uiCommandBuffer()
       ->addCommand(element->eventTargetId, UICommand::cloneNode, args_01, nullptr);
 
     return newElement->object;
@@ -380,17 +465,7 @@ void NodeInstance::internalInsertBefore(NodeInstance *node, NodeInstance *refere
     ensureDetached(node);
     auto parent = referenceNode->parentNode;
     if (parent != nullptr) {
-      auto &&parentChildNodes = parent->childNodes;
-      auto it = std::find(parentChildNodes.begin(), parentChildNodes.end(), referenceNode);
-
-      if (it == parentChildNodes.end()) {
-        throwJSError(_hostClass->ctx,
-                     "Failed to execute 'insertBefore' on 'Node': reference node is not a child of this node.",
-                     exception);
-        return;
-      }
-
-      parentChildNodes.insert(it, node);
+      parent->childNodes.insertBefore(node, referenceNode);
       node->parentNode = parent;
       node->refer();
       node->_notifyNodeInsert(parent);
@@ -402,7 +477,7 @@ void NodeInstance::internalInsertBefore(NodeInstance *node, NodeInstance *refere
       NativeString args_02{};
       buildUICommandArgs(nodeEventTargetId, position, args_01, args_02);
 
-      foundation::UICommandBuffer::instance(_hostClass->contextId)
+      _hostClass->context->uiCommandBuffer()
         ->addCommand(referenceNode->eventTargetId, UICommand::insertAdjacentNode, args_01, args_02, nullptr);
     }
   }
@@ -453,7 +528,7 @@ JSValueRef JSNode::removeChild(JSContextRef ctx, JSObjectRef function, JSObjectR
 
 void NodeInstance::internalAppendChild(NodeInstance *node) {
   ensureDetached(node);
-  childNodes.emplace_back(node);
+  childNodes.append(node);
   node->parentNode = this;
   node->refer();
 
@@ -467,7 +542,7 @@ void NodeInstance::internalAppendChild(NodeInstance *node) {
 
   buildUICommandArgs(nodeEventTargetId, position, args_01, args_02);
 
-  foundation::UICommandBuffer::instance(node->_hostClass->contextId)
+  node->_hostClass->context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::insertAdjacentNode, args_01, args_02, nullptr);
 }
 
@@ -477,14 +552,12 @@ void NodeInstance::internalRemove(JSValueRef *exception) {
 }
 
 NodeInstance *NodeInstance::internalRemoveChild(NodeInstance *node, JSValueRef *exception) {
-  auto it = std::find(childNodes.begin(), childNodes.end(), node);
-
-  if (it != childNodes.end()) {
-    childNodes.erase(it);
+  if (node->parentNode == this) {
+    childNodes.remove(node);
     node->parentNode = nullptr;
     node->unrefer();
     node->_notifyNodeRemoved(this);
-    foundation::UICommandBuffer::instance(node->_hostClass->contextId)
+    node->_hostClass->context->uiCommandBuffer()
       ->addCommand(node->eventTargetId, UICommand::removeNode, nullptr);
   }
 
@@ -493,20 +566,23 @@ NodeInstance *NodeInstance::internalRemoveChild(NodeInstance *node, JSValueRef *
 
 NodeInstance *NodeInstance::internalReplaceChild(NodeInstance *newChild, NodeInstance *oldChild,
                                                  JSValueRef *exception) {
+  if (oldChild->parentNode != this) {
+    throwJSError(ctx, "Failed to execute 'replaceChild' on 'Node': old child is not exist on childNodes.", exception);
+    return nullptr;
+  }
+
+  if (newChild == oldChild) return oldChild;
+
   ensureDetached(newChild);
   assert_m(newChild->parentNode == nullptr, "ReplaceChild Error: newChild was not detached.");
+
+  // oldChild stays in the list as the anchor, newChild may have been detached from this node just now.
+  childNodes.insertBefore(newChild, oldChild);
+  childNodes.remove(oldChild);
   oldChild->parentNode = nullptr;
   oldChild->unrefer();
 
-  auto childIndex = std::find(childNodes.begin(), childNodes.end(), oldChild);
-  if (childIndex == childNodes.end()) {
-    throwJSError(ctx, "Failed to execute 'replaceChild' on 'Node': old child is not exist on childNodes.", exception);
-    return nullptr;
-  }
-
   newChild->parentNode = this;
-  childNodes.erase(childIndex);
-  childNodes.insert(childIndex, newChild);
   newChild->refer();
 
   oldChild->_notifyNodeRemoved(this);
@@ -520,10 +596,10 @@ NodeInstance *NodeInstance::internalReplaceChild(NodeInstance *newChild, NodeIns
 
   buildUICommandArgs(newChildEventTargetId, position, args_01, args_02);
 
-  foundation::UICommandBuffer::instance(_hostClass->contextId)
+  _hostClass->context->uiCommandBuffer()
     ->addCommand(oldChild->eventTargetId, UICommand::insertAdjacentNode, args_01, args_02, nullptr);
 
-  foundation::UICommandBuffer::instance(_hostClass->contextId)
+  _hostClass->context->uiCommandBuffer()
     ->addCommand(oldChild->eventTargetId, UICommand::removeNode, nullptr);
 
   return oldChild;
@@ -541,12 +617,6 @@ JSValueRef JSNode::prototypeGetProperty(std::string &name, JSValueRef *exception
 
 JSValueRef NodeInstance::getProperty(std::string &name, JSValueRef *exception) {
   auto &propertyMap = JSNode::getNodePropertyMap();
-  auto &prototypePropertyMap = JSNode::getNodePrototypePropertyMap();
-
-  if (prototypePropertyMap.count(name) > 0) {
-    JSStringHolder nameStringHolder = JSStringHolder(context, name);
-    return JSObjectGetProperty(ctx, prototype<JSNode>()->prototypeObject, nameStringHolder.getString(), exception);
-  }
 
   if (propertyMap.count(name) == 0) {
     return EventTargetInstance::getProperty(name, exception);
@@ -581,16 +651,8 @@ JSValueRef NodeInstance::getProperty(std::string &name, JSValueRef *exception) {
     auto instance = nextSibling();
     return instance != nullptr ? instance->object : JSValueMakeNull(ctx);
   }
-  case JSNode::NodeProperty::childNodes: {
-    JSValueRef arguments[childNodes.size()];
-
-    for (int i = 0; i < childNodes.size(); i++) {
-      arguments[i] = childNodes[i]->object;
-    }
-
-    JSObjectRef array = JSObjectMakeArray(_hostClass->ctx, childNodes.size(), arguments, nullptr);
-    return array;
-  }
+  case JSNode::NodeProperty::childNodes:
+    return childNodes.array(_hostClass->ctx);
   case JSNode::NodeProperty::nodeType:
     return JSValueMakeNumber(_hostClass->ctx, nodeType);
   case JSNode::NodeProperty::textContent: {
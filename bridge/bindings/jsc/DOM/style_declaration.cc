@@ -115,15 +115,16 @@ bool StyleDeclarationInstance::internalSetProperty(std::string &name, JSValueRef
     valueStr = JSValueToStringCopy(_hostClass->ctx, value, exception);
   }
 
-  name = parseJavaScriptCSSPropertyName(name);
+  // Name may be a shared property name from JSContext, keep it untouched.
+  std::string propertyName = parseJavaScriptCSSPropertyName(name);
 
   JSValueProtect(ctx, value);
-  properties[name] = value;
+  properties[propertyName] = value;
 
   NativeString args_01{};
   NativeString args_02{};
-  buildUICommandArgs(name, valueStr, args_01, args_02);
-  foundation::UICommandBuffer::instance(_hostClass->contextId)
+  buildUICommandArgs(propertyName, valueStr, args_01, args_02);
+  _hostClass->context->uiCommandBuffer()
     ->addCommand(ownerEventTarget->eventTargetId, UICommand::setStyle, args_01, args_02, nullptr);
 
   return true;
@@ -145,7 +146,7 @@ void StyleDeclarationInstance::internalRemoveProperty(std::string &name, JSValue
   std::string empty;
   buildUICommandArgs(name, empty, args_01, args_02);
 
-  foundation::UICommandBuffer::instance(_hostClass->contextId)
+  _hostClass->context->uiCommandBuffer()
     ->addCommand(ownerEventTarget->eventTargetId, UICommand::setStyle, args_01, args_02, nullptr);
 }
 
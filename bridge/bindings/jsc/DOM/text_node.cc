@@ -40,7 +40,7 @@ JSTextNode::TextNodeInstance::TextNodeInstance(JSTextNode *jsTextNode, JSStringR
 
   NativeString args_01{};
   buildUICommandArgs(data, args_01);
-  foundation::UICommandBuffer::instance(_hostClass->contextId)
+  _hostClass->context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::createTextNode, args_01, nativeTextNode);
 }
 
@@ -70,12 +70,13 @@ bool JSTextNode::TextNodeInstance::setProperty(std::string &name, JSValueRef val
     JSStringRef data = JSValueToStringCopy(_hostClass->ctx, value, exception);
     m_data.setString(data);
 
-    std::string dataString = JSStringToStdString(data);
+    // Send the UTF-16 characters as they are, the buffer copies them before data is released.
     NativeString args_01{};
     NativeString args_02{};
-    buildUICommandArgs(name, dataString, args_01, args_02);
-    foundation::UICommandBuffer::instance(_hostClass->contextId)
+    buildUICommandArgs(name, data, args_01, args_02);
+    _hostClass->context->uiCommandBuffer()
       ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
+    JSStringRelease(data);
     return true;
   } else {
     return NodeInstance::setProperty(name, value, exception);
@@ -107,7 +108,7 @@ void JSTextNode::TextNodeInstance::internalSetTextContent(JSStringRef content, J
   NativeString args_01{};
   NativeString args_02{};
   buildUICommandArgs(key, content, args_01, args_02);
-  foundation::UICommandBuffer::instance(context->getContextId())
+  context->uiCommandBuffer()
     ->addCommand(eventTargetId, UICommand::setProperty, args_01, args_02, nullptr);
 }
 
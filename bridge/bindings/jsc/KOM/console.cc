@@ -16,11 +16,8 @@ JSValueRef print(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
   const JSValueRef &log = arguments[0];
   if (JSValueIsString(ctx, log)) {
     JSStringRef str = JSValueToStringCopy(ctx, log, nullptr);
-    int32_t length = JSStringGetMaximumUTF8CStringSize(str);
-    char buffer[length];
-    JSStringGetUTF8CString(str, buffer, length);
+    stream << JSStringToStdString(str);
     JSStringRelease(str);
-    stream << buffer;
   } else {
     KRAKEN_LOG(ERROR) << "Failed to execute 'print': log must be string.";
     return JSValueMakeUndefined(ctx);
@@ -4,10 +4,13 @@
  */
 
 #include "performance.h"
+#include "bindings/jsc/DOM/events/touch_event.h"
 #include "dart_methods.h"
 #include "foundation/logging.h"
+#include "foundation/trace_event.h"
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 #define PERFORMANCE_ENTRY_NONE_UNIQUE_ID -1024
 
@@ -343,69 +346,32 @@ double getMeasureTotalDuration(const std::vector<NativePerformanceEntry *> &meas
 }
 
 struct FunctionCallTime {
-  FunctionCallTime(std::string name, double duration): name(std::move(name)), duration(duration) {}
-  std::string name;
-  double duration;
+  double duration{0};
+  int count{0};
 };
 
-void printFunctionCallTime() {
-  auto *functionCallTime = getNativeFunctionCallTime();
-  auto *functionCallCount = getNativeFunctionCallCount();
-  std::string buf = "\nNative Function Time Rank\n\n";
-  std::vector<FunctionCallTime> rankList;
-  for (auto &e : *functionCallTime) {
-    rankList.emplace_back(FunctionCallTime(e.first, e.second));
-  }
-
-  std::sort(rankList.begin(), rankList.end(), [](FunctionCallTime &left, FunctionCallTime &right) {
-    return left.duration > right.duration;
-  });
+// Rank trace events named eventName by the total time spent per detail, e.g. per property name.
+void printTraceEventRank(const char *title, const char *eventName) {
+  std::vector<foundation::TraceEvent> events;
+  foundation::TraceLog::collect(events);
 
-  for (auto &i : rankList) {
-    int count = (*functionCallCount)[i.name];
-    buf += "  -" + i.name + " " + std::to_string(i.duration) + "ms count: " + std::to_string(count) + " avg: " + std::to_string(i.duration /count) +"\n";
+  std::unordered_map<std::string, FunctionCallTime> callTime;
+  for (auto &event : events) {
+    if (strcmp(event.name, eventName) != 0 || event.detail == nullptr) continue;
+    auto &time = callTime[event.detail];
+    time.duration += event.duration / 1000.0;
+    time.count++;
   }
 
-  KRAKEN_LOG(VERBOSE) << buf;
-}
-
-void printHostClassGetPropertyCallTime() {
-  auto *callTime = getHostClassPropertyCallTime();
-  auto *callCount = getHostClassPropertyCallCount();
-  std::string buf = "\nHost Class GetProperty Time Rank\n\n";
-  std::vector<FunctionCallTime> rankList;
-  for (auto &e : *callTime) {
-    rankList.emplace_back(FunctionCallTime(e.first, e.second));
-  }
-
-  std::sort(rankList.begin(), rankList.end(), [](FunctionCallTime &left, FunctionCallTime &right) {
-    return left.duration > right.duration;
+  std::vector<std::pair<std::string, FunctionCallTime>> rankList(callTime.begin(), callTime.end());
+  std::sort(rankList.begin(), rankList.end(), [](auto &left, auto &right) {
+    return left.second.duration > right.second.duration;
   });
 
+  std::string buf = std::string("\n") + title + "\n\n";
   for (auto &i : rankList) {
-    int count = (*callCount)[i.name];
-    buf += "  -" + i.name + " " + std::to_string(i.duration) + "us count: " + std::to_string(count) + " avg: " + std::to_string(i.duration /count) +"\n";
-  }
-
-  KRAKEN_LOG(VERBOSE) << buf;
-}
-
-void printHostClassSetPropertyCallTime() {
-  auto *callTime = setHostClassPropertyCallTime();
-  auto *callCount = setHostClassPropertyCallCount();
-  std::string buf = "\nHost Class SetProperty Time Rank\n\n";
-  std::vector<FunctionCallTime> rankList;
-  for (auto &e : *callTime) {
-    rankList.emplace_back(FunctionCallTime(e.first, e.second));
-  }
-
-  std::sort(rankList.begin(), rankList.end(), [](FunctionCallTime &left, FunctionCallTime &right) {
-    return left.duration > right.duration;
-  });
-
-  for (auto &i : rankList) {
-    int count = (*callCount)[i.name];
-    buf += "  -" + i.name + " " + std::to_string(i.duration) + "us count: " + std::to_string(count) + " avg: " + std::to_string(i.duration /count) +"\n";
+    buf += "  -" + i.first + " " + std::to_string(i.second.duration) + "us count: " + std::to_string(i.second.count) +
+           " avg: " + std::to_string(i.second.duration / i.second.count) + "\n";
   }
 
   KRAKEN_LOG(VERBOSE) << buf;
@@ -580,9 +546,9 @@ Rendering: %.*fms
   PERF_PAINT_COST, 2, paintCost, 2, paintAvg, paintCount
 );
   // clang-format on
-  printFunctionCallTime();
-  printHostClassGetPropertyCallTime();
-  printHostClassSetPropertyCallTime();
+  printTraceEventRank("Native Function Time Rank", "NativeFunction.call");
+  printTraceEventRank("Host Class GetProperty Time Rank", "HostClass.getProperty");
+  printTraceEventRank("Host Class SetProperty Time Rank", "HostClass.setProperty");
 
   JSStringRef resultStringRef = JSStringCreateWithUTF8CString(buffer);
   return JSValueMakeString(ctx, resultStringRef);
@@ -675,6 +641,42 @@ JSValueRef JSPerformance::measure(JSContextRef ctx, JSObjectRef function, JSObje
   return nullptr;
 }
 
+JSValueRef JSPerformance::__kraken_event_object_stats__(JSContextRef ctx, JSObjectRef function,
+                                                        JSObjectRef thisObject, size_t argumentCount,
+                                                        const JSValueRef *arguments, JSValueRef *exception) {
+  auto performance = reinterpret_cast<JSPerformance *>(JSObjectGetPrivate(thisObject));
+  auto context = performance->context;
+  auto touchEvent = JSTouchEvent::instance(context);
+
+  int64_t classCacheHits;
+  int64_t classCacheMisses;
+  HostObject::getClassCacheStats(&classCacheHits, &classCacheMisses);
+
+  auto object = JSObjectMake(ctx, nullptr, exception);
+  JSC_SET_STRING_PROPERTY(context, object, "hostObjectClassCacheHits", JSValueMakeNumber(ctx, classCacheHits));
+  JSC_SET_STRING_PROPERTY(context, object, "hostObjectClassCacheMisses", JSValueMakeNumber(ctx, classCacheMisses));
+  JSC_SET_STRING_PROPERTY(context, object, "touchListCreated",
+                          JSValueMakeNumber(ctx, touchEvent->touchListCreatedCount));
+  JSC_SET_STRING_PROPERTY(context, object, "touchListDeferred",
+                          JSValueMakeNumber(ctx, touchEvent->touchListDeferredCount));
+  auto &payloadStats = context->eventPayloadPool()->stats();
+  JSC_SET_STRING_PROPERTY(context, object, "eventPayloadPoolHits", JSValueMakeNumber(ctx, payloadStats.hits));
+  JSC_SET_STRING_PROPERTY(context, object, "eventPayloadPoolMisses", JSValueMakeNumber(ctx, payloadStats.misses));
+  JSC_SET_STRING_PROPERTY(context, object, "eventPayloadsRecycled", JSValueMakeNumber(ctx, payloadStats.recycled));
+  JSC_SET_STRING_PROPERTY(context, object, "eventPayloadsDropped", JSValueMakeNumber(ctx, payloadStats.dropped));
+  return object;
+}
+
+JSValueRef JSPerformance::__kraken_bridge_stats__(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
+                                                  size_t argumentCount, const JSValueRef *arguments,
+                                                  JSValueRef *exception) {
+  auto performance = reinterpret_cast<JSPerformance *>(JSObjectGetPrivate(thisObject));
+  char *stats = getBridgeStats(performance->context->getContextId());
+  JSStringHolder statsStringHolder = JSStringHolder(performance->context, stats);
+  free(stats);
+  return JSValueMakeFromJSONString(ctx, statsStringHolder.getString());
+}
+
 std::vector<NativePerformanceEntry *> JSPerformance::getFullEntries() {
   auto &bridgeEntries = nativePerformance->entries;
 #if ENABLE_PROFILE
@@ -193,8 +193,9 @@ public:
 class JSPerformance : public HostObject {
 public:
   DEFINE_OBJECT_PROPERTY(Performance, 1, timeOrigin);
-  DEFINE_PROTOTYPE_OBJECT_PROPERTY(Performance, 10, now, toJSON, clearMarks, clearMeasures, getEntries,
-                                getEntriesByName, getEntriesByType, mark, measure, __kraken_navigation_summary__);
+  DEFINE_PROTOTYPE_OBJECT_PROPERTY(Performance, 12, now, toJSON, clearMarks, clearMeasures, getEntries,
+                                getEntriesByName, getEntriesByType, mark, measure, __kraken_navigation_summary__,
+                                __kraken_event_object_stats__, __kraken_bridge_stats__);
 
   static JSValueRef now(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
                         const JSValueRef arguments[], JSValueRef *exception);
@@ -225,6 +226,14 @@ public:
   static JSValueRef measure(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
                             const JSValueRef arguments[], JSValueRef *exception);
 
+  static JSValueRef __kraken_event_object_stats__(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
+                                                  size_t argumentCount, const JSValueRef arguments[],
+                                                  JSValueRef *exception);
+
+  static JSValueRef __kraken_bridge_stats__(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
+                                            size_t argumentCount, const JSValueRef arguments[],
+                                            JSValueRef *exception);
+
 #if ENABLE_PROFILE
   static JSValueRef __kraken_navigation_summary__(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount, JSValueRef const *arguments, JSValueRef *exception);
 #endif
@@ -252,6 +261,9 @@ private:
   JSFunctionHolder m_getEntriesByType{context, jsObject, this, "getEntriesByType", getEntriesByType};
   JSFunctionHolder m_mark{context, jsObject, this, "mark", mark};
   JSFunctionHolder m_measure{context, jsObject, this, "measure", measure};
+  JSFunctionHolder m_eventObjectStats{context, jsObject, this, "__kraken_event_object_stats__",
+                                      __kraken_event_object_stats__};
+  JSFunctionHolder m_bridgeStats{context, jsObject, this, "__kraken_bridge_stats__", __kraken_bridge_stats__};
 
 #if ENABLE_PROFILE
   JSObjectRef m_summary{nullptr};
@@ -7,62 +7,254 @@
 #include "bridge_jsc.h"
 #include "dart_methods.h"
 #include "foundation/bridge_callback.h"
+#include "foundation/trace_event.h"
 #include "bindings/jsc/host_class.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 namespace kraken::binding::jsc {
 
 using namespace kraken::foundation;
 
-void handleTimerCallback(BridgeCallback::Context *callbackContext, const char *errmsg) {
-  auto &_context = callbackContext->_context;
-  JSValueRef exception = nullptr;
-  if (callbackContext->_callback == nullptr) {
-    // throw JSError inside of dart function callback will directly cause crash
-    // so we handle it instead of throw
-    throwJSError(_context.context(), "Failed to trigger callback: timer callback is null.", &exception);
-    _context.handleException(exception);
-    return;
+namespace {
+std::unordered_map<int32_t, bool> nativeTimerQueueEnabled;
+std::atomic<uintptr_t> nextTimerTick{1};
+
+int64_t currentTimeMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+} // namespace
+
+void TimerQueue::setEnabled(int32_t contextId, bool enabled) {
+  nativeTimerQueueEnabled[contextId] = enabled;
+}
+
+bool TimerQueue::isEnabled(int32_t contextId) {
+  auto it = nativeTimerQueueEnabled.find(contextId);
+  return it != nativeTimerQueueEnabled.end() && it->second;
+}
+
+TimerQueue::TimerQueue(JSContext *context) : m_context(context) {}
+
+TimerQueue::~TimerQueue() {
+  if (m_armedDartTimerId != -1 && getDartMethod()->clearTimeout != nullptr) {
+    getDartMethod()->clearTimeout(m_context->getContextId(), m_armedDartTimerId);
   }
 
-  if (!JSValueIsObject(_context.context(), callbackContext->_callback)) {
-    return;
+  if (!m_context->isValid()) return;
+  for (auto &timer : m_timers) {
+    JSValueUnprotect(m_context->context(), timer.second.callback);
   }
+}
 
-  if (errmsg != nullptr) {
-    throwJSError(_context.context(), errmsg, &exception);
-    _context.handleException(exception);
-    return;
+int32_t TimerQueue::setTimer(JSObjectRef callback, int32_t timeout, bool repeat) {
+  int32_t timerId = m_nextTimerId++;
+  JSValueProtect(m_context->context(), callback);
+  m_timers[timerId] = Timer{callback, timeout, m_nestingLevel + 1, repeat};
+  schedule(timerId, timeout, m_nestingLevel);
+  arm();
+  return timerId;
+}
+
+bool TimerQueue::clearTimer(int32_t timerId) {
+  if (timerId < NATIVE_TIMER_ID_BASE) return false;
+
+  auto it = m_timers.find(timerId);
+  if (it == m_timers.end()) return true;
+
+  JSValueUnprotect(m_context->context(), it->second.callback);
+  m_timers.erase(it);
+  auto keyIt = m_timerKeys.find(timerId);
+  if (keyIt != m_timerKeys.end()) {
+    m_queue.erase(keyIt->second);
+    m_timerKeys.erase(keyIt);
   }
+  // The armed dart timer is left alone, an early tick finds nothing due and re-arms.
+  return true;
+}
 
-  JSObjectRef callbackObjectRef = JSValueToObject(_context.context(), callbackContext->_callback, &exception);
-  JSObjectCallAsFunction(_context.context(), callbackObjectRef, _context.global(), 0, nullptr, &exception);
-  _context.handleException(exception);
+void TimerQueue::schedule(int32_t timerId, int32_t timeout, int32_t nestingLevel) {
+  // https://html.spec.whatwg.org/multipage/timers-and-user-prompts.html#timer-initialisation-steps
+  if (timeout < 0) timeout = 0;
+  if (nestingLevel > 5 && timeout < 4) timeout = 4;
+
+  TimerKey key{currentTimeMillis() + timeout, m_sequence++};
+  m_queue[key] = timerId;
+  m_timerKeys[timerId] = key;
 }
 
-void handlePersistentCallback(void *ptr, int32_t contextId, const char *errmsg) {
-  auto *callbackContext = static_cast<BridgeCallback::Context *>(ptr);
-  JSContext &_context = callbackContext->_context;
-  if (!checkContext(contextId, &_context)) return;
+void TimerQueue::arm() {
+  if (m_queue.empty()) return;
 
-  if (!_context.isValid()) return;
+  int64_t deadline = m_queue.begin()->first.first;
+  if (m_armedDartTimerId != -1) {
+    if (m_armedDeadline <= deadline) return;
+    getDartMethod()->clearTimeout(m_context->getContextId(), m_armedDartTimerId);
+    dartCallCount++;
+  }
 
-  handleTimerCallback(callbackContext, errmsg);
+  int64_t delay = std::max<int64_t>(deadline - currentTimeMillis(), 0);
+  m_armedTick = nextTimerTick.fetch_add(1, std::memory_order_relaxed);
+  m_armedDeadline = deadline;
+  m_armedDartTimerId = getDartMethod()->setTimeout(reinterpret_cast<void *>(m_armedTick), m_context->getContextId(),
+                                                   handleTick, static_cast<int32_t>(delay));
+  dartCallCount++;
 }
 
-void handleRAFTransientCallback(void *ptr, int32_t contextId, double highResTimeStamp, const char *errmsg) {
-  auto *callbackContext = static_cast<BridgeCallback::Context *>(ptr);
-  JSContext &_context = callbackContext->_context;
-  if (!checkContext(contextId, &_context)) return;
+void TimerQueue::handleTick(void *ptr, int32_t contextId, const char *errmsg) {
+  if (!checkContext(contextId)) return;
+  auto bridge = static_cast<JSBridge *>(getJSContext(contextId));
+  auto queue = bridge->timerQueue;
+  // Ticks armed by a reloaded bridge or replaced by an earlier deadline are ignored.
+  if (queue->m_armedTick != reinterpret_cast<uintptr_t>(ptr)) return;
 
-  if (!_context.isValid()) return;
+  queue->dartCallbackCount++;
+  queue->m_armedDartTimerId = -1;
+  queue->m_armedTick = 0;
+  if (!queue->m_context->isValid()) return;
 
-  JSValueRef exception = nullptr;
+  queue->flush();
+  queue->arm();
+}
+
+void TimerQueue::flush() {
+  KRAKEN_TRACE_EVENT("TimerQueue.flush", m_context->getContextId());
+  int64_t now = currentTimeMillis();
+  // Timers set by callbacks of this batch run in a later batch, even with a zero timeout.
+  uint64_t lastSequence = m_sequence;
+  JSContextRef ctx = m_context->context();
+
+  while (!m_queue.empty()) {
+    auto it = m_queue.begin();
+    const TimerKey &key = it->first;
+    if (key.first > now || key.second >= lastSequence) break;
+
+    int32_t timerId = it->second;
+    m_queue.erase(it);
+    m_timerKeys.erase(timerId);
+
+    Timer timer = m_timers[timerId];
+    if (!timer.repeat) m_timers.erase(timerId);
+
+    m_nestingLevel = timer.nestingLevel;
+    JSValueRef exception = nullptr;
+    JSObjectCallAsFunction(ctx, timer.callback, m_context->global(), 0, nullptr, &exception);
+    m_nestingLevel = 0;
+    firedTimerCount++;
+
+    if (!m_context->isValid()) return;
+    m_context->handleException(exception);
+
+    if (!timer.repeat) {
+      JSValueUnprotect(ctx, timer.callback);
+      continue;
+    }
+
+    // The interval is rescheduled after its callback, unless the callback cleared it.
+    auto timerIt = m_timers.find(timerId);
+    if (timerIt != m_timers.end()) {
+      schedule(timerId, timer.timeout, timer.nestingLevel);
+      timerIt->second.nestingLevel++;
+    }
+  }
+}
+
+AnimationFrameQueue::AnimationFrameQueue(JSContext *context) : m_context(context) {}
+
+AnimationFrameQueue::~AnimationFrameQueue() {
+  if (!m_context->isValid()) return;
+  for (auto &callback : m_callbacks) {
+    JSValueUnprotect(m_context->context(), callback.second);
+  }
+}
+
+int32_t AnimationFrameQueue::requestFrame(JSObjectRef callback) {
+  int32_t requestId = m_nextRequestId++;
+  JSValueProtect(m_context->context(), callback);
+  m_callbacks[requestId] = callback;
+  m_order.emplace_back(requestId);
+  if (!arm()) {
+    cancelFrame(requestId);
+    m_order.pop_back();
+    return -1;
+  }
+  return requestId;
+}
 
+void AnimationFrameQueue::cancelFrame(int32_t requestId) {
+  auto it = m_callbacks.find(requestId);
+  if (it == m_callbacks.end()) return;
+  JSValueUnprotect(m_context->context(), it->second);
+  m_callbacks.erase(it);
+}
+
+bool AnimationFrameQueue::arm() {
+  if (m_armedFrame != 0 || m_callbacks.empty()) return true;
+  m_armedFrame = nextTimerTick.fetch_add(1, std::memory_order_relaxed);
+  int32_t frameId = getDartMethod()->requestAnimationFrame(reinterpret_cast<void *>(m_armedFrame),
+                                                           m_context->getContextId(), handleFrame);
+  dartFrameRequestCount++;
+  if (frameId == -1) {
+    m_armedFrame = 0;
+    return false;
+  }
+  return true;
+}
+
+void AnimationFrameQueue::handleFrame(void *ptr, int32_t contextId, double highResTimeStamp, const char *errmsg) {
+  if (!checkContext(contextId)) return;
+  auto bridge = static_cast<JSBridge *>(getJSContext(contextId));
+  auto queue = bridge->animationFrameQueue;
+  // Frames requested by a reloaded bridge are ignored.
+  if (queue->m_armedFrame != reinterpret_cast<uintptr_t>(ptr)) return;
+  queue->m_armedFrame = 0;
+  if (!queue->m_context->isValid()) return;
+
+  if (errmsg != nullptr) {
+    JSValueRef exception = nullptr;
+    throwJSError(queue->m_context->context(), errmsg, &exception);
+    queue->m_context->handleException(exception);
+  }
+
+  queue->flush(highResTimeStamp);
+}
+
+void AnimationFrameQueue::flush(double highResTimeStamp) {
+  KRAKEN_TRACE_EVENT("AnimationFrameQueue.flush", m_context->getContextId());
+  // https://html.spec.whatwg.org/multipage/imagebitmap-and-animations.html#run-the-animation-frame-callbacks
+  std::vector<int32_t> order;
+  order.swap(m_order);
+  JSContextRef ctx = m_context->context();
+  const JSValueRef arguments[] = {JSValueMakeNumber(ctx, highResTimeStamp)};
+
+  for (int32_t requestId : order) {
+    auto it = m_callbacks.find(requestId);
+    if (it == m_callbacks.end()) continue;
+    JSObjectRef callback = it->second;
+    m_callbacks.erase(it);
+
+    JSValueRef exception = nullptr;
+    JSObjectCallAsFunction(ctx, callback, m_context->global(), 1, arguments, &exception);
+    JSValueUnprotect(ctx, callback);
+    firedCallbackCount++;
+
+    if (!m_context->isValid()) return;
+    m_context->handleException(exception);
+  }
+
+  arm();
+}
+
+void handleTimerCallback(BridgeCallback::Context *callbackContext, const char *errmsg) {
+  auto &_context = callbackContext->_context;
+  JSValueRef exception = nullptr;
   if (callbackContext->_callback == nullptr) {
     // throw JSError inside of dart function callback will directly cause crash
     // so we handle it instead of throw
-    throwJSError(_context.context(), "Failed to trigger callback: requestAnimationFrame callback is null.",
-                    &exception);
+    throwJSError(_context.context(), "Failed to trigger callback: timer callback is null.", &exception);
     _context.handleException(exception);
     return;
   }
@@ -77,25 +269,32 @@ void handleRAFTransientCallback(void *ptr, int32_t contextId, double highResTime
     return;
   }
 
+  KRAKEN_TRACE_EVENT("Timer.callback", _context.getContextId());
   JSObjectRef callbackObjectRef = JSValueToObject(_context.context(), callbackContext->_callback, &exception);
-
-  const JSValueRef args[1]{JSValueMakeNumber(_context.context(), highResTimeStamp)};
-
-  JSObjectCallAsFunction(_context.context(), callbackObjectRef, _context.global(), 1, args, &exception);
+  JSObjectCallAsFunction(_context.context(), callbackObjectRef, _context.global(), 0, nullptr, &exception);
   _context.handleException(exception);
-  auto bridge = static_cast<JSBridge *>(callbackContext->_context.getOwner());
-  bridge->bridgeCallback->freeBridgeCallbackContext(callbackContext);
 }
 
-void handleTransientCallback(void *ptr, int32_t contextId, const char *errmsg) {
-  auto *callbackContext = static_cast<BridgeCallback::Context *>(ptr);
+void handlePersistentCallback(void *ptr, int32_t contextId, const char *errmsg) {
+  auto *callbackContext = JSBridge::getCallbackContext(contextId, ptr);
+  if (callbackContext == nullptr) return;
   JSContext &_context = callbackContext->_context;
-  if (!checkContext(contextId, &_context)) return;
+  static_cast<JSBridge *>(_context.getOwner())->timerQueue->dartCallbackCount++;
+
+  if (!_context.isValid()) return;
 
   handleTimerCallback(callbackContext, errmsg);
+}
 
+void handleTransientCallback(void *ptr, int32_t contextId, const char *errmsg) {
+  auto *callbackContext = JSBridge::getCallbackContext(contextId, ptr);
+  if (callbackContext == nullptr) return;
   auto bridge = static_cast<JSBridge *>(callbackContext->_context.getOwner());
-  bridge->bridgeCallback->freeBridgeCallbackContext(callbackContext);
+  bridge->timerQueue->dartCallbackCount++;
+
+  handleTimerCallback(callbackContext, errmsg);
+
+  bridge->bridgeCallback->freeBridgeCallbackContext(ptr);
 }
 
 JSValueRef setTimeout(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
@@ -139,11 +338,16 @@ JSValueRef setTimeout(JSContextRef ctx, JSObjectRef function, JSObjectRef thisOb
     return nullptr;
   }
 
-  auto callbackContext = std::make_unique<BridgeCallback::Context>(*context, callbackObjectRef, exception);
   auto bridge = static_cast<JSBridge *>(context->getOwner());
+  if (TimerQueue::isEnabled(context->getContextId())) {
+    return JSValueMakeNumber(ctx, bridge->timerQueue->setTimer(callbackObjectRef, timeout, false));
+  }
+
+  auto callbackContext = std::make_unique<BridgeCallback::Context>(*context, callbackObjectRef, exception);
+  bridge->timerQueue->dartCallCount++;
   auto timerId = bridge->bridgeCallback->registerCallback<int32_t>(
-    std::move(callbackContext), [&timeout](BridgeCallback::Context *callbackContext, int32_t contextId) {
-      return getDartMethod()->setTimeout(callbackContext, contextId, handleTransientCallback, timeout);
+    std::move(callbackContext), [&timeout](BridgeCallback::Handle callbackHandle, int32_t contextId) {
+      return getDartMethod()->setTimeout(callbackHandle, contextId, handleTransientCallback, timeout);
     });
 
   // `-1` represents ffi error occurred.
@@ -196,12 +400,17 @@ JSValueRef setInterval(JSContextRef ctx, JSObjectRef function, JSObjectRef thisO
     return nullptr;
   }
 
-  // the context pointer which will be pass by pointer address to dart code.
-  auto callbackContext = std::make_unique<BridgeCallback::Context>(*context, callbackObjectRef, exception);
   auto bridge = static_cast<JSBridge *>(context->getOwner());
+  if (TimerQueue::isEnabled(context->getContextId())) {
+    return JSValueMakeNumber(ctx, bridge->timerQueue->setTimer(callbackObjectRef, timeout, true));
+  }
+
+  // the context is kept by the bridge, dart only receives its handle.
+  auto callbackContext = std::make_unique<BridgeCallback::Context>(*context, callbackObjectRef, exception);
+  bridge->timerQueue->dartCallCount++;
   auto timerId = bridge->bridgeCallback->registerCallback<int32_t>(
-    std::move(callbackContext), [&timeout](BridgeCallback::Context *callbackContext, int32_t contextId) {
-      return getDartMethod()->setInterval(callbackContext, contextId, handlePersistentCallback, timeout);
+    std::move(callbackContext), [&timeout](BridgeCallback::Handle callbackHandle, int32_t contextId) {
+      return getDartMethod()->setInterval(callbackHandle, contextId, handlePersistentCallback, timeout);
     });
 
   if (timerId == -1) {
@@ -228,11 +437,15 @@ JSValueRef clearTimeout(JSContextRef ctx, JSObjectRef function, JSObjectRef this
 
   auto id = static_cast<int32_t>(JSValueToNumber(ctx, timerIdValueRef, exception));
 
+  auto bridge = static_cast<JSBridge *>(context->getOwner());
+  if (bridge->timerQueue->clearTimer(id)) return nullptr;
+
   if (getDartMethod()->clearTimeout == nullptr) {
     throwJSError(ctx, "Failed to execute 'clearTimeout': dart method (clearTimeout) is not registered.", exception);
     return nullptr;
   }
 
+  bridge->timerQueue->dartCallCount++;
   getDartMethod()->clearTimeout(context->getContextId(), id);
   return nullptr;
 }
@@ -256,14 +469,8 @@ JSValueRef cancelAnimationFrame(JSContextRef ctx, JSObjectRef function, JSObject
 
   auto id = static_cast<int32_t>(JSValueToNumber(ctx, requestIdValueRef, exception));
 
-  if (getDartMethod()->cancelAnimationFrame == nullptr) {
-    throwJSError(ctx,
-                    "Failed to execute 'cancelAnimationFrame': dart method (cancelAnimationFrame) is not registered.",
-                    exception);
-    return nullptr;
-  }
-
-  getDartMethod()->cancelAnimationFrame(context->getContextId(), id);
+  auto bridge = static_cast<JSBridge *>(context->getOwner());
+  bridge->animationFrameQueue->cancelFrame(id);
 
   return nullptr;
 }
@@ -293,9 +500,6 @@ JSValueRef requestAnimationFrame(JSContextRef ctx, JSObjectRef function, JSObjec
     return nullptr;
   }
 
-  // the context pointer which will be pass by pointer address to dart code.
-  auto callbackContext = std::make_unique<BridgeCallback::Context>(*context, callbackObjectRef, exception);
-
   if (getDartMethod()->flushUICommand == nullptr) {
     throwJSError(ctx,
                     "Failed to execute '__kraken_flush_ui_command__': dart method (flushUICommand) is not registered.",
@@ -313,10 +517,7 @@ JSValueRef requestAnimationFrame(JSContextRef ctx, JSObjectRef function, JSObjec
   }
 
   auto bridge = static_cast<JSBridge *>(context->getOwner());
-  int32_t requestId = bridge->bridgeCallback->registerCallback<int32_t>(
-    std::move(callbackContext), [](BridgeCallback::Context *callbackContext, int32_t contextId) {
-      return getDartMethod()->requestAnimationFrame(callbackContext, contextId, handleRAFTransientCallback);
-    });
+  int32_t requestId = bridge->animationFrameQueue->requestFrame(callbackObjectRef);
 
   // `-1` represents some error occurred.
   if (requestId == -1) {
@@ -7,12 +7,96 @@
 #define BRIDGE_TIMER_H
 
 #include "bindings/jsc/js_context_internal.h"
+#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace kraken::binding::jsc {
 
 void bindTimer(std::unique_ptr<JSContext> &context);
 
-} // namespace kraken
+// Timers owned by the bridge. Pending timers share a single dart timer armed for the earliest deadline, and all
+// timers due when it expires fire in one batch, so a timer no longer costs a dart call to schedule and another one
+// to fire. Disabled by default, see setNativeTimerQueue.
+class TimerQueue {
+public:
+  // Ids of native timers start here, so they never collide with ids handed out by dart timers.
+  static constexpr int32_t NATIVE_TIMER_ID_BASE = 1 << 30;
+
+  static void setEnabled(int32_t contextId, bool enabled);
+  static bool isEnabled(int32_t contextId);
+
+  TimerQueue() = delete;
+  explicit TimerQueue(JSContext *context);
+  ~TimerQueue();
+
+  int32_t setTimer(JSObjectRef callback, int32_t timeout, bool repeat);
+  // Returns false if timerId is not a native timer.
+  bool clearTimer(int32_t timerId);
+
+  // Calls and callbacks crossing into dart for timers, and the number of timer callbacks fired.
+  int64_t dartCallCount{0};
+  int64_t dartCallbackCount{0};
+  int64_t firedTimerCount{0};
+
+private:
+  struct Timer {
+    JSObjectRef callback;
+    int32_t timeout;
+    int32_t nestingLevel;
+    bool repeat;
+  };
+  // Deadline in milliseconds and scheduling order, timers with equal deadlines fire in the order they were set.
+  using TimerKey = std::pair<int64_t, uint64_t>;
+
+  static void handleTick(void *ptr, int32_t contextId, const char *errmsg);
+  void schedule(int32_t timerId, int32_t timeout, int32_t nestingLevel);
+  void flush();
+  void arm();
+
+  JSContext *m_context;
+  std::unordered_map<int32_t, Timer> m_timers;
+  std::unordered_map<int32_t, TimerKey> m_timerKeys;
+  std::map<TimerKey, int32_t> m_queue;
+  int32_t m_nextTimerId{NATIVE_TIMER_ID_BASE};
+  uint64_t m_sequence{0};
+  // Nesting level of the timer whose callback is running, 0 outside of timer callbacks.
+  int32_t m_nestingLevel{0};
+  int32_t m_armedDartTimerId{-1};
+  int64_t m_armedDeadline{0};
+  uintptr_t m_armedTick{0};
+};
+
+// requestAnimationFrame callbacks of a context. One dart frame callback is requested per frame, and the whole list
+// of callbacks runs when it fires. Callbacks requested while a frame runs are delivered in the next frame.
+class AnimationFrameQueue {
+public:
+  AnimationFrameQueue() = delete;
+  explicit AnimationFrameQueue(JSContext *context);
+  ~AnimationFrameQueue();
+
+  int32_t requestFrame(JSObjectRef callback);
+  void cancelFrame(int32_t requestId);
+
+  // Frames requested from dart, and animation frame callbacks fired.
+  int64_t dartFrameRequestCount{0};
+  int64_t firedCallbackCount{0};
+
+private:
+  // The dart frame callback is the only driver of flush.
+  static void handleFrame(void *ptr, int32_t contextId, double highResTimeStamp, const char *errmsg);
+  void flush(double highResTimeStamp);
+  bool arm();
+
+  JSContext *m_context;
+  // Cancelled ids are only erased from the map, their entries in m_order are skipped when the frame runs.
+  std::unordered_map<int32_t, JSObjectRef> m_callbacks;
+  std::vector<int32_t> m_order;
+  int32_t m_nextRequestId{1};
+  uintptr_t m_armedFrame{0};
+};
+
+} // namespace kraken::binding::jsc
 
 #endif // BRIDGE_TIMER_H
@@ -77,6 +77,8 @@ JSValueRef WindowInstance::getProperty(std::string &name, JSValueRef *exception)
 
   JSValueRef eventTargetRet = EventTargetInstance::getProperty(name, exception);
   if (eventTargetRet != nullptr) return eventTargetRet;
+  // Left to the prototype of window, globals must not shadow them.
+  if (JSEventTarget::getEventTargetPrototypePropertyMap().count(name) > 0) return nullptr;
 
   JSStringHolder keyStringHolder = JSStringHolder(context, name);
   if (JSObjectHasProperty(ctx, _hostClass->context->global(), keyStringHolder.getString())) {
@@ -5,17 +5,39 @@
 
 #include "host_class.h"
 #include "foundation/logging.h"
+#include "foundation/trace_event.h"
 #include "KOM/performance.h"
+#include <map>
+#include <mutex>
+#include <tuple>
 
 #define PRIVATE_PROTO_KEY "__private_proto__"
 
 namespace kraken::binding::jsc {
 
+namespace {
+// Class definitions of host classes only depend on their name and static tables, so JSClassRefs are created
+// once per process and reused by every context.
+enum HostClassKind { CONSTRUCTOR_CLASS, STATIC_CONSTRUCTOR_CLASS, INSTANCE_CLASS, PROTOTYPE_CLASS };
+using HostClassKey = std::tuple<std::string, HostClassKind, const JSStaticFunction *, const JSStaticValue *>;
+std::mutex hostClassMutex;
+std::map<HostClassKey, JSClassRef> hostClassMap;
+
+JSClassRef getHostClassRef(const HostClassKey &key, const JSClassDefinition &definition) {
+  std::lock_guard<std::mutex> guard(hostClassMutex);
+  auto it = hostClassMap.find(key);
+  if (it != hostClassMap.end()) return it->second;
+  JSClassRef classRef = JSClassCreate(&definition);
+  hostClassMap[key] = classRef;
+  return classRef;
+}
+} // namespace
+
 HostClass::HostClass(JSContext *context, std::string name)
   : context(context), _name(name), ctx(context->context()), contextId(context->getContextId()) {
   JSClassDefinition hostClassDefinition = kJSClassDefinitionEmpty;
   JSC_CREATE_HOST_CLASS_DEFINITION(hostClassDefinition, nullptr, _name.c_str(), nullptr, nullptr, HostClass);
-  jsClass = JSClassCreate(&hostClassDefinition);
+  jsClass = getHostClassRef(HostClassKey(_name, CONSTRUCTOR_CLASS, nullptr, nullptr), hostClassDefinition);
   JSClassRetain(jsClass);
   classObject = JSObjectMake(ctx, jsClass, this);
   prototypeObject = JSObjectMake(ctx, nullptr, this);
@@ -23,7 +45,7 @@ HostClass::HostClass(JSContext *context, std::string name)
   JSValueProtect(ctx, prototypeObject);
   JSClassDefinition hostInstanceDefinition = kJSClassDefinitionEmpty;
   JSC_CREATE_HOST_CLASS_INSTANCE_DEFINITION(hostInstanceDefinition, _name.c_str(), HostClass, nullptr);
-  instanceClass = JSClassCreate(&hostInstanceDefinition);
+  instanceClass = getHostClassRef(HostClassKey(_name, INSTANCE_CLASS, nullptr, nullptr), hostInstanceDefinition);
   JSClassRetain(instanceClass);
 }
 
@@ -33,7 +55,7 @@ HostClass::HostClass(JSContext *context, HostClass *parentHostClass, std::string
   JSClassDefinition hostClassDefinition = kJSClassDefinitionEmpty;
   JSC_CREATE_HOST_CLASS_DEFINITION(hostClassDefinition, nullptr, _name.c_str(), staticFunction, staticValue, HostClass);
   hostClassDefinition.attributes = kJSClassAttributeNone;
-  jsClass = JSClassCreate(&hostClassDefinition);
+  jsClass = getHostClassRef(HostClassKey(_name, STATIC_CONSTRUCTOR_CLASS, staticFunction, staticValue), hostClassDefinition);
   JSClassRetain(jsClass);
   classObject = JSObjectMake(ctx, jsClass, this);
   prototypeObject = JSObjectMake(ctx, nullptr, this);
@@ -41,15 +63,14 @@ HostClass::HostClass(JSContext *context, HostClass *parentHostClass, std::string
   JSValueProtect(ctx, prototypeObject);
   JSClassDefinition hostInstanceDefinition = kJSClassDefinitionEmpty;
   JSC_CREATE_HOST_CLASS_INSTANCE_DEFINITION(hostInstanceDefinition, _name.c_str(), HostClass, nullptr);
-  instanceClass = JSClassCreate(&hostInstanceDefinition);
+  instanceClass = getHostClassRef(HostClassKey(_name, INSTANCE_CLASS, nullptr, nullptr), hostInstanceDefinition);
   JSClassRetain(instanceClass);
 }
 
 void HostClass::proxyFinalize(JSObjectRef object) {
   auto hostClass = static_cast<HostClass *>(JSObjectGetPrivate(object));
   JSObjectSetPrivate(object, nullptr);
-  JSClassRelease(hostClass->jsClass);
-  JSClassRelease(hostClass->instanceClass);
+  // The destructor releases the class refs retained by the constructor, the process wide cache keeps its own.
   delete hostClass;
 }
 
@@ -103,8 +124,9 @@ JSValueRef constructorCall(JSContextRef ctx, JSObjectRef function, JSObjectRef t
 
 JSValueRef HostClass::proxyGetProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName,
                                        JSValueRef *exception) {
-  auto &&name = JSStringToStdString(propertyName);
   auto hostClass = static_cast<HostClass *>(JSObjectGetPrivate(object));
+  std::string nameStorage;
+  std::string &name = hostClass->context->getPropertyName(propertyName, nameStorage);
 
   if (name == "call") {
     if (hostClass->_call == nullptr) {
@@ -121,35 +143,19 @@ JSValueRef HostClass::proxyGetProperty(JSContextRef ctx, JSObjectRef object, JSS
   return hostClass->getProperty(name, exception);
 }
 
-#if ENABLE_PROFILE
-std::unordered_map<std::string, double> m_get_property_call_time;
-std::unordered_map<std::string, int> m_get_property_call_count;
-std::unordered_map<std::string, double> *getHostClassPropertyCallTime() {
-  return &m_get_property_call_time;
-}
-std::unordered_map<std::string, int> *getHostClassPropertyCallCount() {
-  return &m_get_property_call_count;
-}
-#endif
-
 JSValueRef HostClass::proxyInstanceGetProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName,
                                                JSValueRef *exception) {
   auto hostClassInstance = reinterpret_cast<HostClass::Instance *>(JSObjectGetPrivate(object));
+  foundation::TraceScope trace("HostClass.getProperty", hostClassInstance->context->getContextId());
 #if ENABLE_PROFILE
   auto nativePerformance = binding::jsc::NativePerformance::instance(hostClassInstance->context->uniqueId);
-  auto startTime = std::chrono::system_clock::now().time_since_epoch().count();
   nativePerformance->mark(PERF_JS_HOST_CLASS_GET_PROPERTY_START);
 #endif
-  std::string &&name = JSStringToStdString(propertyName);
+  std::string nameStorage;
+  std::string &name = hostClassInstance->context->getPropertyName(propertyName, nameStorage);
+  if (trace.isActive()) trace.setDetail(foundation::TraceLog::internString(name));
   JSValueRef result = hostClassInstance->getProperty(name, exception);
 #if ENABLE_PROFILE
-  auto endTime = std::chrono::system_clock::now().time_since_epoch().count();
-  if (m_get_property_call_time.count(name) == 0) {
-    m_get_property_call_time[name] = 0.0;
-    m_get_property_call_time[name] = 0;
-  }
-  m_get_property_call_time[name] += (endTime - startTime);
-  m_get_property_call_count[name]++;
   nativePerformance->mark(PERF_JS_HOST_CLASS_GET_PROPERTY_END);
 #endif
   return result;
@@ -158,41 +164,26 @@ JSValueRef HostClass::proxyInstanceGetProperty(JSContextRef ctx, JSObjectRef obj
 JSValueRef HostClass::proxyPrototypeGetProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName,
                                                 JSValueRef *exception) {
   auto hostClass = reinterpret_cast<HostClass *>(JSObjectGetPrivate(object));
-  std::string &&name = JSStringToStdString(propertyName);
+  std::string nameStorage;
+  std::string &name = hostClass->context->getPropertyName(propertyName, nameStorage);
   JSValueRef result = hostClass->prototypeGetProperty(name, exception);
   return result;
 }
 
-#if ENABLE_PROFILE
-std::unordered_map<std::string, double> m_set_property_call_time;
-std::unordered_map<std::string, int> m_set_property_call_count;
-std::unordered_map<std::string, double> *setHostClassPropertyCallTime() {
-  return &m_set_property_call_time;
-}
-std::unordered_map<std::string, int> *setHostClassPropertyCallCount() {
-  return &m_set_property_call_count;
-}
-#endif
-
 bool HostClass::proxyInstanceSetProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName,
                                          JSValueRef value, JSValueRef *exception) {
   auto hostClassInstance = static_cast<HostClass::Instance *>(JSObjectGetPrivate(object));
+  foundation::TraceScope trace("HostClass.setProperty", hostClassInstance->context->getContextId());
 #if ENABLE_PROFILE
   auto nativePerformance = binding::jsc::NativePerformance::instance(hostClassInstance->context->uniqueId);
   nativePerformance->mark(PERF_JS_HOST_CLASS_SET_PROPERTY_START);
-  auto startTime = std::chrono::system_clock::now().time_since_epoch().count();
 #endif
-  std::string &&name = JSStringToStdString(propertyName);
+  std::string nameStorage;
+  std::string &name = hostClassInstance->context->getPropertyName(propertyName, nameStorage);
+  if (trace.isActive()) trace.setDetail(foundation::TraceLog::internString(name));
   bool handledBySelf = hostClassInstance->setProperty(name, value, exception);
   bool result = !hostClassInstance->context->handleException(*exception) || handledBySelf;
 #if ENABLE_PROFILE
-  auto endTime = std::chrono::system_clock::now().time_since_epoch().count();
-  if (m_set_property_call_time.count(name) == 0) {
-    m_set_property_call_time[name] = 0.0;
-    m_set_property_call_time[name] = 0;
-  }
-  m_set_property_call_time[name] += (endTime - startTime);
-  m_set_property_call_count[name]++;
   nativePerformance->mark(PERF_JS_HOST_CLASS_SET_PROPERTY_END);
 #endif
   return result;
@@ -222,6 +213,7 @@ HostClass::~HostClass() {
 
   JSClassRelease(jsClass);
   JSClassRelease(instanceClass);
+  if (_prototypeClass != nullptr) JSClassRelease(_prototypeClass);
 }
 
 JSValueRef HostClass::getProperty(std::string &name, JSValueRef *exception) {
@@ -249,9 +241,31 @@ void HostClass::setProto(JSContextRef ctx, JSObjectRef prototype, JSObjectRef ch
   JSObjectSetProperty(ctx, child, privateKey, prototype, kJSPropertyAttributeReadOnly, exception);
 }
 
+JSClassRef HostClass::getPrototypeClassRef(const char *className, JSClassRef parentClass,
+                                           const JSStaticFunction *staticFunctions) {
+  JSClassDefinition prototypeDefinition = kJSClassDefinitionEmpty;
+  prototypeDefinition.className = className;
+  prototypeDefinition.parentClass = parentClass;
+  prototypeDefinition.attributes = kJSClassAttributeNoAutomaticPrototype;
+  prototypeDefinition.staticFunctions = staticFunctions;
+  return getHostClassRef(HostClassKey(className, PROTOTYPE_CLASS, staticFunctions, nullptr), prototypeDefinition);
+}
+
+void HostClass::setPrototypeClass(JSClassRef prototypeClass) {
+  JSClassRetain(prototypeClass);
+  if (_prototypeClass != nullptr) JSClassRelease(_prototypeClass);
+  _prototypeClass = prototypeClass;
+
+  JSValueUnprotect(ctx, prototypeObject);
+  // No private data, static functions find their instance from thisObject.
+  prototypeObject = JSObjectMake(ctx, prototypeClass, nullptr);
+  JSValueProtect(ctx, prototypeObject);
+}
+
 HostClass::Instance::Instance(HostClass *hostClass)
   : _hostClass(hostClass), context(_hostClass->context), ctx(_hostClass->ctx), contextId(_hostClass->contextId) {
   object = JSObjectMake(hostClass->ctx, hostClass->instanceClass, this);
+  if (hostClass->_prototypeClass != nullptr) JSObjectSetPrototype(ctx, object, hostClass->prototypeObject);
 }
 
 JSValueRef HostClass::Instance::getProperty(std::string &name, JSValueRef *exception) {
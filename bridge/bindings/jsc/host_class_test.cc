@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "bindings/jsc/host_class.h"
+#include "bindings/jsc/js_context_internal.h"
+
+using namespace kraken::binding::jsc;
+
+namespace {
+
+class TestHostClass : public HostClass {
+public:
+  explicit TestHostClass(JSContext *context) : HostClass(context, "TestHostClass") {}
+
+  JSObjectRef instanceConstructor(JSContextRef ctx, JSObjectRef constructor, size_t argumentCount,
+                                  const JSValueRef *arguments, JSValueRef *exception) override {
+    auto instance = new Instance(this);
+    return instance->object;
+  }
+};
+
+JSValueRef returnThisPrivate(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                             const JSValueRef arguments[], JSValueRef *exception) {
+  return JSValueMakeBoolean(ctx, JSObjectGetPrivate(thisObject) != nullptr);
+}
+
+JSValueRef returnTrue(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                      const JSValueRef arguments[], JSValueRef *exception) {
+  return JSValueMakeBoolean(ctx, true);
+}
+
+const JSStaticFunction parentPrototypeFunctions[] = {{"hasPrivate", returnThisPrivate, kJSPropertyAttributeNone},
+                                                     {nullptr, nullptr, 0}};
+const JSStaticFunction childPrototypeFunctions[] = {{"childMethod", returnTrue, kJSPropertyAttributeNone},
+                                                    {nullptr, nullptr, 0}};
+
+class TestPrototypeHostClass : public TestHostClass {
+public:
+  explicit TestPrototypeHostClass(JSContext *context) : TestHostClass(context) {
+    JSClassRef parentClass = getPrototypeClassRef("TestParentPrototype", nullptr, parentPrototypeFunctions);
+    setPrototypeClass(getPrototypeClassRef("TestChildPrototype", parentClass, childPrototypeFunctions));
+  }
+};
+
+bool evaluateToBoolean(JSContext *context, const char *code) {
+  JSStringRef codeRef = JSStringCreateWithUTF8CString(code);
+  JSValueRef exception = nullptr;
+  JSValueRef result = JSEvaluateScript(context->context(), codeRef, nullptr, nullptr, 0, &exception);
+  JSStringRelease(codeRef);
+  EXPECT_EQ(exception, nullptr) << code;
+  return result != nullptr && JSValueToBoolean(context->context(), result);
+}
+
+} // namespace
+
+// Class refs are shared by every context of the process, disposing a context must not release them.
+TEST(HostClass, constructInstancesAfterContextIsRecreated) {
+  for (int round = 0; round < 3; round++) {
+    auto context = createJSContext(0, [](int32_t contextId, const char *errmsg) { ADD_FAILURE() << errmsg; },
+                                   nullptr);
+    auto hostClass = new TestHostClass(context.get());
+    JSStringRef name = JSStringCreateWithUTF8CString("TestHostClass");
+    JSObjectSetProperty(context->context(), context->global(), name, hostClass->classObject,
+                        kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+
+    EXPECT_TRUE(evaluateToBoolean(context.get(), "new TestHostClass() instanceof TestHostClass")) << "round " << round;
+    EXPECT_TRUE(evaluateToBoolean(context.get(), "var list = []; for (var i = 0; i < 1000; i++) "
+                                                 "list.push(new TestHostClass()); list.length === 1000"));
+
+    // Releasing the context finalizes the host class and every instance.
+    context.reset();
+  }
+}
+
+// Methods of static prototype tables are found by JSC on the prototype chain of instances, including the methods of
+// parent tables, and are created once per prototype.
+TEST(HostClass, resolveMethodsFromPrototypeClass) {
+  auto context = createJSContext(0, [](int32_t contextId, const char *errmsg) { ADD_FAILURE() << errmsg; }, nullptr);
+  auto hostClass = new TestPrototypeHostClass(context.get());
+  JSStringRef name = JSStringCreateWithUTF8CString("TestHostClass");
+  JSObjectSetProperty(context->context(), context->global(), name, hostClass->classObject, kJSPropertyAttributeNone,
+                      nullptr);
+  JSStringRelease(name);
+
+  EXPECT_TRUE(evaluateToBoolean(context.get(), "var a = new TestHostClass(); var b = new TestHostClass(); "
+                                               "a.childMethod() && a.hasPrivate()"));
+  EXPECT_TRUE(evaluateToBoolean(context.get(), "a.hasPrivate === b.hasPrivate && "
+                                               "a.childMethod === TestHostClass.prototype.childMethod"));
+  EXPECT_TRUE(evaluateToBoolean(context.get(), "TestHostClass.prototype.patched = function() { return true; }; "
+                                               "a.patched()"));
+  context.reset();
+}
@@ -5,22 +5,53 @@
 
 #include "host_object_internal.h"
 #include "foundation/logging.h"
+#include <mutex>
 
 namespace kraken::binding::jsc {
 
+namespace {
+// Host objects of the same name share one class definition, so short lived objects such as Touch and TouchList
+// reuse a JSClassRef instead of creating and releasing one per instance.
+std::mutex hostObjectClassMutex;
+std::unordered_map<std::string, JSClassRef> hostObjectClassMap;
+int64_t hostObjectClassCacheHits{0};
+int64_t hostObjectClassCacheMisses{0};
+
+JSClassRef getHostObjectClassRef(const std::string &name) {
+  std::lock_guard<std::mutex> guard(hostObjectClassMutex);
+  auto it = hostObjectClassMap.find(name);
+  if (it != hostObjectClassMap.end()) {
+    hostObjectClassCacheHits++;
+    return it->second;
+  }
+  hostObjectClassCacheMisses++;
+  JSClassDefinition hostObjectDefinition = kJSClassDefinitionEmpty;
+  JSC_CREATE_HOST_OBJECT_DEFINITION(hostObjectDefinition, name.c_str(), HostObject);
+  JSClassRef classRef = JSClassCreate(&hostObjectDefinition);
+  hostObjectClassMap[name] = classRef;
+  return classRef;
+}
+} // namespace
+
 HostObject::HostObject(JSContext *context, std::string name)
   : context(context), name(std::move(name)), ctx(context->context()), contextId(context->getContextId()) {
-  JSClassDefinition hostObjectDefinition = kJSClassDefinitionEmpty;
-  JSC_CREATE_HOST_OBJECT_DEFINITION(hostObjectDefinition, this->name.c_str(), HostObject);
-  jsClass = JSClassCreate(&hostObjectDefinition);
+  jsClass = getHostObjectClassRef(this->name);
+  JSClassRetain(jsClass);
   jsObject = JSObjectMake(context->context(), jsClass, this);
 }
 
+void HostObject::getClassCacheStats(int64_t *hits, int64_t *misses) {
+  std::lock_guard<std::mutex> guard(hostObjectClassMutex);
+  *hits = hostObjectClassCacheHits;
+  *misses = hostObjectClassCacheMisses;
+}
+
 JSValueRef HostObject::proxyGetProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName,
                                         JSValueRef *exception) {
   auto hostObject = static_cast<HostObject *>(JSObjectGetPrivate(object));
   auto &context = hostObject->context;
-  std::string name = JSStringToStdString(propertyName);
+  std::string nameStorage;
+  std::string &name = context->getPropertyName(propertyName, nameStorage);
   JSValueRef ret = hostObject->getProperty(name, exception);
   if (!context->handleException(*exception)) {
     return nullptr;
@@ -32,7 +63,8 @@ bool HostObject::proxySetProperty(JSContextRef ctx, JSObjectRef object, JSString
                                   JSValueRef *exception) {
   auto hostObject = static_cast<HostObject *>(JSObjectGetPrivate(object));
   auto &context = hostObject->context;
-  std::string &&name = JSStringToStdString(propertyName);
+  std::string nameStorage;
+  std::string &name = context->getPropertyName(propertyName, nameStorage);
   bool handledBySelf = hostObject->setProperty(name, value, exception);
   return !context->handleException(*exception) || handledBySelf;
 }
@@ -5,12 +5,29 @@
 
 #include "html_parser.h"
 #include "bindings/jsc/DOM/text_node.h"
+#include "bridge_jsc.h"
+#include "dart_methods.h"
+#include "foundation/trace_event.h"
+#include "foundation/utf_codec.h"
 #include "third_party/gumbo-parser/src/gumbo.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <unordered_map>
 #include <vector>
 
 namespace kraken::binding::jsc {
 
+namespace {
+std::atomic<uintptr_t> nextFrameToken{1};
+
+int64_t currentTimeMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+} // namespace
+
 std::unique_ptr<HTMLParser> createHTMLParser(std::unique_ptr<JSContext> &context, const JSExceptionHandler &handler, void *owner) {
   return std::make_unique<HTMLParser>(context, handler, owner);
 }
@@ -20,9 +37,15 @@ HTMLParser::HTMLParser(std::unique_ptr<JSContext> &context, const JSExceptionHan
 
 }
 
+HTMLParser::~HTMLParser() {
+  // The bridge is going away, nobody waits for its document any more.
+  m_notifyConstructed = false;
+  finishConstruction();
+}
+
 void HTMLParser::parseProperty(ElementInstance* element, GumboElement * gumboElement) {
   GumboVector * attributes = &gumboElement->attributes;
-  for (int j = 0; j < attributes->length; ++j) {
+  for (unsigned int j = 0; j < attributes->length; ++j) {
     GumboAttribute* attribute = (GumboAttribute*) attributes->data[j];
 
     if (strcmp(attribute->name, "style") == 0) {
@@ -77,51 +100,78 @@ void HTMLParser::parseProperty(ElementInstance* element, GumboElement * gumboEle
   }
 }
 
-void HTMLParser::traverseHTML(GumboNode * node, ElementInstance* element) {
-  const GumboVector* children = &node->v.element.children;
-  for (int i = 0; i < children->length; ++i) {
-    GumboNode* child = (GumboNode*) children->data[i];
+void HTMLParser::pushFrame(GumboNode *node, ElementInstance *element) {
+  // Keep the element alive while its children are pending, scripts may detach it between two slices.
+  element->refer();
+  m_stack.emplace_back(ConstructionFrame{node, element, 0});
+}
 
-    if (child->type == GUMBO_NODE_ELEMENT) {
-      std::string tagName = gumbo_normalized_tagname(child->v.element.tag);
-      auto newElement = JSElement::buildElementInstance(m_context.get(), tagName);
-      element->internalAppendChild(newElement);
-      parseProperty(newElement, &child->v.element);
+void HTMLParser::constructNode(ElementInstance *parent, GumboNode *node) {
+  m_stats.nodes++;
+  if (node->type == GUMBO_NODE_ELEMENT) {
+    std::string tagName = gumbo_normalized_tagname(node->v.element.tag);
+    auto newElement = JSElement::buildElementInstance(m_context.get(), tagName);
+    parent->internalAppendChild(newElement);
+    parseProperty(newElement, &node->v.element);
 
-      // eval javascript when <script>//code...</script>.
-      if (child->v.element.tag == GUMBO_TAG_SCRIPT && child->v.element.children.length > 0) {
-        JSStringRef jsCode = JSStringCreateWithUTF8CString(((GumboNode*) child->v.element.children.data[0])->v.text.text);
-        JSEvaluateScript(m_context->context(), jsCode, nullptr, nullptr, 0, nullptr);
+    // eval javascript when <script>//code...</script>.
+    // Avoid creating a large number of textNode in script Element.
+    if (node->v.element.tag == GUMBO_TAG_SCRIPT) {
+      if (node->v.element.children.length > 0) {
+        auto codeNode = (GumboNode *)node->v.element.children.data[0];
+        JSStringRef jsCode = JSStringCreateWithUTF8CString(codeNode->v.text.text);
+        JSValueRef exception = nullptr;
+        JSEvaluateScript(m_context->context(), jsCode, nullptr, nullptr, 0, &exception);
+        JSStringRelease(jsCode);
+        m_context->handleException(exception);
       }
+    } else if (node->v.element.children.length > 0) {
+      pushFrame(node, newElement);
+    }
+  } else if (node->type == GUMBO_NODE_TEXT) {
+    auto newTextNodeInstance = new JSTextNode::TextNodeInstance(JSTextNode::instance(m_context.get()),
+                                                                JSStringCreateWithUTF8CString(node->v.text.text));
+    parent->internalAppendChild(newTextNodeInstance);
+  }
+}
 
-      // Avoid creating a large number of textNode in script Element.
-      if (child->v.element.tag != GUMBO_TAG_SCRIPT) {
-        traverseHTML(child, newElement);
-      }
-    } else if (child->type == GUMBO_NODE_TEXT) {
-      auto newTextNodeInstance = new JSTextNode::TextNodeInstance(JSTextNode::instance(m_context.get()),
-                                                                  JSStringCreateWithUTF8CString(child->v.text.text));
-      element->internalAppendChild(newTextNodeInstance);
+bool HTMLParser::construct(int64_t budgetUs) {
+  KRAKEN_TRACE_EVENT("HTMLParser.construct", m_context->getContextId());
+  int64_t start = currentTimeMicros();
+  int64_t now = start;
+  while (!m_stack.empty() && m_context->isValid()) {
+    if (budgetUs >= 0 && now - start >= budgetUs) break;
+
+    ConstructionFrame &frame = m_stack.back();
+    if (frame.childIndex >= frame.node->v.element.children.length) {
+      frame.element->unrefer();
+      m_stack.pop_back();
+      continue;
     }
+    ElementInstance *parent = frame.element;
+    auto child = (GumboNode *)frame.node->v.element.children.data[frame.childIndex++];
+    // frame may move when the child pushes a frame of its own.
+    constructNode(parent, child);
+    now = currentTimeMicros();
   }
+
+  m_stats.slices++;
+  m_stats.maxSliceUs = std::max(m_stats.maxSliceUs, now - start);
+  return m_stack.empty() || !m_context->isValid();
 }
 
-bool HTMLParser::parseHTML(const uint16_t *code, size_t codeLength) {
+bool HTMLParser::beginConstruction(std::string &&source) {
+  KRAKEN_TRACE_EVENT("HTMLParser.parse", m_context->getContextId());
   // gumbo-parser parse HTML.
-  JSStringRef sourceRef = JSStringCreateWithCharacters(code, codeLength);
-  std::string html = JSStringToStdString(sourceRef);
-  int html_length = html.length();
-  GumboOutput* htmlTree = gumbo_parse_with_options(
-    &kGumboDefaultOptions, html.c_str(), html_length);
-
-  const GumboVector *root_children = &htmlTree->root->v.element.children;
+  m_parsedSource = std::move(source);
+  m_output = gumbo_parse_with_options(&kGumboDefaultOptions, m_parsedSource.c_str(), m_parsedSource.length());
 
   // find body.
-  ElementInstance* body;
+  ElementInstance *body = nullptr;
   auto document = DocumentInstance::instance(m_context.get());
-  for (int i = 0; i < document->documentElement->childNodes.size(); ++i) {
-    NodeInstance* node = document->documentElement->childNodes[i];
-    ElementInstance* element = reinterpret_cast<ElementInstance *>(node);
+  for (size_t i = 0; i < document->documentElement->childNodes.size(); ++i) {
+    NodeInstance *node = document->documentElement->childNodes[i];
+    ElementInstance *element = reinterpret_cast<ElementInstance *>(node);
 
     if (element->tagName() == "BODY") {
       body = element;
@@ -129,22 +179,143 @@ bool HTMLParser::parseHTML(const uint16_t *code, size_t codeLength) {
     }
   }
 
-  if (body != nullptr) {
-    for (int i = 0; i < root_children->length; ++i) {
-      GumboNode* child =(GumboNode*) root_children->data[i];
-      if (child->v.element.tag == GUMBO_TAG_BODY) {
-        traverseHTML(child, body);
-      }
+  if (body == nullptr) {
+    KRAKEN_LOG(ERROR) << "BODY is null.";
+    finishConstruction();
+    return false;
+  }
+
+  const GumboVector *root_children = &m_output->root->v.element.children;
+  for (unsigned int i = 0; i < root_children->length; ++i) {
+    GumboNode *child = (GumboNode *)root_children->data[i];
+    if (child->type == GUMBO_NODE_ELEMENT && child->v.element.tag == GUMBO_TAG_BODY) {
+      pushFrame(child, body);
+      break;
+    }
+  }
+  return true;
+}
+
+void HTMLParser::finishConstruction() {
+  if (m_context != nullptr && m_context->isValid()) {
+    for (auto &frame : m_stack) {
+      frame.element->unrefer();
     }
+  }
+  m_stack.clear();
+  if (m_output != nullptr) {
+    gumbo_destroy_output(&kGumboDefaultOptions, m_output);
+    m_output = nullptr;
+  }
+  m_parsedSource.clear();
+  m_parsedSource.shrink_to_fit();
+  // A frame armed for this document is ignored when it fires.
+  m_armedFrame = 0;
 
-    JSStringRelease(sourceRef);
-  } else {
-    KRAKEN_LOG(ERROR) << "BODY is null.";
+  if (m_notifyConstructed) {
+    m_notifyConstructed = false;
+    if (m_context != nullptr && m_context->isValid() && getDartMethod()->onHTMLConstructed != nullptr) {
+      getDartMethod()->onHTMLConstructed(m_context->getContextId());
+    }
   }
+}
 
+void HTMLParser::runSlice() {
+  if (!construct(SLICE_BUDGET_US)) {
+    if (arm()) return;
+    // Frames can not be requested without a dart controller, append the rest now.
+    construct(-1);
+  }
+  finishConstruction();
+}
+
+bool HTMLParser::arm() {
+  if (m_armedFrame != 0) return true;
+  m_armedFrame = nextFrameToken.fetch_add(1, std::memory_order_relaxed);
+  int32_t frameId = getDartMethod()->requestAnimationFrame(reinterpret_cast<void *>(m_armedFrame),
+                                                           m_context->getContextId(), handleFrame);
+  if (frameId == -1) {
+    m_armedFrame = 0;
+    return false;
+  }
   return true;
 }
 
+void HTMLParser::handleFrame(void *ptr, int32_t contextId, double highResTimeStamp, const char *errmsg) {
+  if (!checkContext(contextId)) return;
+  auto bridge = static_cast<JSBridge *>(getJSContext(contextId));
+  HTMLParser *parser = bridge->getHTMLParser();
+  // Frames requested for a finished document or by a reloaded bridge are ignored.
+  if (parser->m_armedFrame != reinterpret_cast<uintptr_t>(ptr)) return;
+  parser->m_armedFrame = 0;
+  if (!parser->m_context->isValid()) return;
+
+  if (errmsg != nullptr) {
+    KRAKEN_LOG(ERROR) << errmsg;
+  }
+
+  parser->runSlice();
+}
+
+void HTMLParser::appendSource(const uint16_t *chunk, size_t chunkLength, bool isFinal) {
+  auto units = reinterpret_cast<const char16_t *>(chunk);
+  std::u16string joined;
+  if (m_pendingHighSurrogate != 0) {
+    joined.reserve(chunkLength + 1);
+    joined += m_pendingHighSurrogate;
+    joined.append(units, chunkLength);
+    units = joined.data();
+    chunkLength = joined.length();
+    m_pendingHighSurrogate = 0;
+  }
+
+  // A surrogate pair split between two chunks is converted once its second half arrived.
+  if (!isFinal && chunkLength > 0 && units[chunkLength - 1] >= 0xD800 && units[chunkLength - 1] <= 0xDBFF) {
+    m_pendingHighSurrogate = units[chunkLength - 1];
+    chunkLength--;
+  }
+
+  if (m_source.empty()) {
+    ::foundation::utf16ToUTF8(units, chunkLength, m_source);
+  } else {
+    std::string converted;
+    ::foundation::utf16ToUTF8(units, chunkLength, converted);
+    m_source += converted;
+  }
+}
+
+bool HTMLParser::parseHTMLChunk(const uint16_t *chunk, size_t chunkLength, bool isFinal) {
+  appendSource(chunk, chunkLength, isFinal);
+  if (!isFinal) return true;
+
+  // Nodes of the previous document come first, complete it before the next one is appended.
+  if (isConstructing()) {
+    construct(-1);
+    // Dart waits for the documents of a context together, the completion of the next one is reported instead.
+    m_notifyConstructed = false;
+    finishConstruction();
+  }
+
+  std::string source;
+  source.swap(m_source);
+  m_notifyConstructed = true;
+  if (!beginConstruction(std::move(source))) return false;
+  runSlice();
+  return true;
 }
 
+bool HTMLParser::parseHTML(const uint16_t *code, size_t codeLength) {
+  if (isConstructing()) {
+    construct(-1);
+    finishConstruction();
+  }
+
+  std::string html;
+  ::foundation::utf16ToUTF8(reinterpret_cast<const char16_t *>(code), codeLength, html);
+  if (!beginConstruction(std::move(html))) return false;
+  construct(-1);
+  finishConstruction();
+  return true;
+}
 
+} // namespace kraken::binding::jsc
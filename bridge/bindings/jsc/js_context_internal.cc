@@ -8,6 +8,8 @@
 #include "bindings/jsc/kraken.h"
 #include "bindings/jsc/KOM/performance.h"
 #include "dart_methods.h"
+#include "foundation/trace_event.h"
+#include "script_cache.h"
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -20,23 +22,87 @@ std::vector<JSStaticValue> JSContext::globalValue{};
 
 static std::atomic<int32_t> context_unique_id{0};
 
-JSContext::JSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner)
-  : contextId(contextId), _handler(handler), owner(owner), ctxInvalid_(false), uniqueId(context_unique_id++) {
+namespace {
+// Contexts a thread creates while the shared group is enabled live in one JSContextGroupRef, sharing its VM, heap,
+// JIT code and GC.
+struct SharedContextGroup {
+  JSContextGroupRef group{nullptr};
+  int32_t liveContexts{0};
+  // Objects of a released context are finalized by some later collection of the shared heap, and their finalizers
+  // still reach the JSContext wrapper and use its address as instanceMap key. Wrappers are therefore kept, so their
+  // addresses can't be reused by a new context, until the last context of the group is released.
+  std::vector<std::unique_ptr<JSContext>> retiredContexts;
+};
+thread_local SharedContextGroup sharedContextGroup;
+std::atomic<bool> sharedContextGroupEnabled{false};
+// Lets global object callbacks, which only receive the JSContextRef, find the context.
+thread_local std::unordered_map<JSGlobalContextRef, JSContext *> contextByGlobalContext;
+} // namespace
+
+void setSharedContextGroupEnabled(bool enabled) {
+  sharedContextGroupEnabled = enabled;
+}
+
+bool isSharedContextGroupEnabled() {
+  return sharedContextGroupEnabled;
+}
+
+void disposeJSContext(std::unique_ptr<JSContext> &context) {
+  if (context == nullptr) return;
+  if (!context->isInSharedGroup()) {
+    context.reset();
+    return;
+  }
+
+  context->ctxInvalid_ = true;
+  contextByGlobalContext.erase(context->ctx_);
+  JSGlobalContextRelease(context->ctx_);
+  context->m_propertyNames.clear();
+
+  SharedContextGroup &shared = sharedContextGroup;
+  shared.retiredContexts.emplace_back(std::move(context));
+  if (--shared.liveContexts > 0) return;
+
+  // Releasing the group destroys the VM, which finalizes every remaining object before the wrappers go away.
+  ScriptCache::instance()->purge(shared.group);
+  JSContextGroupRelease(shared.group);
+  shared.group = nullptr;
+  shared.retiredContexts.clear();
+}
+
+JSContext::JSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner,
+                     const JSStaticValue *lazyGlobalValues)
+  : contextId(contextId), _handler(handler), owner(owner), ctxInvalid_(false), uniqueId(context_unique_id++),
+    m_uiCommandBuffer(foundation::UICommandBuffer::instance(contextId)) {
 
   JSClassDefinition contextDefinition = kJSClassDefinitionEmpty;
 
   const JSStaticFunction functionEnd = {nullptr};
   const JSStaticValue valueEnd = {nullptr};
 
-  globalFunctions.emplace_back(functionEnd);
-  globalValue.emplace_back(valueEnd);
+  // JSClassCreate copies the tables, the vectors only need to outlive it.
+  std::vector<JSStaticFunction> staticFunctions(globalFunctions);
+  staticFunctions.emplace_back(functionEnd);
+  std::vector<JSStaticValue> staticValues(globalValue);
+  for (auto value = lazyGlobalValues; value != nullptr && value->name != nullptr; value++) {
+    staticValues.emplace_back(*value);
+  }
+  staticValues.emplace_back(valueEnd);
 
-  contextDefinition.staticFunctions = globalFunctions.data();
-  contextDefinition.staticValues = globalValue.data();
+  contextDefinition.staticFunctions = staticFunctions.data();
+  contextDefinition.staticValues = staticValues.data();
 
   JSClassRef contextClass = JSClassCreate(&contextDefinition);
 
-  ctx_ = JSGlobalContextCreateInGroup(nullptr, contextClass);
+  JSContextGroupRef group = nullptr;
+  if (sharedContextGroupEnabled) {
+    if (sharedContextGroup.group == nullptr) sharedContextGroup.group = JSContextGroupCreate();
+    sharedContextGroup.liveContexts++;
+    group = sharedContextGroup.group;
+    m_sharedGroup = true;
+  }
+  ctx_ = JSGlobalContextCreateInGroup(group, contextClass);
+  contextByGlobalContext[ctx_] = this;
 
   JSObjectRef global = JSContextGetGlobalObject(ctx_);
 
@@ -52,36 +118,87 @@ JSContext::JSContext(int32_t contextId, const JSExceptionHandler &handler, void
 }
 
 JSContext::~JSContext() {
+  // Contexts of the shared group are released by disposeJSContext.
+  if (ctxInvalid_) return;
   ctxInvalid_ = true;
+  contextByGlobalContext.erase(ctx_);
   JSGlobalContextRelease(ctx_);
 }
 
-bool JSContext::evaluateJavaScript(const uint16_t *code, size_t codeLength, const char *sourceURL, int startLine) {
-  JSStringRef sourceRef = JSStringCreateWithCharacters(code, codeLength);
-  JSStringRef sourceURLRef = nullptr;
-  if (sourceURL != nullptr) {
-    sourceURLRef = JSStringCreateWithUTF8CString(sourceURL);
+JSContext *JSContext::fromGlobalContext(JSContextRef ctx) {
+  auto it = contextByGlobalContext.find(JSContextGetGlobalContext(ctx));
+  return it == contextByGlobalContext.end() ? nullptr : it->second;
+}
+
+namespace {
+bool propertyNameCacheEnabled = true;
+} // namespace
+
+void setPropertyNameCacheEnabled(bool enabled) {
+  propertyNameCacheEnabled = enabled;
+}
+
+std::string &JSContext::getPropertyName(JSStringRef propertyName, std::string &storage) {
+  if (!propertyNameCacheEnabled) {
+    storage = JSStringToStdString(propertyName);
+    return storage;
   }
 
-  JSValueRef exc = nullptr; // exception
-  JSEvaluateScript(ctx_, sourceRef, nullptr /*null means global*/, sourceURLRef, startLine, &exc);
+  // Property names are short in most cases, convert them on stack to avoid heap allocation on cache hit.
+  char stackBuffer[128];
+  size_t maxBufferSize = JSStringGetMaximumUTF8CStringSize(propertyName);
+  std::vector<char> heapBuffer;
+  char *buffer = stackBuffer;
+  if (maxBufferSize > sizeof(stackBuffer)) {
+    heapBuffer.resize(maxBufferSize);
+    buffer = heapBuffer.data();
+  }
+  // Returned size includes the null-terminator.
+  size_t size = JSStringGetUTF8CString(propertyName, buffer, maxBufferSize) - 1;
+  std::string_view key(buffer, size);
 
-  JSStringRelease(sourceRef);
-  if (sourceURLRef) {
-    JSStringRelease(sourceURLRef);
+  auto it = m_propertyNames.find(key);
+  if (it != m_propertyNames.end()) return *it->second;
+
+  if (m_propertyNames.size() >= MAX_PROPERTY_NAME_CACHE_SIZE) {
+    storage.assign(buffer, size);
+    return storage;
   }
 
-  return handleException(exc);
+  auto name = std::make_unique<std::string>(buffer, size);
+  std::string &result = *name;
+  m_propertyNames.emplace(std::string_view(result), std::move(name));
+  return result;
+}
+
+EventPayloadPool *JSContext::eventPayloadPool() {
+  if (m_eventPayloadPool == nullptr) m_eventPayloadPool = std::make_unique<EventPayloadPool>();
+  return m_eventPayloadPool.get();
+}
+
+EventTypeAtoms *JSContext::eventTypeAtoms() {
+  if (m_eventTypeAtoms == nullptr) m_eventTypeAtoms = std::make_unique<EventTypeAtoms>();
+  return m_eventTypeAtoms.get();
+}
+
+bool JSContext::evaluateJavaScript(const uint16_t *code, size_t codeLength, const char *sourceURL, int startLine) {
+  return evaluateJavaScript(reinterpret_cast<const char16_t *>(code), codeLength, sourceURL, startLine);
 }
 
 bool JSContext::evaluateJavaScript(const char16_t *code, size_t length, const char *sourceURL, int startLine) {
+  JSValueRef exc = nullptr; // exception
+  // Parsed scripts can only be shared by contexts of the same VM.
+  if (m_sharedGroup) {
+    ScriptCache::instance()->evaluate(ctx_, code, length, sourceURL, startLine, &exc);
+    return handleException(exc);
+  }
+
   JSStringRef sourceRef = JSStringCreateWithCharacters(reinterpret_cast<const JSChar *>(code), length);
   JSStringRef sourceURLRef = nullptr;
   if (sourceURL != nullptr) {
     sourceURLRef = JSStringCreateWithUTF8CString(sourceURL);
   }
 
-  JSValueRef exc = nullptr; // exception
   JSEvaluateScript(ctx_, sourceRef, nullptr /*null means global*/, sourceURLRef, startLine, &exc);
 
   JSStringRelease(sourceRef);
@@ -96,6 +213,10 @@ bool JSContext::isValid() {
   return !ctxInvalid_;
 }
 
+bool JSContext::isInSharedGroup() {
+  return m_sharedGroup;
+}
+
 int32_t JSContext::getContextId() {
   assert(!ctxInvalid_ && "context has been released");
   return contextId;
@@ -134,31 +255,78 @@ void throwJSError(JSContextRef ctx, const char *msg, JSValueRef *exception) {
   JSStringRelease(_errmsg);
 }
 
-std::unique_ptr<JSContext> createJSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner) {
-  return std::make_unique<JSContext>(contextId, handler, owner);
+std::unique_ptr<JSContext> createJSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner,
+                                           const JSStaticValue *lazyGlobalValues) {
+  return std::make_unique<JSContext>(contextId, handler, owner, lazyGlobalValues);
 }
 
 std::string JSStringToStdString(JSStringRef jsString) {
-  size_t maxBufferSize = JSStringGetMaximumUTF8CStringSize(jsString);
-  std::vector<char> buffer(maxBufferSize);
-  JSStringGetUTF8CString(jsString, buffer.data(), maxBufferSize);
-  return std::string(buffer.data());
+  std::string result;
+  foundation::utf16ToUTF8(reinterpret_cast<const char16_t *>(JSStringGetCharactersPtr(jsString)),
+                          JSStringGetLength(jsString), result);
+  return result;
 }
 
-JSObjectRef makeObjectFunctionWithPrivateData(JSContext *context, void *data, const char *name,
-                                              JSObjectCallAsFunctionCallback callback) {
+namespace {
+// JSClassRef is not bound to any context, function classes are created once per (callback, name) and shared
+// by all contexts.
+struct FunctionClassKey {
+  JSObjectCallAsFunctionCallback callback;
+  std::string name;
+  bool operator==(const FunctionClassKey &other) const {
+    return callback == other.callback && name == other.name;
+  }
+};
+struct FunctionClassKeyHash {
+  size_t operator()(const FunctionClassKey &key) const {
+    return std::hash<void *>()(reinterpret_cast<void *>(key.callback)) ^ std::hash<std::string>()(key.name);
+  }
+};
+std::mutex functionClassMutex;
+std::unordered_map<FunctionClassKey, JSClassRef, FunctionClassKeyHash> functionClassMap;
+bool functionClassCacheEnabled = true;
+
+JSClassRef createFunctionClass(const char *name, JSObjectCallAsFunctionCallback callback) {
   JSClassDefinition functionDefinition = kJSClassDefinitionEmpty;
   functionDefinition.className = name;
   functionDefinition.callAsFunction = callback;
   functionDefinition.version = 0;
-  JSClassRef functionClass = JSClassCreate(&functionDefinition);
-  return JSObjectMake(context->context(), functionClass, data);
+  return JSClassCreate(&functionDefinition);
+}
+
+JSClassRef getFunctionClass(const char *name, JSObjectCallAsFunctionCallback callback) {
+  std::lock_guard<std::mutex> guard(functionClassMutex);
+  FunctionClassKey key{callback, name};
+  auto it = functionClassMap.find(key);
+  if (it != functionClassMap.end()) return it->second;
+
+  JSClassRef functionClass = createFunctionClass(name, callback);
+  functionClassMap[std::move(key)] = functionClass;
+  return functionClass;
+}
+} // namespace
+
+void setFunctionClassCacheEnabled(bool enabled) {
+  functionClassCacheEnabled = enabled;
+}
+
+JSObjectRef makeObjectFunctionWithPrivateData(JSContext *context, void *data, const char *name,
+                                              JSObjectCallAsFunctionCallback callback) {
+  if (!functionClassCacheEnabled) {
+    // A class per function, the object keeps it alive.
+    JSClassRef functionClass = createFunctionClass(name, callback);
+    JSObjectRef function = JSObjectMake(context->context(), functionClass, data);
+    JSClassRelease(functionClass);
+    return function;
+  }
+  return JSObjectMake(context->context(), getFunctionClass(name, callback), data);
 }
 
 JSObjectRef JSObjectMakePromise(JSContext *context, void *data, JSObjectCallAsFunctionCallback callback,
                                 JSValueRef *exception) {
+  static JSStringRef promiseStringRef = JSStringCreateWithUTF8CString("Promise");
   JSValueRef promiseConstructorValueRef =
-    JSObjectGetProperty(context->context(), context->global(), JSStringCreateWithUTF8CString("Promise"), exception);
+    JSObjectGetProperty(context->context(), context->global(), promiseStringRef, exception);
   JSObjectRef promiseConstructor = JSValueToObject(context->context(), promiseConstructorValueRef, exception);
 
   JSObjectRef functionArgs = makeObjectFunctionWithPrivateData(context, data, "P", callback);
@@ -168,60 +336,48 @@ JSObjectRef JSObjectMakePromise(JSContext *context, void *data, JSObjectCallAsFu
 }
 
 namespace {
-const JSChar *cloneString(const JSChar *string, size_t length) {
-  auto *newString = new JSChar[length];
-  for (size_t i = 0; i < length; i++) {
-    newString[i] = string[i];
-  }
-  return newString;
-};
+// UI command arguments only need to live until UICommandBuffer::addCommand copied them into the frame arena,
+// so we convert them into reusable scratch buffers instead of allocating new strings for every command.
+thread_local std::u16string keyScratch;
+thread_local std::u16string valueScratch;
+thread_local std::u16string holderScratch;
+
+void convertToScratch(std::string &string, std::u16string &scratch, NativeString &args) {
+  foundation::utf8ToUTF16(string.data(), string.length(), scratch);
+  args.string = reinterpret_cast<const uint16_t *>(scratch.data());
+  args.length = scratch.length();
+}
 } // namespace
 
 void buildUICommandArgs(JSStringRef key, NativeString &args_01) {
   args_01.length = JSStringGetLength(key);
-  args_01.string = cloneString(JSStringGetCharactersPtr(key), args_01.length);
+  args_01.string = JSStringGetCharactersPtr(key);
 }
 
 void buildUICommandArgs(std::string &key, NativeString &args_01) {
-  JSStringRef keyStringRef = JSStringCreateWithUTF8CString(key.c_str());
-  args_01.length = JSStringGetLength(keyStringRef);
-  args_01.string = cloneString(JSStringGetCharactersPtr(keyStringRef), args_01.length);
-  JSStringRelease(keyStringRef);
+  convertToScratch(key, keyScratch, args_01);
 }
 
 void buildUICommandArgs(std::string &key, JSStringRef value, NativeString &args_01, NativeString &args_02) {
-  JSStringRef keyStringRef = JSStringCreateWithUTF8CString(key.c_str());
-
-  args_01.length = JSStringGetLength(keyStringRef);
-  args_01.string = cloneString(JSStringGetCharactersPtr(keyStringRef), args_01.length);
+  convertToScratch(key, keyScratch, args_01);
 
   args_02.length = JSStringGetLength(value);
-  args_02.string = cloneString(JSStringGetCharactersPtr(value), args_02.length);
-
-  JSStringRelease(keyStringRef);
+  args_02.string = JSStringGetCharactersPtr(value);
 }
 
 void buildUICommandArgs(std::string &key, std::string &value, NativeString &args_01, NativeString &args_02) {
-  JSStringRef keyStringRef = JSStringCreateWithUTF8CString(key.c_str());
-  JSStringRef valueStringRef = JSStringCreateWithUTF8CString(value.c_str());
-
-  args_01.length = JSStringGetLength(keyStringRef);
-  args_01.string = cloneString(JSStringGetCharactersPtr(keyStringRef), args_01.length);
-
-  args_02.length = JSStringGetLength(valueStringRef);
-  args_02.string = cloneString(JSStringGetCharactersPtr(valueStringRef), args_02.length);
-
-  JSStringRelease(keyStringRef);
-  JSStringRelease(valueStringRef);
+  convertToScratch(key, keyScratch, args_01);
+  convertToScratch(value, valueScratch, args_02);
 }
 
 NativeString *stringToNativeString(std::string &string) {
-  std::u16string utf16;
-  fromUTF8(string, utf16);
-  NativeString tmp{};
-  tmp.string = reinterpret_cast<const uint16_t *>(utf16.c_str());
-  tmp.length = utf16.size();
-  return tmp.clone();
+  // UTF-16 never needs more code units than UTF-8 bytes, so decode straight into the returned buffer.
+  auto *buffer = new uint16_t[string.length()];
+  auto *nativeString = new NativeString();
+  nativeString->string = buffer;
+  nativeString->length =
+    foundation::utf8ToUTF16(string.data(), string.length(), reinterpret_cast<char16_t *>(buffer));
+  return nativeString;
 }
 
 NativeString *stringRefToNativeString(JSStringRef string) {
@@ -232,33 +388,18 @@ NativeString *stringRefToNativeString(JSStringRef string) {
 }
 
 #if ENABLE_PROFILE
-std::unordered_map<std::string, double> m_f_call_time;
-std::unordered_map<std::string, int> m_f_call_count;
-std::unordered_map<std::string, double> *getNativeFunctionCallTime() {
-  return &m_f_call_time;
-}
-std::unordered_map<std::string, int> *getNativeFunctionCallCount() {
-  return &m_f_call_count;
-}
-
 struct ProxyContext {
-  std::string name;
+  const char *name{nullptr};
   JSObjectRef function{nullptr};
+  int32_t contextId{-1};
 };
 JSValueRef proxyFunctionCall(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
                                  const JSValueRef *arguments, JSValueRef *exception) {
   auto *proxyContext = reinterpret_cast<ProxyContext*>(JSObjectGetPrivate(function));
+  foundation::TraceScope trace("NativeFunction.call", proxyContext->contextId, proxyContext->name);
   auto nativePerformance = binding::jsc::NativePerformance::instance(0);
   nativePerformance->mark(PERF_JS_NATIVE_FUNCTION_CALL_START);
-  double startTime = std::chrono::system_clock::now().time_since_epoch().count();
   JSValueRef value = JSObjectCallAsFunction(ctx, proxyContext->function, thisObject, argumentCount, arguments, exception);
-  double endTime = std::chrono::system_clock::now().time_since_epoch().count();
-  if (m_f_call_time.count(proxyContext->name) == 0) {
-    m_f_call_time[proxyContext->name] = 0.0;
-    m_f_call_count[proxyContext->name] = 0;
-  }
-  m_f_call_time[proxyContext->name] += ((endTime - startTime) / 1000);
-  m_f_call_count[proxyContext->name]++;
   nativePerformance->mark(PERF_JS_NATIVE_FUNCTION_CALL_END);
   return value;
 }
@@ -277,8 +418,9 @@ JSFunctionHolder::JSFunctionHolder(JSContext *context, JSObjectRef root, void *d
 #if ENABLE_PROFILE
   JSValueProtect(context->context(), m_function);
   auto *proxyContext = new ProxyContext();
-  proxyContext->name = name;
+  proxyContext->name = foundation::TraceLog::internString(name);
   proxyContext->function = m_function;
+  proxyContext->contextId = context->getContextId();
   m_function = makeObjectFunctionWithPrivateData(context, proxyContext, name.c_str(), proxyFunctionCall);
   JSObjectSetProperty(context->context(), root, nameStringHolder.getString(), m_function, kJSPropertyAttributeNone, nullptr);
 #else
@@ -290,8 +432,11 @@ JSObjectRef JSFunctionHolder::function() {
   return m_function;
 }
 
-JSStringHolder::JSStringHolder(JSContext *context, const std::string &string)
-  : m_context(context), m_string(JSStringRetain(JSStringCreateWithUTF8CString(string.c_str()))) {}
+JSStringHolder::JSStringHolder(JSContext *context, const std::string &string) : m_context(context) {
+  foundation::utf8ToUTF16(string.data(), string.length(), holderScratch);
+  m_string =
+    JSStringCreateWithCharacters(reinterpret_cast<const JSChar *>(holderScratch.data()), holderScratch.length());
+}
 
 JSStringHolder::~JSStringHolder() {
   if (m_string != nullptr) JSStringRelease(m_string);
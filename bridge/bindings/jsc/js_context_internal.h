@@ -7,9 +7,8 @@
 #define KRAKENBRIDGE_JS_CONTEXT_INTERNAL_H
 
 #include "include/kraken_bridge.h"
+#include "foundation/utf_codec.h"
 #include <chrono>
-#include <codecvt>
-#include <locale>
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -49,19 +48,19 @@ inline bool objectHasProperty(JSContextRef ctx, const std::string key, JSObjectR
   return result;
 }
 
-template <typename T> std::string toUTF8(const std::basic_string<T, std::char_traits<T>, std::allocator<T>> &source) {
-  std::string result;
-
-  std::wstring_convert<std::codecvt_utf8_utf16<T>, T> convertor;
-  result = convertor.to_bytes(source);
+inline std::string toUTF8(const std::u16string &source) {
+  return foundation::utf16ToUTF8(source);
+}
 
-  return result;
+inline void fromUTF8(const std::string &source, std::u16string &result) {
+  foundation::utf8ToUTF16(source.data(), source.length(), result);
 }
 
+// Getter of a global constructor for createJSContext's lazyGlobalValues, the host class is created on first lookup.
 template <typename T>
-void fromUTF8(const std::string &source, std::basic_string<T, std::char_traits<T>, std::allocator<T>> &result) {
-  std::wstring_convert<std::codecvt_utf8_utf16<T>, T> convertor;
-  result = convertor.from_bytes(source);
+JSValueRef lazyGlobalConstructor(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName,
+                                 JSValueRef *exception) {
+  return T::instance(JSContext::fromGlobalContext(ctx))->classObject;
 }
 
 inline std::string trim(std::string &str) {
@@ -70,12 +69,17 @@ inline std::string trim(std::string &str) {
   return str;
 }
 
-std::unique_ptr<JSContext> createJSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner);
-
-#if ENABLE_PROFILE
-std::unordered_map<std::string, double> *getNativeFunctionCallTime();
-std::unordered_map<std::string, int> *getNativeFunctionCallCount();
-#endif
+// lazyGlobalValues is a table of global properties, terminated by an entry with a null name, whose getters are
+// called on every lookup instead of storing the value at creation.
+std::unique_ptr<JSContext> createJSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner,
+                                           const JSStaticValue *lazyGlobalValues = nullptr);
+// Release a context created by createJSContext. Contexts of the shared group stay reachable for finalizers until
+// the last context of their group is disposed.
+void disposeJSContext(std::unique_ptr<JSContext> &context);
+
+// When enabled, contexts created afterwards on a thread share one JSContextGroupRef instead of getting a VM each.
+void setSharedContextGroupEnabled(bool enabled);
+bool isSharedContextGroupEnabled();
 
 } // namespace kraken::binding::jsc
 
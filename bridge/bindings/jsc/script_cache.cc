@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "script_cache.h"
+#include "foundation/trace_event.h"
+#include <cstring>
+
+// Weak, so engines built without the JSScript API still load and fall back to JSEvaluateScript.
+extern "C" {
+__attribute__((weak)) JSScriptRef JSScriptCreateFromString(JSContextGroupRef contextGroup, JSStringRef url,
+                                                           int startingLineNumber, JSStringRef source,
+                                                           JSStringRef *errorMessage, int *errorLine);
+__attribute__((weak)) void JSScriptRelease(JSScriptRef script);
+__attribute__((weak)) JSValueRef JSScriptEvaluate(JSContextRef ctx, JSScriptRef script, JSValueRef thisValue,
+                                                  JSValueRef *exception);
+}
+
+namespace kraken::binding::jsc {
+
+namespace {
+
+constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// 64 bit content hash, 8 bytes per step. Large bundles are hashed in well under a millisecond per megabyte.
+uint64_t hashContent(const char16_t *code, size_t length) {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(code);
+  size_t byteLength = length * sizeof(char16_t);
+  uint64_t hash = PRIME_2 ^ (byteLength * PRIME_1);
+  size_t i = 0;
+  for (; i + 8 <= byteLength; i += 8) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash ^= rotateLeft(word * PRIME_2, 31) * PRIME_1;
+    hash = rotateLeft(hash, 27) * PRIME_1 + PRIME_2;
+  }
+  for (; i < byteLength; i++) {
+    hash ^= bytes[i] * PRIME_1;
+    hash = rotateLeft(hash, 11) * PRIME_2;
+  }
+  hash ^= hash >> 33;
+  hash *= PRIME_2;
+  hash ^= hash >> 29;
+  return hash;
+}
+
+void evaluateUncached(JSGlobalContextRef ctx, const char16_t *code, size_t length, const char *sourceURL,
+                      int startLine, JSValueRef *exception) {
+  JSStringRef sourceRef = JSStringCreateWithCharacters(reinterpret_cast<const JSChar *>(code), length);
+  JSStringRef sourceURLRef = nullptr;
+  if (sourceURL != nullptr) {
+    sourceURLRef = JSStringCreateWithUTF8CString(sourceURL);
+  }
+
+  JSEvaluateScript(ctx, sourceRef, nullptr /*null means global*/, sourceURLRef, startLine, exception);
+
+  JSStringRelease(sourceRef);
+  if (sourceURLRef) {
+    JSStringRelease(sourceURLRef);
+  }
+}
+
+} // namespace
+
+bool ScriptCache::Key::operator==(const Key &other) const {
+  return group == other.group && hash == other.hash && length == other.length && startLine == other.startLine &&
+         sourceURL == other.sourceURL;
+}
+
+size_t ScriptCache::KeyHash::operator()(const Key &key) const {
+  return static_cast<size_t>(key.hash) ^ std::hash<const void *>()(key.group) ^
+         std::hash<std::string>()(key.sourceURL);
+}
+
+ScriptCache *ScriptCache::instance() {
+  static thread_local ScriptCache cache;
+  return &cache;
+}
+
+bool ScriptCache::isAvailable() {
+  return JSScriptCreateFromString != nullptr && JSScriptEvaluate != nullptr && JSScriptRelease != nullptr;
+}
+
+void ScriptCache::evaluate(JSGlobalContextRef ctx, const char16_t *code, size_t length, const char *sourceURL,
+                           int startLine, JSValueRef *exception) {
+  if (length < MIN_CACHED_LENGTH || !isAvailable()) {
+    evaluateUncached(ctx, code, length, sourceURL, startLine, exception);
+    return;
+  }
+
+  KRAKEN_TRACE_EVENT("ScriptCache.evaluate", -1);
+  Key key{JSContextGetGroup(ctx), hashContent(code, length), length, startLine,
+          sourceURL == nullptr ? std::string() : std::string(sourceURL)};
+
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    Entry &entry = *it->second;
+    if (memcmp(entry.source.data(), code, length * sizeof(char16_t)) == 0) {
+      m_stats.hits++;
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      JSScriptEvaluate(ctx, entry.script, nullptr, exception);
+      return;
+    }
+
+    // Another source with the same hash, keep the cached one and parse this one every time.
+    m_stats.misses++;
+    evaluateUncached(ctx, code, length, sourceURL, startLine, exception);
+    return;
+  }
+
+  m_stats.misses++;
+  JSStringRef sourceRef = JSStringCreateWithCharacters(reinterpret_cast<const JSChar *>(code), length);
+  JSStringRef sourceURLRef = JSStringCreateWithUTF8CString(key.sourceURL.c_str());
+  JSScriptRef script = JSScriptCreateFromString(key.group, sourceURLRef, startLine, sourceRef, nullptr, nullptr);
+  JSStringRelease(sourceRef);
+  JSStringRelease(sourceURLRef);
+
+  // Syntax errors are not cached, evaluate again to raise them as regular exceptions.
+  if (script == nullptr) {
+    evaluateUncached(ctx, code, length, sourceURL, startLine, exception);
+    return;
+  }
+
+  m_entries.push_front(Entry{key, script, std::u16string(code, length)});
+  m_index[key] = m_entries.begin();
+  m_stats.entries++;
+  m_stats.bytes += length * sizeof(char16_t);
+  evict();
+
+  JSScriptEvaluate(ctx, script, nullptr, exception);
+}
+
+void ScriptCache::evict() {
+  // Keep the most recent entry even when it exceeds the budget alone, it is the one about to be evaluated.
+  while (m_stats.bytes > m_maxCachedBytes && m_entries.size() > 1) {
+    Entry &entry = m_entries.back();
+    m_stats.entries--;
+    m_stats.bytes -= entry.key.length * sizeof(char16_t);
+    JSScriptRelease(entry.script);
+    m_index.erase(entry.key);
+    m_entries.pop_back();
+  }
+}
+
+void ScriptCache::setMaxCachedBytes(size_t maxCachedBytes) {
+  m_maxCachedBytes = maxCachedBytes;
+  evict();
+}
+
+void ScriptCache::purge(JSContextGroupRef group) {
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (it->key.group != group) {
+      ++it;
+      continue;
+    }
+    m_stats.entries--;
+    m_stats.bytes -= it->key.length * sizeof(char16_t);
+    JSScriptRelease(it->script);
+    m_index.erase(it->key);
+    it = m_entries.erase(it);
+  }
+}
+
+} // namespace kraken::binding::jsc
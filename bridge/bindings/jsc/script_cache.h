@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_SCRIPT_CACHE_H
+#define KRAKENBRIDGE_SCRIPT_CACHE_H
+
+#include "include/kraken_bridge.h"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// From JavaScriptCore's private JSScriptRefPrivate.h, which is not part of the public headers.
+typedef struct OpaqueJSScript *JSScriptRef;
+
+namespace kraken::binding::jsc {
+
+// Pre-parsed scripts keyed by the hash of their content and verified against a copy of it, so the polyfill, plugins and app bundles evaluated by
+// every context of a shared context group are only parsed once per group. Scripts are bound to the VM of their
+// group, the cache lives on the thread which owns the groups.
+class ScriptCache {
+public:
+  // Scripts shorter than this are cheaper to parse again than to hash and look up.
+  static constexpr size_t MIN_CACHED_LENGTH = 1024;
+  // Default budget of cached source code kept alive by all entries, least recently used entries are released first.
+  static constexpr size_t MAX_CACHED_BYTES = 32 * 1024 * 1024;
+
+  struct Stats {
+    int64_t hits{0};
+    int64_t misses{0};
+    int64_t entries{0};
+    size_t bytes{0};
+  };
+
+  static ScriptCache *instance();
+  // Whether the engine exports the JSScript API, otherwise evaluate always parses the source.
+  static bool isAvailable();
+
+  // Evaluate code in ctx like JSEvaluateScript, reusing the parsed script of an earlier evaluation of the same
+  // source in the same group.
+  void evaluate(JSGlobalContextRef ctx, const char16_t *code, size_t length, const char *sourceURL, int startLine,
+                JSValueRef *exception);
+  // Release every script of group, must be called while the group is still alive.
+  void purge(JSContextGroupRef group);
+  // Lower the budget of cached source code, least recently used entries above it are released right away.
+  void setMaxCachedBytes(size_t maxCachedBytes);
+
+  const Stats &stats() const {
+    return m_stats;
+  }
+
+private:
+  struct Key {
+    JSContextGroupRef group;
+    uint64_t hash;
+    size_t length;
+    int startLine;
+    std::string sourceURL;
+    bool operator==(const Key &other) const;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+  struct Entry {
+    Key key;
+    JSScriptRef script;
+    // Compared on every hit, equal hashes alone never run another script.
+    std::u16string source;
+  };
+
+  void evict();
+
+  std::list<Entry> m_entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+  Stats m_stats;
+  size_t m_maxCachedBytes{MAX_CACHED_BYTES};
+};
+
+} // namespace kraken::binding::jsc
+
+#endif // KRAKENBRIDGE_SCRIPT_CACHE_H
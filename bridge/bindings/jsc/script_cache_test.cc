@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "bindings/jsc/js_context_internal.h"
+#include "bindings/jsc/script_cache.h"
+#include <algorithm>
+
+using namespace kraken::binding::jsc;
+
+namespace {
+
+// A script above ScriptCache::MIN_CACHED_LENGTH, distinct per name.
+std::u16string largeScript(const std::string &name) {
+  std::string code = "var " + name + " = 0;\n";
+  while (code.length() < ScriptCache::MIN_CACHED_LENGTH * 2) {
+    code += name + " += 1;\n";
+  }
+  return std::u16string(code.begin(), code.end());
+}
+
+class ScriptCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    if (!ScriptCache::isAvailable()) GTEST_SKIP() << "JavaScriptCore does not export the JSScript API.";
+    setSharedContextGroupEnabled(true);
+    auto handler = [](int32_t contextId, const char *errmsg) { ADD_FAILURE() << errmsg; };
+    m_first = createJSContext(0, handler, nullptr);
+    m_second = createJSContext(1, handler, nullptr);
+  }
+
+  void TearDown() override {
+    disposeJSContext(m_first);
+    disposeJSContext(m_second);
+    ScriptCache::instance()->setMaxCachedBytes(ScriptCache::MAX_CACHED_BYTES);
+    setSharedContextGroupEnabled(false);
+  }
+
+  void evaluate(JSContext *context, const std::u16string &code) {
+    EXPECT_TRUE(context->evaluateJavaScript(code.c_str(), code.length(), "script_cache_test.js", 0));
+  }
+
+  const ScriptCache::Stats &stats() {
+    return ScriptCache::instance()->stats();
+  }
+
+  std::unique_ptr<JSContext> m_first;
+  std::unique_ptr<JSContext> m_second;
+};
+
+} // namespace
+
+TEST_F(ScriptCacheTest, reuseScriptsAcrossContextsOfTheGroup) {
+  std::u16string script = largeScript("shared");
+  ScriptCache::Stats before = stats();
+
+  evaluate(m_first.get(), script);
+  EXPECT_EQ(stats().misses, before.misses + 1);
+  EXPECT_EQ(stats().hits, before.hits);
+
+  evaluate(m_second.get(), script);
+  EXPECT_EQ(stats().misses, before.misses + 1);
+  EXPECT_EQ(stats().hits, before.hits + 1);
+  EXPECT_EQ(stats().entries, before.entries + 1);
+
+  // Short scripts are never cached.
+  std::u16string shortScript = u"var small = 1;";
+  evaluate(m_first.get(), shortScript);
+  evaluate(m_second.get(), shortScript);
+  EXPECT_EQ(stats().hits, before.hits + 1);
+  EXPECT_EQ(stats().misses, before.misses + 1);
+}
+
+TEST_F(ScriptCacheTest, evictLeastRecentlyUsedScripts) {
+  std::u16string first = largeScript("first");
+  std::u16string second = largeScript("second");
+  std::u16string third = largeScript("third");
+  size_t scriptBytes = std::max({first.length(), second.length(), third.length()}) * sizeof(char16_t);
+  // Room for two of the scripts.
+  ScriptCache::instance()->setMaxCachedBytes(scriptBytes * 2 + scriptBytes / 2);
+
+  evaluate(m_first.get(), first);
+  evaluate(m_first.get(), second);
+  // Using first again makes second the least recently used entry.
+  evaluate(m_second.get(), first);
+  evaluate(m_first.get(), third);
+  EXPECT_EQ(stats().entries, 2);
+  EXPECT_LE(stats().bytes, scriptBytes * 2 + scriptBytes / 2);
+
+  ScriptCache::Stats before = stats();
+  evaluate(m_second.get(), first);
+  evaluate(m_second.get(), third);
+  EXPECT_EQ(stats().hits, before.hits + 2);
+  evaluate(m_second.get(), second);
+  EXPECT_EQ(stats().misses, before.misses + 1);
+}
+
+TEST_F(ScriptCacheTest, purgeScriptsWhenGroupIsReleased) {
+  ScriptCache::Stats before = stats();
+  evaluate(m_first.get(), largeScript("first"));
+  evaluate(m_second.get(), largeScript("second"));
+  EXPECT_EQ(stats().entries, before.entries + 2);
+
+  // The group lives until its last context is released.
+  disposeJSContext(m_first);
+  EXPECT_EQ(stats().entries, before.entries + 2);
+  disposeJSContext(m_second);
+  EXPECT_EQ(stats().entries, before.entries);
+  EXPECT_EQ(stats().bytes, before.bytes);
+}
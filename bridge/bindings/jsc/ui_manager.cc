@@ -44,11 +44,10 @@ JSValueRef krakenModuleListener(JSContextRef ctx, JSObjectRef function, JSObject
 
 void handleInvokeModuleTransientCallback(void *callbackContext, int32_t contextId, NativeString *errmsg,
                                          NativeString *json) {
-  auto *obj = static_cast<BridgeCallback::Context *>(callbackContext);
+  auto *obj = JSBridge::getCallbackContext(contextId, callbackContext);
+  if (obj == nullptr) return;
   JSContext &_context = obj->_context;
 
-  if (!checkContext(contextId, &_context)) return;
-
   if (!_context.isValid()) return;
 
   JSValueRef exception = nullptr;
@@ -84,7 +83,7 @@ void handleInvokeModuleTransientCallback(void *callbackContext, int32_t contextI
   _context.handleException(exception);
 
   auto bridge = static_cast<JSBridge *>(obj->_context.getOwner());
-  bridge->bridgeCallback->freeBridgeCallbackContext(obj);
+  bridge->bridgeCallback->freeBridgeCallbackContext(callbackContext);
 }
 
 void handleInvokeModuleUnexpectedCallback(void *callbackContext, int32_t contextId, NativeString *errmsg,
@@ -141,8 +140,8 @@ JSValueRef krakenInvokeModule(JSContextRef ctx, JSObjectRef function, JSObjectRe
   if (callbackValueRef != nullptr) {
     result = bridge->bridgeCallback->registerCallback<NativeString *>(
       std::move(callbackContext),
-      [moduleName, method, params](BridgeCallback::Context *bridgeContext, int32_t contextId) {
-        NativeString *response = getDartMethod()->invokeModule(bridgeContext, contextId, moduleName, method, params,
+      [moduleName, method, params](BridgeCallback::Handle callbackHandle, int32_t contextId) {
+        NativeString *response = getDartMethod()->invokeModule(callbackHandle, contextId, moduleName, method, params,
                                                                handleInvokeModuleTransientCallback);
         return response;
       });
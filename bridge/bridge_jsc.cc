@@ -7,6 +7,7 @@
 
 #include "bridge_jsc.h"
 #include "foundation/logging.h"
+#include "foundation/trace_event.h"
 #include "polyfill.h"
 
 #include "dart_methods.h"
@@ -54,6 +55,31 @@ using namespace binding::jsc;
 
 std::unordered_map<std::string, NativeString> JSBridge::pluginSourceCode {};
 ConsoleMessageHandler JSBridge::consoleMessageHandler {nullptr};
+bool JSBridge::lazyBinding {true};
+
+namespace {
+
+const JSStaticValue lazyGlobalConstructors[] = {
+  {"CustomEvent", lazyGlobalConstructor<JSCustomEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"MouseEvent", lazyGlobalConstructor<JSMouseEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"CloseEvent", lazyGlobalConstructor<JSCloseEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"GestureEvent", lazyGlobalConstructor<JSGestureEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"MediaErrorEvent", lazyGlobalConstructor<JSMediaErrorEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"TouchEvent", lazyGlobalConstructor<JSTouchEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"InputEvent", lazyGlobalConstructor<JSInputEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"IntersectionChangeEvent", lazyGlobalConstructor<JSIntersectionChangeEvent>, nullptr,
+   kJSPropertyAttributeReadOnly},
+  {"MessageEvent", lazyGlobalConstructor<JSMessageEvent>, nullptr, kJSPropertyAttributeReadOnly},
+  {"Text", lazyGlobalConstructor<JSTextNode>, nullptr, kJSPropertyAttributeReadOnly},
+  {"CommentNode", lazyGlobalConstructor<JSCommentNode>, nullptr, kJSPropertyAttributeReadOnly},
+  {"Image", lazyGlobalConstructor<JSImageElement>, nullptr, kJSPropertyAttributeReadOnly},
+  {"HTMLImageElement", lazyGlobalConstructor<JSImageElement>, nullptr, kJSPropertyAttributeReadOnly},
+  {"HTMLInputElement", lazyGlobalConstructor<JSInputElement>, nullptr, kJSPropertyAttributeReadOnly},
+  {"SVGElement", lazyGlobalConstructor<JSSVGElement>, nullptr, kJSPropertyAttributeReadOnly},
+  {"Blob", lazyGlobalConstructor<JSBlob>, nullptr, kJSPropertyAttributeReadOnly},
+  {nullptr, nullptr, nullptr, 0}};
+
+} // namespace
 
 /**
  * JSRuntime
@@ -69,11 +95,28 @@ JSBridge::JSBridge(int32_t contextId, const JSExceptionHandler &handler) : conte
   double jsContextStartTime =
     std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 #endif
+  const int64_t startTime = ::foundation::TraceLog::now();
+  int64_t phaseStartTime = startTime;
+  // Close the running phase, trace it when tracing is on and return its duration in microseconds.
+  auto finishPhase = [&phaseStartTime, contextId](const char *name) {
+    int64_t endTime = ::foundation::TraceLog::now();
+    if (::foundation::TraceLog::isEnabled()) {
+      ::foundation::TraceLog::addCompleteEvent(name, nullptr, contextId, phaseStartTime, endTime);
+    }
+    int64_t duration = (endTime - phaseStartTime) / 1000;
+    phaseStartTime = endTime;
+    return duration;
+  };
+
   bridgeCallback = new foundation::BridgeCallback();
 
-  m_context = binding::jsc::createJSContext(contextId, errorHandler, this);
+  m_context =
+    binding::jsc::createJSContext(contextId, errorHandler, this, lazyBinding ? lazyGlobalConstructors : nullptr);
+  timerQueue = new binding::jsc::TimerQueue(m_context.get());
+  animationFrameQueue = new binding::jsc::AnimationFrameQueue(m_context.get());
 
   m_html_parser = binding::jsc::createHTMLParser(m_context, errorHandler, this);
+  startupTiming.createContext = finishPhase("JSBridge.createContext");
 
 #if ENABLE_PROFILE
   auto nativePerformance = binding::jsc::NativePerformance::instance(m_context->uniqueId);
@@ -87,29 +130,33 @@ JSBridge::JSBridge(int32_t contextId, const JSExceptionHandler &handler) : conte
   bindUIManager(m_context);
   bindConsole(m_context);
   bindEvent(m_context);
-  bindMouseEvent(m_context);
-  bindCustomEvent(m_context);
-  bindCloseEvent(m_context);
-  bindGestureEvent(m_context);
-  bindMediaErrorEvent(m_context);
-  bindTouchEvent(m_context);
-  bindInputEvent(m_context);
-  bindIntersectionChangeEvent(m_context);
-  bindMessageEvent(m_context);
   bindEventTarget(m_context);
   bindDocument(m_context);
   bindNode(m_context);
-  bindTextNode(m_context);
-  bindCommentNode(m_context);
   bindElement(m_context);
-  bindImageElement(m_context);
-  bindInputElement(m_context);
-  bindSVGElement(m_context);
   bindWindow(m_context);
   bindPerformance(m_context);
   bindCSSStyleDeclaration(m_context);
   bindScreen(m_context);
-  bindBlob(m_context);
+  // Constructors in lazyGlobalConstructors.
+  if (!lazyBinding) {
+    bindMouseEvent(m_context);
+    bindCustomEvent(m_context);
+    bindCloseEvent(m_context);
+    bindGestureEvent(m_context);
+    bindMediaErrorEvent(m_context);
+    bindTouchEvent(m_context);
+    bindInputEvent(m_context);
+    bindIntersectionChangeEvent(m_context);
+    bindMessageEvent(m_context);
+    bindTextNode(m_context);
+    bindCommentNode(m_context);
+    bindImageElement(m_context);
+    bindInputElement(m_context);
+    bindSVGElement(m_context);
+    bindBlob(m_context);
+  }
+  startupTiming.bindings = finishPhase("JSBridge.bindings");
 
 #if ENABLE_PROFILE
   nativePerformance->mark(PERF_JS_NATIVE_METHOD_INIT_END);
@@ -117,10 +164,13 @@ JSBridge::JSBridge(int32_t contextId, const JSExceptionHandler &handler) : conte
 #endif
 
   initKrakenPolyFill(this);
+  startupTiming.polyfill = finishPhase("JSBridge.polyfill");
 
   for (auto p : pluginSourceCode) {
     evaluateScript(&p.second, p.first.c_str(), 0);
   }
+  startupTiming.plugins = finishPhase("JSBridge.plugins");
+  startupTiming.total = (phaseStartTime - startTime) / 1000;
 
 #if ENABLE_PROFILE
   nativePerformance->mark(PERF_JS_POLYFILL_INIT_END);
@@ -175,6 +225,13 @@ void JSBridge::parseHTML(const NativeString *script, const char *url) {
   m_html_parser->parseHTML(script->string, script->length);
 }
 
+void JSBridge::parseHTMLChunk(const NativeString *chunk, const char *url, bool isFinal) {
+  if (!m_context->isValid()) return;
+  if (url != nullptr) binding::jsc::updateLocation(url);
+
+  m_html_parser->parseHTMLChunk(chunk->string, chunk->length, isFinal);
+}
+
 // eval javascript.
 void JSBridge::evaluateScript(const NativeString *script, const char *url, int startLine) {
   if (!m_context->isValid()) return;
@@ -196,6 +253,13 @@ void JSBridge::evaluateScript(const std::u16string &script, const char *url, int
   m_context->evaluateJavaScript(script.c_str(), script.size(), url, startLine);
 }
 
+foundation::BridgeCallback::Context *JSBridge::getCallbackContext(int32_t contextId,
+                                                                 foundation::BridgeCallback::Handle handle) {
+  if (!checkContext(contextId)) return nullptr;
+  auto bridge = static_cast<JSBridge *>(getJSContext(contextId));
+  return bridge->bridgeCallback->getCallbackContext(handle);
+}
+
 JSBridge::~JSBridge() {
   if (!m_context->isValid()) return;
 
@@ -205,13 +269,18 @@ JSBridge::~JSBridge() {
 
   krakenModuleListenerList.clear();
 
+  delete timerQueue;
+  delete animationFrameQueue;
   delete bridgeCallback;
+  // Elements of a document still under construction are released while the context is alive.
+  m_html_parser.reset();
 
   if (m_disposeCallback != nullptr) {
     this->m_disposeCallback(m_disposePrivateData);
   }
 
   binding::jsc::NativePerformance::disposeInstance(m_context->uniqueId);
+  binding::jsc::disposeJSContext(m_context);
 }
 
 void JSBridge::reportError(const char *errmsg) {
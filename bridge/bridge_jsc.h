@@ -17,6 +17,23 @@
 
 namespace kraken {
 
+namespace binding::jsc {
+class TimerQueue;
+class AnimationFrameQueue;
+}
+
+// Microseconds spent in each phase of JSBridge construction.
+struct BridgeStartupTiming {
+  int64_t createContext{0};
+  int64_t bindings{0};
+  int64_t polyfill{0};
+  int64_t plugins{0};
+  int64_t total{0};
+  // Time allocateNewContext blocked its caller, a prewarmed bridge is only a pointer swap.
+  int64_t allocate{0};
+  bool prewarmed{false};
+};
+
 class JSBridge final {
 public:
   static ConsoleMessageHandler consoleMessageHandler;
@@ -25,27 +42,42 @@ public:
   ~JSBridge();
 
   static std::unordered_map<std::string, NativeString> pluginSourceCode;
+  // Create rarely used constructors such as Blob or MouseEvent on their first global lookup instead of during
+  // construction.
+  static bool lazyBinding;
 
   std::deque<JSObjectRef> krakenModuleListenerList;
 
   int32_t contextId;
   foundation::BridgeCallback *bridgeCallback;
+  binding::jsc::TimerQueue *timerQueue;
+  binding::jsc::AnimationFrameQueue *animationFrameQueue;
+  // Resolve a callback handle which dart passes back, returns nullptr when the bridge of contextId was disposed or
+  // reloaded, or the callback was already freed.
+  static foundation::BridgeCallback::Context *getCallbackContext(int32_t contextId,
+                                                                 foundation::BridgeCallback::Handle handle);
   // the owner pointer which take JSBridge as property.
   void *owner;
   // evaluate JavaScript source codes in standard mode.
   KRAKEN_EXPORT void evaluateScript(const NativeString *script, const char *url, int startLine);
   KRAKEN_EXPORT void parseHTML(const NativeString *script, const char *url);
+  // Feed the next chunk of a streamed document, url may be null after the first chunk.
+  KRAKEN_EXPORT void parseHTMLChunk(const NativeString *chunk, const char *url, bool isFinal);
   KRAKEN_EXPORT void evaluateScript(const std::u16string &script, const char *url, int startLine);
 
   const std::unique_ptr<kraken::binding::jsc::JSContext> &getContext() const {
     return m_context;
   }
+  binding::jsc::HTMLParser *getHTMLParser() const {
+    return m_html_parser.get();
+  }
 
   void invokeModuleEvent(NativeString *moduleName, const char *eventType, void *event, NativeString *extra);
   void reportError(const char *errmsg);
   void setDisposeCallback(Task task, void *data);
 
   std::atomic<bool> event_registered = false;
+  BridgeStartupTiming startupTiming;
 private:
   std::unique_ptr<binding::jsc::JSContext> m_context;
   std::unique_ptr<binding::jsc::HTMLParser> m_html_parser;
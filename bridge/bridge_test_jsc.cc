@@ -6,8 +6,10 @@
 #include "bridge_test_jsc.h"
 #include "bindings/jsc/KOM/blob.h"
 #include "bindings/jsc/KOM/location.h"
+#include "bindings/jsc/KOM/timer.h"
 #include "dart_methods.h"
 #include "foundation/bridge_callback.h"
+#include "foundation/trace_event.h"
 #include "testframework.h"
 
 namespace kraken {
@@ -107,22 +109,23 @@ JSValueRef matchImageSnapshot(JSContextRef ctx, JSObjectRef function, JSObjectRe
 
   auto fn = [](void *ptr, int32_t contextId, int8_t result) {
     JSValueRef exception = nullptr;
-    auto callbackContext = static_cast<BridgeCallback::Context *>(ptr);
+    auto callbackContext = JSBridge::getCallbackContext(contextId, ptr);
+    if (callbackContext == nullptr) return;
     binding::jsc::JSContext &_context = callbackContext->_context;
     JSContextRef ctx = _context.context();
     JSObjectRef callbackObjectRef = JSValueToObject(ctx, callbackContext->_callback, &exception);
     const JSValueRef arguments[] = {JSValueMakeBoolean(ctx, result != 0)};
     JSObjectCallAsFunction(ctx, callbackObjectRef, _context.global(), 1, arguments, &exception);
     auto bridge = static_cast<JSBridge *>(callbackContext->_context.getOwner());
-    bridge->bridgeCallback->freeBridgeCallbackContext(callbackContext);
     _context.handleException(exception);
+    bridge->bridgeCallback->freeBridgeCallbackContext(ptr);
   };
 
   auto bridge = static_cast<JSBridge *>(context->getOwner());
   bridge->bridgeCallback->registerCallback<void>(
     std::move(callbackContext),
-    [&blob, &nativeString, &fn](BridgeCallback::Context *callbackContext, int32_t contextId) {
-      getDartMethod()->matchImageSnapshot(callbackContext, contextId, blob->bytes(), blob->size(), &nativeString, fn);
+    [&blob, &nativeString, &fn](BridgeCallback::Handle callbackHandle, int32_t contextId) {
+      getDartMethod()->matchImageSnapshot(callbackHandle, contextId, blob->bytes(), blob->size(), &nativeString, fn);
     });
 
   return nullptr;
@@ -223,6 +226,64 @@ JSValueRef simulateInputText(JSContextRef ctx, JSObjectRef function, JSObjectRef
   return nullptr;
 }
 
+JSValueRef setNativeTimerQueue(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                               const JSValueRef *arguments, JSValueRef *exception) {
+  auto context = static_cast<binding::jsc::JSContext *>(JSObjectGetPrivate(function));
+  bool enabled = argumentCount > 0 && JSValueToBoolean(ctx, arguments[0]);
+  binding::jsc::TimerQueue::setEnabled(context->getContextId(), enabled);
+  return nullptr;
+}
+
+JSValueRef setTraceEnabled(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                           const JSValueRef *arguments, JSValueRef *exception) {
+  bool enabled = argumentCount > 0 && JSValueToBoolean(ctx, arguments[0]);
+  if (enabled) ::foundation::TraceLog::clear();
+  ::foundation::TraceLog::setEnabled(enabled);
+  return nullptr;
+}
+
+JSValueRef exportTrace(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                       const JSValueRef *arguments, JSValueRef *exception) {
+  JSStringRef traceStringRef = JSStringCreateWithUTF8CString(::foundation::TraceLog::exportChromeTrace().c_str());
+  JSValueRef result = JSValueMakeString(ctx, traceStringRef);
+  JSStringRelease(traceStringRef);
+  return result;
+}
+
+JSValueRef timerStats(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                      const JSValueRef *arguments, JSValueRef *exception) {
+  auto context = static_cast<binding::jsc::JSContext *>(JSObjectGetPrivate(function));
+  auto bridge = static_cast<JSBridge *>(context->getOwner());
+  auto timerQueue = bridge->timerQueue;
+
+  JSObjectRef stats = JSObjectMake(ctx, nullptr, exception);
+  JSC_SET_STRING_PROPERTY(context, stats, "dartCalls", JSValueMakeNumber(ctx, timerQueue->dartCallCount));
+  JSC_SET_STRING_PROPERTY(context, stats, "dartCallbacks", JSValueMakeNumber(ctx, timerQueue->dartCallbackCount));
+  JSC_SET_STRING_PROPERTY(context, stats, "firedTimers", JSValueMakeNumber(ctx, timerQueue->firedTimerCount));
+  JSC_SET_STRING_PROPERTY(context, stats, "dartFrameRequests",
+                          JSValueMakeNumber(ctx, bridge->animationFrameQueue->dartFrameRequestCount));
+  return stats;
+}
+
+// Feed a chunk of a document to the streaming HTML parser, like dart does for HTML bundles.
+JSValueRef parseHTMLChunk(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
+                          const JSValueRef *arguments, JSValueRef *exception) {
+  if (argumentCount < 1 || !JSValueIsString(ctx, arguments[0])) {
+    binding::jsc::throwJSError(ctx, "Failed to execute '__kraken_parse_html_chunk__': first arguments should be a string.",
+                               exception);
+    return nullptr;
+  }
+
+  auto context = static_cast<binding::jsc::JSContext *>(JSObjectGetPrivate(function));
+  auto bridge = static_cast<JSBridge *>(context->getOwner());
+  bool isFinal = argumentCount > 1 && JSValueToBoolean(ctx, arguments[1]);
+  JSStringRef chunkStringRef = JSValueToStringCopy(ctx, arguments[0], exception);
+  NativeString chunk{JSStringGetCharactersPtr(chunkStringRef), static_cast<int32_t>(JSStringGetLength(chunkStringRef))};
+  bridge->parseHTMLChunk(&chunk, nullptr, isFinal);
+  JSStringRelease(chunkStringRef);
+  return nullptr;
+}
+
 JSBridgeTest::JSBridgeTest(JSBridge *bridge) : bridge_(bridge), context(bridge->getContext()) {
   bridge->owner = this;
   JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_execute_test__", executeTest);
@@ -230,6 +291,11 @@ JSBridgeTest::JSBridgeTest(JSBridge *bridge) : bridge_(bridge), context(bridge->
   JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_environment__", environment);
   JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_simulate_pointer__", simulatePointer);
   JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_simulate_inputtext__", simulateInputText);
+  JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_set_native_timer_queue__", setNativeTimerQueue);
+  JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_timer_stats__", timerStats);
+  JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_set_trace_enabled__", setTraceEnabled);
+  JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_export_trace__", exportTrace);
+  JSC_GLOBAL_BINDING_FUNCTION(context, "__kraken_parse_html_chunk__", parseHTMLChunk);
 
   initKrakenTestFramework(bridge);
 }
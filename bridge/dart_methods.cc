@@ -11,6 +11,73 @@ namespace kraken {
 
 std::shared_ptr<DartMethodPointer> methodPointer = std::make_shared<DartMethodPointer>();
 
+namespace {
+
+DartMethodCallCounts callCounts;
+
+// Dart methods registered by dart side. Calls go through the counting wrappers below, so call sites don't need
+// to know about statistics.
+InvokeModule dartInvokeModule{nullptr};
+RequestBatchUpdate dartRequestBatchUpdate{nullptr};
+SetTimeout dartSetTimeout{nullptr};
+SetInterval dartSetInterval{nullptr};
+ClearTimeout dartClearTimeout{nullptr};
+RequestAnimationFrame dartRequestAnimationFrame{nullptr};
+CancelAnimationFrame dartCancelAnimationFrame{nullptr};
+FlushUICommand dartFlushUICommand{nullptr};
+
+NativeString *countedInvokeModule(void *callbackContext, int32_t contextId, NativeString *moduleName,
+                                  NativeString *method, NativeString *params, AsyncModuleCallback callback) {
+  callCounts.invokeModule.fetch_add(1, std::memory_order_relaxed);
+  return dartInvokeModule(callbackContext, contextId, moduleName, method, params, callback);
+}
+
+void countedRequestBatchUpdate(int32_t contextId) {
+  callCounts.requestBatchUpdate.fetch_add(1, std::memory_order_relaxed);
+  dartRequestBatchUpdate(contextId);
+}
+
+int32_t countedSetTimeout(void *callbackContext, int32_t contextId, AsyncCallback callback, int32_t timeout) {
+  callCounts.setTimeout.fetch_add(1, std::memory_order_relaxed);
+  return dartSetTimeout(callbackContext, contextId, callback, timeout);
+}
+
+int32_t countedSetInterval(void *callbackContext, int32_t contextId, AsyncCallback callback, int32_t timeout) {
+  callCounts.setInterval.fetch_add(1, std::memory_order_relaxed);
+  return dartSetInterval(callbackContext, contextId, callback, timeout);
+}
+
+void countedClearTimeout(int32_t contextId, int32_t timerId) {
+  callCounts.clearTimeout.fetch_add(1, std::memory_order_relaxed);
+  dartClearTimeout(contextId, timerId);
+}
+
+int32_t countedRequestAnimationFrame(void *callbackContext, int32_t contextId, AsyncRAFCallback callback) {
+  callCounts.requestAnimationFrame.fetch_add(1, std::memory_order_relaxed);
+  return dartRequestAnimationFrame(callbackContext, contextId, callback);
+}
+
+void countedCancelAnimationFrame(int32_t contextId, int32_t id) {
+  callCounts.cancelAnimationFrame.fetch_add(1, std::memory_order_relaxed);
+  dartCancelAnimationFrame(contextId, id);
+}
+
+void countedFlushUICommand() {
+  callCounts.flushUICommand.fetch_add(1, std::memory_order_relaxed);
+  dartFlushUICommand();
+}
+
+template <typename T> T countCalls(T method, T &registered, T counted) {
+  registered = method;
+  return method == nullptr ? nullptr : counted;
+}
+
+} // namespace
+
+DartMethodCallCounts &getDartMethodCallCounts() {
+  return callCounts;
+}
+
 std::shared_ptr<DartMethodPointer> getDartMethod() {
   std::__thread_id currentThread = std::this_thread::get_id();
 
@@ -30,19 +97,27 @@ std::shared_ptr<DartMethodPointer> getDartMethod() {
 void registerDartMethods(uint64_t *methodBytes, int32_t length) {
   size_t i = 0;
 
-  methodPointer->invokeModule = reinterpret_cast<InvokeModule>(methodBytes[i++]);
-  methodPointer->requestBatchUpdate = reinterpret_cast<RequestBatchUpdate>(methodBytes[i++]);
+  methodPointer->invokeModule =
+    countCalls(reinterpret_cast<InvokeModule>(methodBytes[i++]), dartInvokeModule, countedInvokeModule);
+  methodPointer->requestBatchUpdate = countCalls(reinterpret_cast<RequestBatchUpdate>(methodBytes[i++]),
+                                                 dartRequestBatchUpdate, countedRequestBatchUpdate);
   methodPointer->reloadApp = reinterpret_cast<ReloadApp>(methodBytes[i++]);
-  methodPointer->setTimeout = reinterpret_cast<SetTimeout>(methodBytes[i++]);
-  methodPointer->setInterval = reinterpret_cast<SetInterval>(methodBytes[i++]);
-  methodPointer->clearTimeout = reinterpret_cast<ClearTimeout>(methodBytes[i++]);
-  methodPointer->requestAnimationFrame = reinterpret_cast<RequestAnimationFrame>(methodBytes[i++]);
-  methodPointer->cancelAnimationFrame = reinterpret_cast<CancelAnimationFrame>(methodBytes[i++]);
+  methodPointer->setTimeout =
+    countCalls(reinterpret_cast<SetTimeout>(methodBytes[i++]), dartSetTimeout, countedSetTimeout);
+  methodPointer->setInterval =
+    countCalls(reinterpret_cast<SetInterval>(methodBytes[i++]), dartSetInterval, countedSetInterval);
+  methodPointer->clearTimeout =
+    countCalls(reinterpret_cast<ClearTimeout>(methodBytes[i++]), dartClearTimeout, countedClearTimeout);
+  methodPointer->requestAnimationFrame = countCalls(reinterpret_cast<RequestAnimationFrame>(methodBytes[i++]),
+                                                    dartRequestAnimationFrame, countedRequestAnimationFrame);
+  methodPointer->cancelAnimationFrame = countCalls(reinterpret_cast<CancelAnimationFrame>(methodBytes[i++]),
+                                                   dartCancelAnimationFrame, countedCancelAnimationFrame);
   methodPointer->getScreen = reinterpret_cast<GetScreen>(methodBytes[i++]);
   methodPointer->devicePixelRatio = reinterpret_cast<DevicePixelRatio>(methodBytes[i++]);
   methodPointer->platformBrightness = reinterpret_cast<PlatformBrightness>(methodBytes[i++]);
   methodPointer->toBlob = reinterpret_cast<ToBlob>(methodBytes[i++]);
-  methodPointer->flushUICommand = reinterpret_cast<FlushUICommand>(methodBytes[i++]);
+  methodPointer->flushUICommand =
+    countCalls(reinterpret_cast<FlushUICommand>(methodBytes[i++]), dartFlushUICommand, countedFlushUICommand);
   methodPointer->initHTML = reinterpret_cast<InitHTML>(methodBytes[i++]);
   methodPointer->initWindow = reinterpret_cast<InitWindow>(methodBytes[i++]);
   methodPointer->initDocument = reinterpret_cast<InitDocument>(methodBytes[i++]);
@@ -54,6 +129,7 @@ void registerDartMethods(uint64_t *methodBytes, int32_t length) {
 #endif
 
   methodPointer->onJsError = reinterpret_cast<OnJSError>(methodBytes[i++]);
+  methodPointer->onHTMLConstructed = reinterpret_cast<OnHTMLConstructed>(methodBytes[i++]);
 
   assert_m(i == length, "Dart native methods count is not equal with C++ side method registrations.");
 }
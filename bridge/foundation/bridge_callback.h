@@ -11,7 +11,9 @@
 #endif
 
 #include <atomic>
+#include <cassert>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -20,11 +22,16 @@ namespace kraken::foundation {
 /// An global standalone BridgeCallback register and collector used to register an callback which will call back from
 /// outside of bridge.
 /// This class can auto recycle callback context's memory when bridge are willing to unmount.
-/// This class is thread safe.
+/// Callback contexts live in a slot map, dart only receives an opaque handle (slot index + generation) which is
+/// resolved back in O(1). A handle whose callback was already freed, or which belongs to a disposed or reloaded
+/// bridge, resolves to nullptr instead of a dangling pointer.
 class BridgeCallback {
 public:
+  // Handles travel through dart as `Pointer<Void>`, so they are packed into a pointer sized integer.
+  using Handle = void *;
+
   ~BridgeCallback() {
-    contextList.clear();
+    slots.clear();
   }
 
   struct Context {
@@ -52,32 +59,72 @@ public:
 
   // An wrapper to register an callback outside of bridge and wait for callback to bridge.
   template <typename T>
-  T registerCallback(std::unique_ptr<Context> &&context, std::function<T(BridgeCallback::Context *, int32_t)> fn) {
-    Context *p = context.get();
-    assert(p != nullptr && "Callback context can not be nullptr");
-    auto &jsContext = context->_context;
+  T registerCallback(std::unique_ptr<Context> &&context, std::function<T(Handle, int32_t)> fn) {
+    assert(context != nullptr && "Callback context can not be nullptr");
     int32_t contextId = context->_context.getContextId();
-    contextList.emplace_back(std::move(context));
-    return fn(p, contextId);
+    Handle handle = allocateSlot(std::move(context));
+    return fn(handle, contextId);
   }
 
-  void freeBridgeCallbackContext(Context *context) {
-    auto begin = std::begin(contextList);
-    auto end = std::end(contextList);
+  Context *getCallbackContext(Handle handle) {
+    Slot *slot = findSlot(handle);
+    return slot == nullptr ? nullptr : slot->context.get();
+  }
 
-    while (begin != end) {
-      auto &&ctx = *begin;
-      if (ctx.get() == context) {
-        ctx.reset();
-        contextList.erase(begin);
-      }
+  void freeBridgeCallbackContext(Handle handle) {
+    Slot *slot = findSlot(handle);
+    if (slot == nullptr) return;
+    slot->context.reset();
+    slot->generation = 0;
+    freeSlots.emplace_back(static_cast<uint32_t>(slot - slots.data()));
+  }
 
-      begin++;
+private:
+  static constexpr uint32_t INDEX_BITS = sizeof(uintptr_t) == 8 ? 32 : 20;
+  static constexpr uintptr_t INDEX_MASK = (static_cast<uintptr_t>(1) << INDEX_BITS) - 1;
+  static constexpr uintptr_t GENERATION_MASK = ~static_cast<uintptr_t>(0) >> INDEX_BITS;
+
+  struct Slot {
+    std::unique_ptr<Context> context;
+    // 0 marks an empty slot, live slots always have a non zero generation.
+    uintptr_t generation{0};
+  };
+
+  Handle allocateSlot(std::unique_ptr<Context> &&context) {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+      index = freeSlots.back();
+      freeSlots.pop_back();
+    } else {
+      index = static_cast<uint32_t>(slots.size());
+      assert(index <= INDEX_MASK && "Too many pending bridge callbacks");
+      slots.emplace_back();
     }
+
+    // Generations come from a process wide counter, so handles of a reloaded bridge never match the new one's slots.
+    uintptr_t generation;
+    do {
+      generation = nextGeneration.fetch_add(1, std::memory_order_relaxed) & GENERATION_MASK;
+    } while (generation == 0);
+
+    Slot &slot = slots[index];
+    slot.context = std::move(context);
+    slot.generation = generation;
+    return reinterpret_cast<Handle>((generation << INDEX_BITS) | index);
   }
 
-private:
-  std::vector<std::unique_ptr<Context>> contextList;
+  Slot *findSlot(Handle handle) {
+    auto value = reinterpret_cast<uintptr_t>(handle);
+    uintptr_t index = value & INDEX_MASK;
+    uintptr_t generation = value >> INDEX_BITS;
+    if (generation == 0 || index >= slots.size()) return nullptr;
+    Slot &slot = slots[index];
+    return slot.generation == generation ? &slot : nullptr;
+  }
+
+  static inline std::atomic<uintptr_t> nextGeneration{1};
+  std::vector<Slot> slots;
+  std::vector<uint32_t> freeSlots;
 };
 
 } // namespace kraken::foundation
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "bridge_stats.h"
+#include "dart_methods.h"
+#include "include/kraken_bridge.h"
+
+namespace foundation {
+
+namespace {
+
+void writeTypeCounts(BridgeStatsWriter &writer, const char *name, const std::atomic<int64_t> *counts) {
+  writer.beginObject(name);
+  for (int32_t type = 0; type < UICommandStats::TYPE_COUNT; type++) {
+    const char *typeName = UICommandStats::typeName(type);
+    if (typeName == nullptr) continue;
+    writer.field(typeName, counts[type].load(std::memory_order_relaxed));
+  }
+  writer.endObject();
+}
+
+void writeHistogram(BridgeStatsWriter &writer, const char *name, const UICommandHistogram &histogram) {
+  writer.beginObject(name);
+  writer.field("count", histogram.count());
+  writer.field("sum", histogram.sum());
+  writer.field("max", histogram.max());
+  writer.beginArray("buckets");
+  for (int32_t i = 0; i < UICommandHistogram::BUCKET_COUNT; i++) {
+    writer.element(histogram.bucket(i));
+  }
+  writer.endArray();
+  writer.endObject();
+}
+
+} // namespace
+
+void BridgeStatsWriter::appendSeparator() {
+  if (m_out.back() != '{' && m_out.back() != '[') m_out += ',';
+}
+
+void BridgeStatsWriter::appendName(const char *name) {
+  appendSeparator();
+  m_out += '"';
+  m_out += name;
+  m_out += "\":";
+}
+
+void BridgeStatsWriter::field(const char *name, int64_t value) {
+  appendName(name);
+  m_out += std::to_string(value);
+}
+
+void BridgeStatsWriter::field(const char *name, bool value) {
+  appendName(name);
+  m_out += value ? "true" : "false";
+}
+
+void BridgeStatsWriter::beginObject(const char *name) {
+  appendName(name);
+  m_out += '{';
+}
+
+void BridgeStatsWriter::endObject() {
+  m_out += '}';
+}
+
+void BridgeStatsWriter::beginArray(const char *name) {
+  appendName(name);
+  m_out += '[';
+}
+
+void BridgeStatsWriter::element(int64_t value) {
+  appendSeparator();
+  m_out += std::to_string(value);
+}
+
+void BridgeStatsWriter::endArray() {
+  m_out += ']';
+}
+
+std::string BridgeStatsWriter::finish() {
+  m_out += '}';
+  return std::move(m_out);
+}
+
+void writeUICommandStats(BridgeStatsWriter &writer, int32_t contextId) {
+  UICommandStats &stats = UICommandBuffer::instance(contextId)->stats();
+  writer.field("contextId", static_cast<int64_t>(contextId));
+  writer.field("frames", stats.publishedFrames.load(std::memory_order_relaxed));
+  writer.field("argsBytes", stats.argsBytes.load(std::memory_order_relaxed));
+  writer.field("encodedBytes", stats.encodedBytes.load(std::memory_order_relaxed));
+  writeTypeCounts(writer, "commands", stats.commandCount);
+  writeTypeCounts(writer, "lastFrameCommands", stats.lastFrameCommandCount);
+  writeHistogram(writer, "commandsPerFrame", stats.commandsPerFrame);
+  writeHistogram(writer, "bytesPerFrame", stats.bytesPerFrame);
+  writeHistogram(writer, "flushLatencyUs", stats.flushLatency);
+
+  kraken::DartMethodCallCounts &calls = kraken::getDartMethodCallCounts();
+  writer.beginObject("dartCalls");
+  writer.field("flushUICommand", calls.flushUICommand.load(std::memory_order_relaxed));
+  writer.field("requestBatchUpdate", calls.requestBatchUpdate.load(std::memory_order_relaxed));
+  writer.field("invokeModule", calls.invokeModule.load(std::memory_order_relaxed));
+  writer.field("setTimeout", calls.setTimeout.load(std::memory_order_relaxed));
+  writer.field("setInterval", calls.setInterval.load(std::memory_order_relaxed));
+  writer.field("clearTimeout", calls.clearTimeout.load(std::memory_order_relaxed));
+  writer.field("requestAnimationFrame", calls.requestAnimationFrame.load(std::memory_order_relaxed));
+  writer.field("cancelAnimationFrame", calls.cancelAnimationFrame.load(std::memory_order_relaxed));
+  writer.endObject();
+}
+
+void resetBridgeStats(int32_t contextId) {
+  UICommandBuffer::instance(contextId)->stats().reset();
+}
+
+} // namespace foundation
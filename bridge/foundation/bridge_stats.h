@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_BRIDGE_STATS_H
+#define KRAKENBRIDGE_BRIDGE_STATS_H
+
+#include <cstdint>
+#include <string>
+
+namespace foundation {
+
+// Writes the flat JSON object of bridge statistics, sections which need the bindings are added by the bridge.
+class BridgeStatsWriter {
+public:
+  BridgeStatsWriter() : m_out("{") {};
+
+  void field(const char *name, int64_t value);
+  void field(const char *name, bool value);
+  void beginObject(const char *name);
+  void endObject();
+  void beginArray(const char *name);
+  void element(int64_t value);
+  void endArray();
+  // Close the outermost object and return the JSON.
+  std::string finish();
+
+private:
+  void appendSeparator();
+  void appendName(const char *name);
+
+  std::string m_out;
+};
+
+// Ui command statistics of a context and the process wide dart call counts.
+void writeUICommandStats(BridgeStatsWriter &writer, int32_t contextId);
+// Reset ui command statistics of a context. Dart call counts only grow, consumers compare snapshots instead.
+void resetBridgeStats(int32_t contextId);
+
+} // namespace foundation
+
+#endif // KRAKENBRIDGE_BRIDGE_STATS_H
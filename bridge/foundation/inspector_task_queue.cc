@@ -8,6 +8,6 @@
 namespace foundation {
 
 std::mutex InspectorTaskQueue::inspector_task_creation_mutex_{};
-fml::RefPtr<InspectorTaskQueue> InspectorTaskQueue::instance_{};
+std::unordered_map<int32_t, fml::RefPtr<InspectorTaskQueue>> InspectorTaskQueue::instanceMap_{};
 
 }
@@ -18,11 +18,12 @@ class InspectorTaskQueue : public TaskQueue {
 public:
   static fml::RefPtr<InspectorTaskQueue> instance(int32_t contextId) {
     std::lock_guard<std::mutex> guard(inspector_task_creation_mutex_);
-    if (!instance_) {
-      instance_ = fml::MakeRefCounted<InspectorTaskQueue>();
-      instance_->m_contextId = contextId;
+    auto &instance = instanceMap_[contextId];
+    if (!instance) {
+      instance = fml::MakeRefCounted<InspectorTaskQueue>();
+      instance->m_contextId = contextId;
     }
-    return instance_;
+    return instance;
   };
   int32_t registerTask(const Task &task, void *data) override {
     int32_t taskId = TaskQueue::registerTask(task, data);
@@ -32,7 +33,7 @@ public:
 private:
   int32_t m_contextId{-1};
   static std::mutex inspector_task_creation_mutex_;
-  static fml::RefPtr<InspectorTaskQueue> instance_;
+  static std::unordered_map<int32_t, fml::RefPtr<InspectorTaskQueue>> instanceMap_;
 };
 
 } // namespace foundation
@@ -4,32 +4,149 @@
  */
 
 #include "task_queue.h"
+#include <chrono>
 
 namespace foundation {
 
+TaskQueue::TaskQueue() : m_head(&m_stub), m_tail(&m_stub), m_nodePool(new TaskNode[NODE_POOL_SIZE]) {
+  for (uint32_t i = 0; i < NODE_POOL_SIZE; i++) {
+    m_nodePool[i].pooled = true;
+    m_nodePool[i].poolNext.store(i + 1 < NODE_POOL_SIZE ? i + 2 : 0, std::memory_order_relaxed);
+  }
+  m_freeTop.store(1, std::memory_order_release);
+}
+
+TaskQueue::~TaskQueue() {
+  while (TaskNode *node = pop()) {
+    releaseNode(node);
+  }
+}
+
+TaskQueue::TaskNode *TaskQueue::allocateNode() {
+  uint64_t top = m_freeTop.load(std::memory_order_acquire);
+  while (true) {
+    auto index = static_cast<uint32_t>(top);
+    // The pool is exhausted, fall back to the heap.
+    if (index == 0) return new TaskNode();
+
+    TaskNode *node = &m_nodePool[index - 1];
+    uint64_t next = (((top >> 32) + 1) << 32) | node->poolNext.load(std::memory_order_relaxed);
+    if (m_freeTop.compare_exchange_weak(top, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return node;
+    }
+  }
+}
+
+void TaskQueue::releaseNode(TaskNode *node) {
+  if (!node->pooled) {
+    delete node;
+    return;
+  }
+
+  auto index = static_cast<uint32_t>(node - m_nodePool.get()) + 1;
+  uint64_t top = m_freeTop.load(std::memory_order_acquire);
+  while (true) {
+    node->poolNext.store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+    uint64_t next = (((top >> 32) + 1) << 32) | index;
+    if (m_freeTop.compare_exchange_weak(top, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return;
+    }
+  }
+}
+
+void TaskQueue::push(TaskNode *node) {
+  node->next.store(nullptr, std::memory_order_relaxed);
+  TaskNode *prev = m_head.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+TaskQueue::TaskNode *TaskQueue::pop() {
+  TaskNode *tail = m_tail;
+  TaskNode *next = tail->next.load(std::memory_order_acquire);
+
+  if (tail == &m_stub) {
+    if (next == nullptr) return nullptr;
+    m_tail = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+
+  if (next != nullptr) {
+    m_tail = next;
+    return tail;
+  }
+
+  // tail is the last node, unless a producer is in the middle of linking a new one.
+  if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+
+  push(&m_stub);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next != nullptr) {
+    m_tail = next;
+    return tail;
+  }
+  return nullptr;
+}
+
 int32_t TaskQueue::registerTask(const Task &task, void *data) {
-  std::lock_guard<std::mutex> guard(queue_mutex_);
-  auto taskData = new TaskData(task, data);
-  m_map[id++] = taskData;
-  return id - 1;
+  TaskNode *node = allocateNode();
+  node->task = task;
+  node->data = data;
+  node->taskId = m_nextTaskId.fetch_add(1, std::memory_order_relaxed);
+  int32_t taskId = node->taskId;
+  // A null task is never run, so it must not be counted as pending either.
+  if (task != nullptr) m_pendingCount.fetch_add(1, std::memory_order_release);
+  push(node);
+  return taskId;
+}
+
+void TaskQueue::runTask(TaskNode *node) {
+  Task task = node->task;
+  void *data = node->data;
+  if (task == nullptr) return;
+  node->task = nullptr;
+  m_pendingCount.fetch_sub(1, std::memory_order_acq_rel);
+  task(data);
 }
 
 void TaskQueue::dispatchTask(int32_t taskId) {
-  std::lock_guard<std::mutex> guard(queue_mutex_);
-  if (m_map.count(taskId) > 0) {
-    m_map[taskId]->task(m_map[taskId]->data);
-    delete m_map[taskId];
-    m_map.erase(taskId);
+  // The task stays linked and is skipped by the next flush.
+  TaskNode *node = m_tail;
+  while (node != nullptr) {
+    if (node != &m_stub && node->taskId == taskId && node->task != nullptr) {
+      runTask(node);
+      return;
+    }
+    node = node->next.load(std::memory_order_acquire);
   }
 }
 
 void TaskQueue::flushTask() {
-  std::lock_guard<std::mutex> guard(queue_mutex_);
-  for(auto &m : m_map) {
-    m.second->task(m.second->data);
-    delete m.second;
+  flushTask(-1);
+}
+
+int64_t TaskQueue::flushTask(int64_t budgetMicroseconds) {
+  // Tasks registered by the tasks of this flush run in the next one.
+  // The stub may be re-linked behind tasks a producer was still linking, so when it is the last node the flush
+  // ends once the consumer reaches it instead.
+  TaskNode *last = m_head.load(std::memory_order_acquire);
+
+  auto start = std::chrono::steady_clock::now();
+  while (!(last == &m_stub && m_tail == &m_stub)) {
+    TaskNode *node = pop();
+    if (node == nullptr) break;
+    bool reachedLast = node == last;
+    runTask(node);
+    releaseNode(node);
+    if (reachedLast) break;
+
+    if (budgetMicroseconds >= 0 &&
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() >=
+          budgetMicroseconds) {
+      break;
+    }
   }
-  m_map.clear();
+  return pendingTaskCount();
 }
 
 } // namespace foundation
@@ -9,27 +9,65 @@
 #include "closure.h"
 #include "ref_counter.h"
 #include "ref_ptr.h"
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
 namespace foundation {
 
+// A multi-producer single-consumer task queue. Any thread may register tasks without taking a lock, tasks are
+// run by the consumer thread in the order they were registered.
 class TaskQueue : public fml::RefCountedThreadSafe<TaskQueue> {
 public:
+  using Task = void (*)(void *);
+
+  TaskQueue();
+  virtual ~TaskQueue();
+
   virtual int32_t registerTask(const Task &task, void *data);
+  // Run a single registered task ahead of the others. Consumer thread only.
   void dispatchTask(int32_t taskId);
+  // Run all tasks registered before the flush started. Consumer thread only.
   void flushTask();
+  // Like flushTask, but stop once budgetMicroseconds has been spent so a long backlog can be split across frames.
+  // Returns the number of tasks still pending.
+  int64_t flushTask(int64_t budgetMicroseconds);
+
+  int64_t pendingTaskCount() const {
+    return m_pendingCount.load(std::memory_order_acquire);
+  }
 
 private:
-  struct TaskData {
-    TaskData(const Task &task, void *data) : task(task), data(data){};
-    Task task;
-    void *data;
+  struct TaskNode {
+    std::atomic<TaskNode *> next{nullptr};
+    Task task{nullptr};
+    void *data{nullptr};
+    int32_t taskId{0};
+    // Index + 1 of the next free node in the pool, 0 ends the free list.
+    std::atomic<uint32_t> poolNext{0};
+    bool pooled{false};
   };
 
-  mutable std::mutex queue_mutex_;
-  std::unordered_map<int, TaskData *> m_map;
-  int64_t id{0};
+  static constexpr uint32_t NODE_POOL_SIZE = 512;
+
+  TaskNode *allocateNode();
+  void releaseNode(TaskNode *node);
+  void push(TaskNode *node);
+  TaskNode *pop();
+  void runTask(TaskNode *node);
+
+  // Producers exchange m_head, the consumer walks from m_tail. m_stub keeps the list non empty.
+  std::atomic<TaskNode *> m_head;
+  TaskNode *m_tail;
+  TaskNode m_stub;
+
+  std::unique_ptr<TaskNode[]> m_nodePool;
+  // Tagged top of the free list: the high 32 bits count pushes so a recycled node can not fool a stale CAS.
+  std::atomic<uint64_t> m_freeTop{0};
+
+  std::atomic<int32_t> m_nextTaskId{0};
+  std::atomic<int64_t> m_pendingCount{0};
 
   FML_FRIEND_MAKE_REF_COUNTED(TaskQueue);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(TaskQueue);
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "foundation/task_queue.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace foundation;
+
+namespace {
+
+struct RecordedTask {
+  std::vector<int> *order;
+  int value;
+};
+
+void recordTask(void *data) {
+  auto task = static_cast<RecordedTask *>(data);
+  task->order->push_back(task->value);
+}
+
+void countTask(void *data) {
+  static_cast<std::atomic<int64_t> *>(data)->fetch_add(1, std::memory_order_relaxed);
+}
+
+void sleepTask(void *data) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  countTask(data);
+}
+
+} // namespace
+
+TEST(TaskQueue, flushTasksInRegistrationOrder) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  std::vector<int> order;
+  // More tasks than the node pool holds, so heap nodes are ordered with pooled ones.
+  std::vector<RecordedTask> tasks(1000);
+  for (int i = 0; i < 1000; i++) {
+    tasks[i] = RecordedTask{&order, i};
+    queue->registerTask(recordTask, &tasks[i]);
+  }
+  EXPECT_EQ(queue->pendingTaskCount(), 1000);
+
+  queue->flushTask();
+  EXPECT_EQ(queue->pendingTaskCount(), 0);
+  ASSERT_EQ(order.size(), 1000u);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(TaskQueue, skipDispatchedAndNullTasks) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  std::vector<int> order;
+  RecordedTask first{&order, 1};
+  RecordedTask second{&order, 2};
+  queue->registerTask(recordTask, &first);
+  queue->registerTask(nullptr, nullptr);
+  int32_t secondId = queue->registerTask(recordTask, &second);
+  EXPECT_EQ(queue->pendingTaskCount(), 2);
+
+  queue->dispatchTask(secondId);
+  EXPECT_EQ(queue->pendingTaskCount(), 1);
+  queue->flushTask();
+  EXPECT_EQ(queue->pendingTaskCount(), 0);
+  EXPECT_EQ(order, (std::vector<int>{2, 1}));
+}
+
+TEST(TaskQueue, runTasksOfManyProducersExactlyOnce) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  std::atomic<int64_t> runCount{0};
+  const int producerCount = 8;
+  const int tasksPerProducer = 20000;
+
+  std::atomic<int> finishedProducers{0};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < producerCount; p++) {
+    producers.emplace_back([&]() {
+      for (int i = 0; i < tasksPerProducer; i++) {
+        queue->registerTask(countTask, &runCount);
+      }
+      finishedProducers.fetch_add(1);
+    });
+  }
+
+  // Flushing while producers allocate makes pool nodes recycle under contention, which a free list without the
+  // push counter tag would corrupt.
+  while (finishedProducers.load() < producerCount) {
+    queue->flushTask();
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  queue->flushTask();
+
+  EXPECT_EQ(runCount.load(), producerCount * tasksPerProducer);
+  EXPECT_EQ(queue->pendingTaskCount(), 0);
+}
+
+TEST(TaskQueue, keepOrderOfEachProducer) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  const int producerCount = 4;
+  const int tasksPerProducer = 5000;
+  std::vector<std::vector<int>> orders(producerCount);
+  std::vector<std::vector<RecordedTask>> tasks(producerCount, std::vector<RecordedTask>(tasksPerProducer));
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < producerCount; p++) {
+    producers.emplace_back([&, p]() {
+      for (int i = 0; i < tasksPerProducer; i++) {
+        tasks[p][i] = RecordedTask{&orders[p], i};
+        queue->registerTask(recordTask, &tasks[p][i]);
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  queue->flushTask();
+
+  for (int p = 0; p < producerCount; p++) {
+    ASSERT_EQ(orders[p].size(), static_cast<size_t>(tasksPerProducer));
+    for (int i = 0; i < tasksPerProducer; i++) {
+      EXPECT_EQ(orders[p][i], i);
+    }
+  }
+}
+
+TEST(TaskQueue, splitBacklogAcrossBudgetedFlushes) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  std::atomic<int64_t> runCount{0};
+  for (int i = 0; i < 20; i++) {
+    queue->registerTask(sleepTask, &runCount);
+  }
+
+  // Each task takes at least a millisecond, a 2ms budget stops after a few of them.
+  int64_t pending = queue->flushTask(2000);
+  EXPECT_GT(runCount.load(), 0);
+  EXPECT_LT(runCount.load(), 20);
+  EXPECT_EQ(pending, 20 - runCount.load());
+  EXPECT_EQ(queue->pendingTaskCount(), pending);
+
+  int flushes = 1;
+  while (queue->flushTask(2000) > 0) {
+    flushes++;
+  }
+  EXPECT_GT(flushes, 1);
+  EXPECT_EQ(runCount.load(), 20);
+}
+
+TEST(TaskQueue, deferTasksRegisteredWhileFlushing) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  struct Reentrant {
+    TaskQueue *queue;
+    std::atomic<int64_t> runCount{0};
+  } reentrant{queue.get()};
+
+  queue->registerTask(
+    [](void *data) {
+      auto reentrant = static_cast<Reentrant *>(data);
+      reentrant->queue->registerTask(countTask, &reentrant->runCount);
+    },
+    &reentrant);
+
+  queue->flushTask();
+  EXPECT_EQ(reentrant.runCount.load(), 0);
+  EXPECT_EQ(queue->pendingTaskCount(), 1);
+  queue->flushTask();
+  EXPECT_EQ(reentrant.runCount.load(), 1);
+}
+
+TEST(TaskQueue, runTaskRegisteredWhileLastNodeIsPopped) {
+  auto queue = fml::MakeRefCounted<TaskQueue>();
+  std::atomic<int64_t> runCount{0};
+  std::atomic<int> round{0};
+  std::atomic<int> registeredRound{0};
+  const int rounds = 20000;
+
+  // The producer registers as soon as a round starts, racing the flush which pops the only linked node. If it links
+  // its task after the flush checked for one but before the flush re-linked the stub, the stub ends up behind it.
+  std::thread producer([&]() {
+    for (int i = 1; i <= rounds; i++) {
+      while (round.load(std::memory_order_acquire) != i) {
+        std::this_thread::yield();
+      }
+      queue->registerTask(countTask, &runCount);
+      registeredRound.store(i, std::memory_order_release);
+    }
+  });
+
+  for (int i = 1; i <= rounds; i++) {
+    queue->registerTask(countTask, &runCount);
+    round.store(i, std::memory_order_release);
+    queue->flushTask();
+    while (registeredRound.load(std::memory_order_acquire) != i) {
+      std::this_thread::yield();
+    }
+    queue->flushTask();
+    ASSERT_EQ(queue->pendingTaskCount(), 0) << "task of round " << i << " was not run";
+  }
+  producer.join();
+  EXPECT_EQ(runCount.load(), 2 * rounds);
+}
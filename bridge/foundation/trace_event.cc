@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "trace_event.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <unordered_set>
+
+namespace foundation {
+
+std::atomic<bool> TraceLog::s_enabled{ENABLE_PROFILE != 0};
+std::atomic<int64_t> TraceLog::s_clearTime{0};
+
+namespace {
+
+// Slot fields are atomics so the exporter can read a buffer while its owner thread keeps writing. Relaxed
+// atomic loads and stores compile to plain moves.
+struct TraceSlot {
+  std::atomic<const char *> name{nullptr};
+  std::atomic<const char *> detail{nullptr};
+  std::atomic<int64_t> startTime{0};
+  std::atomic<int64_t> duration{0};
+  std::atomic<int32_t> contextId{-1};
+};
+
+struct TraceBuffer {
+  explicit TraceBuffer(int32_t threadId) : threadId(threadId) {}
+  const int32_t threadId;
+  // Number of events ever written, only advanced by the owner thread.
+  std::atomic<uint64_t> writeIndex{0};
+  TraceSlot slots[TraceLog::BUFFER_CAPACITY];
+};
+
+std::mutex bufferMutex;
+// Buffers outlive their threads so events from finished threads can still be exported.
+std::vector<TraceBuffer *> buffers;
+
+std::mutex internMutex;
+std::unordered_set<std::string> internedStrings;
+
+TraceBuffer *currentBuffer() {
+  thread_local TraceBuffer *buffer = nullptr;
+  if (buffer == nullptr) {
+    std::lock_guard<std::mutex> guard(bufferMutex);
+    buffer = new TraceBuffer(static_cast<int32_t>(buffers.size()) + 1);
+    buffers.emplace_back(buffer);
+  }
+  return buffer;
+}
+
+void appendJSONString(std::string &out, const char *str) {
+  out += '"';
+  for (const char *p = str; *p != '\0'; p++) {
+    char c = *p;
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+} // namespace
+
+void TraceLog::setEnabled(bool enabled) {
+  s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t TraceLog::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+void TraceLog::addCompleteEvent(const char *name, const char *detail, int32_t contextId, int64_t startTime,
+                                int64_t endTime) {
+  TraceBuffer *buffer = currentBuffer();
+  uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+  TraceSlot &slot = buffer->slots[index & (BUFFER_CAPACITY - 1)];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.detail.store(detail, std::memory_order_relaxed);
+  slot.startTime.store(startTime, std::memory_order_relaxed);
+  slot.duration.store(endTime - startTime, std::memory_order_relaxed);
+  slot.contextId.store(contextId, std::memory_order_relaxed);
+  buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+const char *TraceLog::internString(const std::string &str) {
+  std::lock_guard<std::mutex> guard(internMutex);
+  return internedStrings.emplace(str).first->c_str();
+}
+
+void TraceLog::collect(std::vector<TraceEvent> &events) {
+  std::vector<TraceBuffer *> snapshot;
+  {
+    std::lock_guard<std::mutex> guard(bufferMutex);
+    snapshot = buffers;
+  }
+
+  int64_t clearTime = s_clearTime.load(std::memory_order_relaxed);
+  std::vector<TraceEvent> copied;
+  for (TraceBuffer *buffer : snapshot) {
+    uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+    uint64_t begin = end > BUFFER_CAPACITY ? end - BUFFER_CAPACITY : 0;
+    copied.clear();
+    for (uint64_t i = begin; i < end; i++) {
+      TraceSlot &slot = buffer->slots[i & (BUFFER_CAPACITY - 1)];
+      TraceEvent event;
+      event.name = slot.name.load(std::memory_order_relaxed);
+      event.detail = slot.detail.load(std::memory_order_relaxed);
+      event.startTime = slot.startTime.load(std::memory_order_relaxed);
+      event.duration = slot.duration.load(std::memory_order_relaxed);
+      event.contextId = slot.contextId.load(std::memory_order_relaxed);
+      event.threadId = buffer->threadId;
+      copied.emplace_back(event);
+    }
+
+    // The owner may have wrapped around while we were copying. Slot i can only be overwritten once writeIndex
+    // has reached i + BUFFER_CAPACITY, so everything below that bound is discarded.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = buffer->writeIndex.load(std::memory_order_relaxed);
+    uint64_t firstValid = after >= BUFFER_CAPACITY ? after - BUFFER_CAPACITY + 1 : 0;
+    for (uint64_t i = begin; i < end; i++) {
+      if (i < firstValid) continue;
+      TraceEvent &event = copied[i - begin];
+      if (event.startTime < clearTime) continue;
+      events.emplace_back(event);
+    }
+  }
+
+  std::sort(events.begin(), events.end(),
+            [](const TraceEvent &left, const TraceEvent &right) { return left.startTime < right.startTime; });
+}
+
+std::string TraceLog::exportChromeTrace() {
+  std::vector<TraceEvent> events;
+  collect(events);
+
+  std::string out = "{\"traceEvents\":[";
+  char number[128];
+  for (size_t i = 0; i < events.size(); i++) {
+    TraceEvent &event = events[i];
+    if (i > 0) out += ',';
+    out += "{\"name\":";
+    appendJSONString(out, event.name);
+    snprintf(number, sizeof(number), ",\"cat\":\"kraken\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+             event.threadId, event.startTime / 1000.0, event.duration / 1000.0);
+    out += number;
+    snprintf(number, sizeof(number), ",\"args\":{\"contextId\":%d", event.contextId);
+    out += number;
+    if (event.detail != nullptr) {
+      out += ",\"detail\":";
+      appendJSONString(out, event.detail);
+    }
+    out += "}}";
+  }
+  out += "],\"displayTimeUnit\":\"ms\"}";
+  return out;
+}
+
+void TraceLog::clear() {
+  s_clearTime.store(now(), std::memory_order_relaxed);
+}
+
+} // namespace foundation
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_TRACE_EVENT_H
+#define KRAKENBRIDGE_TRACE_EVENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace foundation {
+
+// A completed trace span. name must point to a string with static storage duration, detail is either static
+// or returned by TraceLog::internString.
+struct TraceEvent {
+  const char *name{nullptr};
+  const char *detail{nullptr};
+  int64_t startTime{0}; // nanoseconds on the steady clock
+  int64_t duration{0};  // nanoseconds
+  int32_t contextId{-1};
+  int32_t threadId{0};
+};
+
+// Always compiled in, off by default. Every thread records into its own fixed-size ring buffer without taking a
+// lock, so when tracing is disabled a trace point costs a single relaxed atomic load.
+class TraceLog {
+public:
+  // Events kept per thread, older events are overwritten.
+  static constexpr uint64_t BUFFER_CAPACITY = 1 << 13;
+
+  static bool isEnabled() {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+  static void setEnabled(bool enabled);
+
+  static int64_t now();
+  static void addCompleteEvent(const char *name, const char *detail, int32_t contextId, int64_t startTime,
+                               int64_t endTime);
+
+  // Returns a pointer to a process lifetime copy of str, for dynamic details like property names.
+  static const char *internString(const std::string &str);
+
+  // Copy every event recorded since the last clear, from all threads. Safe to call while other threads record.
+  static void collect(std::vector<TraceEvent> &events);
+  // Serialize collected events in the Chrome trace event format, loadable by chrome://tracing and Perfetto.
+  static std::string exportChromeTrace();
+  // Drop every event recorded so far.
+  static void clear();
+
+private:
+  static std::atomic<bool> s_enabled;
+  static std::atomic<int64_t> s_clearTime;
+};
+
+class TraceScope {
+public:
+  TraceScope(const char *name, int32_t contextId, const char *detail = nullptr)
+    : m_name(name), m_detail(detail), m_contextId(contextId),
+      m_startTime(TraceLog::isEnabled() ? TraceLog::now() : -1) {}
+  ~TraceScope() {
+    if (m_startTime >= 0) TraceLog::addCompleteEvent(m_name, m_detail, m_contextId, m_startTime, TraceLog::now());
+  }
+
+  bool isActive() const {
+    return m_startTime >= 0;
+  }
+  void setDetail(const char *detail) {
+    m_detail = detail;
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *m_name;
+  const char *m_detail;
+  int32_t m_contextId;
+  int64_t m_startTime;
+};
+
+} // namespace foundation
+
+#define KRAKEN_TRACE_CONCAT_INTERNAL(a, b) a##b
+#define KRAKEN_TRACE_CONCAT(a, b) KRAKEN_TRACE_CONCAT_INTERNAL(a, b)
+#define KRAKEN_TRACE_EVENT(name, contextId)                                                                         \
+  ::foundation::TraceScope KRAKEN_TRACE_CONCAT(__kraken_trace_scope_, __LINE__)(name, contextId)
+
+#endif // KRAKENBRIDGE_TRACE_EVENT_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "include/kraken_bridge.h"
+#include <cstring>
+
+namespace foundation {
+
+namespace {
+// Zero length strings still need a non null address, dart side use null pointer as the end of arguments.
+const uint16_t EMPTY_STRING[1]{0};
+} // namespace
+
+UICommandArena::~UICommandArena() {
+  for (auto &chunk : m_chunks) {
+    delete[] chunk.data;
+  }
+}
+
+const uint16_t *UICommandArena::copy(const uint16_t *string, size_t length) {
+  if (length == 0) return EMPTY_STRING;
+
+  while (m_chunkIndex < m_chunks.size()) {
+    Chunk &chunk = m_chunks[m_chunkIndex];
+    if (chunk.capacity - m_offset >= length) {
+      uint16_t *dest = chunk.data + m_offset;
+      memcpy(dest, string, length * sizeof(uint16_t));
+      m_offset += length;
+      return dest;
+    }
+    m_chunkIndex++;
+    m_offset = 0;
+  }
+
+  size_t capacity = length > CHUNK_SIZE ? length : CHUNK_SIZE;
+  m_chunks.emplace_back(Chunk{new uint16_t[capacity], capacity});
+  m_chunkIndex = m_chunks.size() - 1;
+  uint16_t *dest = m_chunks[m_chunkIndex].data;
+  memcpy(dest, string, length * sizeof(uint16_t));
+  m_offset = length;
+  return dest;
+}
+
+void UICommandArena::reset() {
+  m_chunkIndex = 0;
+  m_offset = 0;
+}
+
+UICommandAtomTable::~UICommandAtomTable() {
+  int32_t count = m_atomCount.load(std::memory_order_acquire);
+  for (int32_t i = 0; i < count; i++) {
+    delete[] m_atoms[i]->string;
+    delete m_atoms[i];
+  }
+}
+
+int32_t UICommandAtomTable::intern(const uint16_t *string, size_t length) {
+  if (length == 0 || length > MAX_ATOM_LENGTH) return -1;
+
+  std::u16string_view key(reinterpret_cast<const char16_t *>(string), length);
+  auto it = m_atomMap.find(key);
+  if (it != m_atomMap.end()) return it->second;
+
+  int32_t atomId = m_atomCount.load(std::memory_order_relaxed);
+  if (static_cast<size_t>(atomId) >= MAX_ATOM_COUNT) return -1;
+  if (m_atoms == nullptr) {
+    m_atoms = std::make_unique<NativeString *[]>(MAX_ATOM_COUNT);
+  }
+
+  auto *chars = new uint16_t[length];
+  memcpy(chars, string, length * sizeof(uint16_t));
+  auto *atom = new NativeString();
+  atom->string = chars;
+  atom->length = length;
+
+  m_atoms[atomId] = atom;
+  m_atomMap[std::u16string_view(reinterpret_cast<const char16_t *>(chars), length)] = atomId;
+  m_atomCount.store(atomId + 1, std::memory_order_release);
+  return atomId;
+}
+
+NativeString *UICommandAtomTable::atom(int32_t atomId) {
+  if (atomId < 0 || atomId >= m_atomCount.load(std::memory_order_acquire)) return nullptr;
+  return m_atoms[atomId];
+}
+
+size_t UICommandAtomTable::size() {
+  return m_atomCount.load(std::memory_order_acquire);
+}
+
+} // namespace foundation
@@ -5,76 +5,335 @@
 
 #include "dart_methods.h"
 #include "include/kraken_bridge.h"
+#include "trace_event.h"
+#include <chrono>
+#include <mutex>
 
 namespace foundation {
 
+namespace {
+std::atomic<int32_t> uiCommandEncoding{UI_COMMAND_ENCODING_STRUCT};
+
+int64_t nowMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+void relaxedAdd(std::atomic<int64_t> &counter, int64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+} // namespace
+
+void UICommandHistogram::add(int64_t value) {
+  int32_t index = 0;
+  for (uint64_t v = value > 0 ? value : 0; v != 0 && index < BUCKET_COUNT - 1; v >>= 1) index++;
+  relaxedAdd(m_buckets[index], 1);
+  relaxedAdd(m_count, 1);
+  relaxedAdd(m_sum, value);
+  if (value > m_max.load(std::memory_order_relaxed)) m_max.store(value, std::memory_order_relaxed);
+}
+
+void UICommandHistogram::reset() {
+  for (auto &bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+const char *UICommandStats::typeName(int32_t type) {
+  switch (type) {
+  case UICommand::createElement:
+    return "createElement";
+  case UICommand::createTextNode:
+    return "createTextNode";
+  case UICommand::createComment:
+    return "createComment";
+  case UICommand::disposeEventTarget:
+    return "disposeEventTarget";
+  case UICommand::addEvent:
+    return "addEvent";
+  case UICommand::removeNode:
+    return "removeNode";
+  case UICommand::insertAdjacentNode:
+    return "insertAdjacentNode";
+  case UICommand::setStyle:
+    return "setStyle";
+  case UICommand::setProperty:
+    return "setProperty";
+  case UICommand::removeProperty:
+    return "removeProperty";
+  case UICommand::cloneNode:
+    return "cloneNode";
+  case UICommand::removeEvent:
+    return "removeEvent";
+  case UICommand::canvasDisplayList:
+    return "canvasDisplayList";
+  default:
+    return nullptr;
+  }
+}
+
+void UICommandStats::reset() {
+  for (int32_t i = 0; i < TYPE_COUNT; i++) {
+    commandCount[i].store(0, std::memory_order_relaxed);
+    lastFrameCommandCount[i].store(0, std::memory_order_relaxed);
+  }
+  argsBytes.store(0, std::memory_order_relaxed);
+  encodedBytes.store(0, std::memory_order_relaxed);
+  publishedFrames.store(0, std::memory_order_relaxed);
+  commandsPerFrame.reset();
+  bytesPerFrame.reset();
+  flushLatency.reset();
+}
+
 UICommandBuffer::UICommandBuffer(int32_t contextId) : contextId(contextId) {}
 
 void UICommandBuffer::addCommand(int32_t id, int32_t type, void *nativePtr, bool batchedUpdate) {
+  KRAKEN_TRACE_EVENT("UICommandBuffer.addCommand", contextId);
   if (batchedUpdate) {
     kraken::getDartMethod()->requestBatchUpdate(contextId);
-    update_batched = true;
+    update_batched.store(true, std::memory_order_release);
   }
 
   UICommandItem item{id, type, nativePtr};
-  queue.emplace_back(item);
+  frames[recordingIndex].queue.emplace_back(item);
+  sequence.fetch_add(1, std::memory_order_relaxed);
+  producerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
 }
 
 void UICommandBuffer::addCommand(int32_t id, int32_t type, void *nativePtr) {
-  if (!update_batched) {
-    kraken::getDartMethod()->requestBatchUpdate(contextId);
-    update_batched = true;
-  }
-
   UICommandItem item{id, type, nativePtr};
-  queue.emplace_back(item);
+  recordCommand(item);
 }
 
 void UICommandBuffer::addCommand(int32_t id, int32_t type, NativeString &args_01, void *nativePtr) {
-  if (!update_batched) {
-    kraken::getDartMethod()->requestBatchUpdate(contextId);
-    update_batched = true;
-  }
-
-  UICommandItem item{id, type, args_01, nativePtr};
-  queue.emplace_back(item);
+  UICommandItem item{id, type, nativePtr};
+  copyArgs(type, args_01, nullptr, item);
+  recordCommand(item);
 }
 
 void UICommandBuffer::addCommand(int32_t id, int32_t type, NativeString &args_01, NativeString &args_02,
                                                 void *nativePtr) {
-  if (!update_batched) {
+  UICommandItem item{id, type, nativePtr};
+  copyArgs(type, args_01, &args_02, item);
+  recordCommand(item);
+}
+
+void UICommandBuffer::recordCommand(UICommandItem &item) {
+  KRAKEN_TRACE_EVENT("UICommandBuffer.addCommand", contextId);
+  // The consumer clears the flag when it releases a frame, only the first command afterwards requests an update.
+  if (!update_batched.exchange(true, std::memory_order_acq_rel)) {
     kraken::getDartMethod()->requestBatchUpdate(contextId);
-    update_batched = true;
   }
-  UICommandItem item{id, type, args_01, args_02, nativePtr};
-  queue.emplace_back(item);
+
+  frames[recordingIndex].queue.emplace_back(item);
+  sequence.fetch_add(1, std::memory_order_relaxed);
+  producerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+bool UICommandBuffer::publish() {
+  if (frames[recordingIndex].queue.empty()) return true;
+
+  int32_t expected = -1;
+  if (publishedIndex.load(std::memory_order_acquire) != expected) return false;
+
+  if (coalescingEnabled) {
+    lastCoalescedCount = coalescer.coalesce(frames[recordingIndex].queue, atomTable);
+    // Commands which cancelled each other out leave nothing to read, an empty frame would never be released.
+    if (frames[recordingIndex].queue.empty()) {
+      frames[recordingIndex].arena.reset();
+      sequence.fetch_add(1, std::memory_order_relaxed);
+      update_batched.store(false, std::memory_order_release);
+      return true;
+    }
+  }
+
+  if (uiCommandEncoding == UI_COMMAND_ENCODING_COMPACT) {
+    UICommandEncoder::encode(frames[recordingIndex].queue, frames[recordingIndex].encoded);
+    relaxedAdd(commandStats.encodedBytes, frames[recordingIndex].encoded.size());
+  }
+
+  // Consumer is idle so nothing can publish in between, count the frame while the producer still owns it.
+  recordFrameStats(frames[recordingIndex].queue);
+  publishTime.store(nowMicroseconds(), std::memory_order_relaxed);
+
+  // Consumer set publishedIndex back to -1 after it finished reading, so the other frame is free to record.
+  if (!publishedIndex.compare_exchange_strong(expected, recordingIndex, std::memory_order_acq_rel)) {
+    return false;
+  }
+
+  recordingIndex ^= 1;
+  sequence.fetch_add(1, std::memory_order_relaxed);
+  update_batched.store(false, std::memory_order_release);
+  return true;
+}
+
+void UICommandBuffer::recordFrameStats(const std::vector<UICommandItem> &queue) {
+  int64_t typeCount[UICommandStats::TYPE_COUNT]{};
+  int64_t bytes = 0;
+  for (const UICommandItem &item : queue) {
+    if (item.type >= 0 && item.type < UICommandStats::TYPE_COUNT) typeCount[item.type]++;
+    if (item.args_01_length > 0) bytes += item.args_01_length * sizeof(uint16_t);
+    if (item.args_02_length > 0) bytes += item.args_02_length * sizeof(uint16_t);
+  }
+
+  for (int32_t i = 0; i < UICommandStats::TYPE_COUNT; i++) {
+    relaxedAdd(commandStats.commandCount[i], typeCount[i]);
+    commandStats.lastFrameCommandCount[i].store(typeCount[i], std::memory_order_relaxed);
+  }
+  relaxedAdd(commandStats.argsBytes, bytes);
+  relaxedAdd(commandStats.publishedFrames, 1);
+  commandStats.commandsPerFrame.add(queue.size());
+  commandStats.bytesPerFrame.add(bytes);
+}
+
+UICommandStats &UICommandBuffer::stats() {
+  return commandStats;
+}
+
+void UICommandBuffer::setCoalescingEnabled(bool enabled) {
+  coalescingEnabled = enabled;
+}
+
+int64_t UICommandBuffer::coalescedCount() {
+  return lastCoalescedCount;
+}
+
+void UICommandBuffer::setEncoding(int32_t encoding) {
+  uiCommandEncoding = encoding;
+}
+
+int32_t UICommandBuffer::encoding() {
+  return uiCommandEncoding;
+}
+
+void UICommandBuffer::publishIfProducer() {
+  if (producerThread.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+    publish();
+  }
+}
+
+namespace {
+// The first argument of these commands is a key which is repeated across elements and frames.
+bool isKeyedCommand(int32_t type) {
+  switch (type) {
+  case UICommand::createElement:
+  case UICommand::addEvent:
+  case UICommand::removeEvent:
+  case UICommand::setStyle:
+  case UICommand::setProperty:
+  case UICommand::removeProperty:
+    return true;
+  default:
+    return false;
+  }
+}
+} // namespace
+
+void UICommandBuffer::copyArgs(int32_t type, NativeString &args_01, NativeString *args_02, UICommandItem &item) {
+  int32_t atomId = isKeyedCommand(type) ? atomTable.intern(args_01.string, args_01.length) : -1;
+  if (atomId >= 0) {
+    item.string_01 = reinterpret_cast<int64_t>(atomTable.atom(atomId)->string);
+    item.args_01_length = -(atomId + 1);
+  } else {
+    item.string_01 = reinterpret_cast<int64_t>(frames[recordingIndex].arena.copy(args_01.string, args_01.length));
+    item.args_01_length = args_01.length;
+  }
+
+  if (args_02 == nullptr) return;
+
+  // Positions of insertAdjacentNode are the only few values worth to be interned.
+  atomId = type == UICommand::insertAdjacentNode ? atomTable.intern(args_02->string, args_02->length) : -1;
+  if (atomId >= 0) {
+    item.string_02 = reinterpret_cast<int64_t>(atomTable.atom(atomId)->string);
+    item.args_02_length = -(atomId + 1);
+  } else {
+    item.string_02 = reinterpret_cast<int64_t>(frames[recordingIndex].arena.copy(args_02->string, args_02->length));
+    item.args_02_length = args_02->length;
+  }
 }
 
 UICommandBuffer *UICommandBuffer::instance(int32_t contextId) {
+  // Buffers are looked up from the ui thread, from bridges prewarmed in idle time and from task producers on
+  // other threads, the map itself must not be rehashed under a concurrent lookup. Hot paths keep the buffer of
+  // their context instead, see JSContext::uiCommandBuffer.
+  static std::mutex instanceMutex;
   static std::unordered_map<int32_t, UICommandBuffer *> instanceMap;
 
-  if (instanceMap.count(contextId) == 0) {
-    instanceMap[contextId] = new UICommandBuffer(contextId);
+  std::lock_guard<std::mutex> guard(instanceMutex);
+  auto it = instanceMap.find(contextId);
+  if (it == instanceMap.end()) {
+    it = instanceMap.emplace(contextId, new UICommandBuffer(contextId)).first;
   }
 
-  return instanceMap[contextId];
+  return it->second;
 }
 
 UICommandItem *UICommandBuffer::data() {
-  return queue.data();
+  int32_t index = publishedIndex.load(std::memory_order_acquire);
+  if (index < 0) return nullptr;
+  return frames[index].queue.data();
 }
 
 int64_t UICommandBuffer::size() {
-  return queue.size();
+  int32_t index = publishedIndex.load(std::memory_order_acquire);
+  if (index < 0) return 0;
+  return frames[index].queue.size();
+}
+
+uint8_t *UICommandBuffer::encodedData() {
+  int32_t index = publishedIndex.load(std::memory_order_acquire);
+  if (index < 0) return nullptr;
+  return frames[index].encoded.data();
+}
+
+int64_t UICommandBuffer::encodedSize() {
+  int32_t index = publishedIndex.load(std::memory_order_acquire);
+  if (index < 0) return 0;
+  return frames[index].encoded.size();
+}
+
+void UICommandBuffer::release() {
+  int32_t index = publishedIndex.load(std::memory_order_acquire);
+  if (index < 0) return;
+  commandStats.flushLatency.add(nowMicroseconds() - publishTime.load(std::memory_order_relaxed));
+  frames[index].queue.clear();
+  frames[index].arena.reset();
+  frames[index].encoded.clear();
+  publishedIndex.store(-1, std::memory_order_release);
+  // Commands recorded while consumer was reading need a new batch update request.
+  update_batched.store(false, std::memory_order_release);
 }
 
 void UICommandBuffer::clear() {
-  for (auto command : queue) {
-    delete[] reinterpret_cast<const uint16_t *>(command.string_01);
-    delete[] reinterpret_cast<const uint16_t *>(command.string_02);
+  for (auto &frame : frames) {
+    frame.queue.clear();
+    frame.arena.reset();
+    frame.encoded.clear();
   }
-  queue.clear();
-  update_batched = false;
+  publishedIndex.store(-1, std::memory_order_release);
+  sequence.fetch_add(1, std::memory_order_relaxed);
+  update_batched.store(false, std::memory_order_release);
+}
+
+NativeString *UICommandBuffer::atom(int32_t atomId) {
+  return atomTable.atom(atomId);
+}
+
+bool UICommandBuffer::isLayoutDirty() {
+  return !frames[recordingIndex].queue.empty() || publishedIndex.load(std::memory_order_acquire) != -1;
+}
+
+uint64_t UICommandBuffer::layoutEpoch() {
+  return currentLayoutEpoch.load(std::memory_order_acquire);
+}
+
+void UICommandBuffer::invalidateLayout() {
+  currentLayoutEpoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+uint64_t UICommandBuffer::commandSequence() {
+  return sequence.load(std::memory_order_relaxed);
 }
 
 } // namespace foundation
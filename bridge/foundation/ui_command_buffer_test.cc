@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "dart_methods.h"
+#include "include/kraken_bridge.h"
+#include <string>
+#include <thread>
+
+using namespace foundation;
+
+namespace {
+
+NativeString nativeString(const std::u16string &string) {
+  return NativeString{reinterpret_cast<const uint16_t *>(string.c_str()), static_cast<int32_t>(string.length())};
+}
+
+class UICommandBufferTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Debug builds only hand out dart methods on the UI thread.
+    setUIThreadId(std::this_thread::get_id());
+    kraken::getDartMethod()->requestBatchUpdate = [](int32_t contextId) {};
+    m_buffer = new UICommandBuffer(0);
+    m_buffer->setCoalescingEnabled(true);
+  }
+
+  void TearDown() override {
+    delete m_buffer;
+  }
+
+  UICommandBuffer *m_buffer;
+  std::u16string m_div{u"div"};
+};
+
+} // namespace
+
+TEST_F(UICommandBufferTest, doNotPublishFramesEmptiedByCoalescing) {
+  NativeString div = nativeString(m_div);
+  m_buffer->addCommand(1, UICommand::createElement, div, nullptr);
+  m_buffer->addCommand(1, UICommand::disposeEventTarget, nullptr);
+
+  EXPECT_TRUE(m_buffer->publish());
+  EXPECT_EQ(m_buffer->size(), 0);
+  EXPECT_EQ(m_buffer->data(), nullptr);
+  EXPECT_FALSE(m_buffer->isLayoutDirty());
+
+  // Later frames are still published.
+  m_buffer->addCommand(2, UICommand::createElement, div, nullptr);
+  m_buffer->addCommand(2, UICommand::disposeEventTarget, nullptr);
+  EXPECT_TRUE(m_buffer->publish());
+  EXPECT_EQ(m_buffer->size(), 0);
+
+  m_buffer->addCommand(3, UICommand::createElement, div, nullptr);
+  EXPECT_TRUE(m_buffer->publish());
+  ASSERT_EQ(m_buffer->size(), 1);
+  EXPECT_EQ(m_buffer->data()[0].id, 3);
+  m_buffer->release();
+  EXPECT_EQ(m_buffer->size(), 0);
+}
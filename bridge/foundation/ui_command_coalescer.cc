@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "include/kraken_bridge.h"
+
+namespace foundation {
+
+namespace {
+
+enum WriteKind { STYLE_WRITE = 0, PROPERTY_WRITE = 1, EVENT_LISTENER = 2 };
+
+std::u16string_view readArgs(int64_t string, int32_t length, UICommandAtomTable &atomTable) {
+  if (length < 0) {
+    NativeString *atom = atomTable.atom(-length - 1);
+    return std::u16string_view(reinterpret_cast<const char16_t *>(atom->string), atom->length);
+  }
+  return std::u16string_view(reinterpret_cast<const char16_t *>(string), length);
+}
+
+// Child ids of insertAdjacentNode and cloneNode are passed as decimal strings.
+int32_t readTargetId(const UICommandItem &item) {
+  if (item.args_01_length <= 0) return 0;
+  auto string = reinterpret_cast<const uint16_t *>(item.string_01);
+  bool negative = string[0] == '-';
+  int32_t id = 0;
+  for (int32_t i = negative ? 1 : 0; i < item.args_01_length; i++) {
+    id = id * 10 + (string[i] - '0');
+  }
+  return negative ? -id : id;
+}
+
+} // namespace
+
+int64_t UICommandCoalescer::coalesce(std::vector<UICommandItem> &queue, UICommandAtomTable &atomTable) {
+  if (queue.size() < 2) return 0;
+
+  m_eliminated.assign(queue.size(), false);
+  coalesceWrites(queue, atomTable);
+  elideDisposedNodes(queue);
+
+  size_t write = 0;
+  for (size_t read = 0; read < queue.size(); read++) {
+    if (m_eliminated[read]) continue;
+    if (write != read) queue[write] = queue[read];
+    write++;
+  }
+
+  int64_t eliminated = queue.size() - write;
+  queue.resize(write, UICommandItem{0, 0, nullptr});
+  return eliminated;
+}
+
+void UICommandCoalescer::coalesceWrites(std::vector<UICommandItem> &queue, UICommandAtomTable &atomTable) {
+  m_pendingWrites.clear();
+  m_pendingEvents.clear();
+  m_barrierEpochs.clear();
+
+  for (size_t i = 0; i < queue.size(); i++) {
+    UICommandItem &item = queue[i];
+    switch (item.type) {
+    case UICommand::setStyle:
+    case UICommand::setProperty:
+    case UICommand::removeProperty: {
+      int32_t kind = item.type == UICommand::setStyle ? STYLE_WRITE : PROPERTY_WRITE;
+      CommandKey key{item.id, kind, readArgs(item.string_01, item.args_01_length, atomTable)};
+      int32_t epoch = m_barrierEpochs.count(item.id) > 0 ? m_barrierEpochs[item.id] : 0;
+      auto it = m_pendingWrites.find(key);
+      if (it != m_pendingWrites.end()) {
+        if (it->second.epoch == epoch) {
+          m_eliminated[it->second.index] = true;
+        }
+        it->second = PendingWrite{i, epoch};
+      } else {
+        m_pendingWrites.emplace(key, PendingWrite{i, epoch});
+      }
+      break;
+    }
+    case UICommand::addEvent:
+    case UICommand::removeEvent: {
+      CommandKey key{item.id, EVENT_LISTENER, readArgs(item.string_01, item.args_01_length, atomTable)};
+      auto it = m_pendingEvents.find(key);
+      if (it != m_pendingEvents.end() && it->second == UICommand::addEvent && item.type == UICommand::addEvent) {
+        m_eliminated[i] = true;
+      } else {
+        m_pendingEvents[key] = item.type;
+      }
+      break;
+    }
+    case UICommand::insertAdjacentNode:
+      m_barrierEpochs[item.id]++;
+      m_barrierEpochs[readTargetId(item)]++;
+      break;
+    case UICommand::cloneNode:
+    case UICommand::removeNode:
+      m_barrierEpochs[item.id]++;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void UICommandCoalescer::elideDisposedNodes(std::vector<UICommandItem> &queue) {
+  m_disposableNodes.clear();
+
+  for (auto &item : queue) {
+    switch (item.type) {
+    case UICommand::createElement:
+    case UICommand::createTextNode:
+    case UICommand::createComment:
+      m_disposableNodes[item.id] = false;
+      break;
+    case UICommand::disposeEventTarget:
+      if (m_disposableNodes.count(item.id) > 0) m_disposableNodes[item.id] = true;
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Nodes used as reference of insertion or clone source have effects on other nodes, keep them.
+  for (auto &item : queue) {
+    if (item.type == UICommand::insertAdjacentNode) {
+      m_disposableNodes.erase(item.id);
+    } else if (item.type == UICommand::cloneNode) {
+      m_disposableNodes.erase(item.id);
+      m_disposableNodes.erase(readTargetId(item));
+    }
+  }
+
+  bool hasDisposableNodes = false;
+  for (auto &node : m_disposableNodes) {
+    if (node.second) {
+      hasDisposableNodes = true;
+      break;
+    }
+  }
+  if (!hasDisposableNodes) return;
+
+  for (size_t i = 0; i < queue.size(); i++) {
+    UICommandItem &item = queue[i];
+    int32_t id = item.type == UICommand::insertAdjacentNode ? readTargetId(item) : item.id;
+    auto it = m_disposableNodes.find(id);
+    if (it != m_disposableNodes.end() && it->second) {
+      m_eliminated[i] = true;
+    }
+  }
+}
+
+} // namespace foundation
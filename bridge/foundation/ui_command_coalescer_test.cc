@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "include/kraken_bridge.h"
+#include <deque>
+#include <string>
+
+using namespace foundation;
+
+namespace {
+
+NativeString nativeString(const std::u16string &string) {
+  return NativeString{reinterpret_cast<const uint16_t *>(string.c_str()), static_cast<int32_t>(string.length())};
+}
+
+std::u16string readString(int64_t string, int32_t length) {
+  return std::u16string(reinterpret_cast<const char16_t *>(string), length);
+}
+
+// Keep the strings referenced by items alive for the duration of a test.
+class UICommandCoalescerTest : public ::testing::Test {
+protected:
+  UICommandItem command(int32_t id, UICommand type, const std::u16string &arg01 = u"",
+                        const std::u16string &arg02 = u"") {
+    const std::u16string &first = m_strings.emplace_back(arg01);
+    const std::u16string &second = m_strings.emplace_back(arg02);
+    return UICommandItem(id, type, nativeString(first), nativeString(second), nullptr);
+  }
+
+  int64_t coalesce() {
+    return m_coalescer.coalesce(m_queue, m_atomTable);
+  }
+
+  std::vector<UICommandItem> m_queue;
+  UICommandCoalescer m_coalescer;
+  UICommandAtomTable m_atomTable;
+
+private:
+  std::deque<std::u16string> m_strings;
+};
+
+} // namespace
+
+TEST_F(UICommandCoalescerTest, collapseRedundantStyleWrites) {
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"red"));
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"width", u"10px"));
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"blue"));
+  m_queue.emplace_back(command(2, UICommand::setStyle, u"color", u"green"));
+
+  EXPECT_EQ(coalesce(), 1);
+  ASSERT_EQ(m_queue.size(), 3u);
+  EXPECT_EQ(readString(m_queue[0].string_01, m_queue[0].args_01_length), u"width");
+  EXPECT_EQ(readString(m_queue[1].string_02, m_queue[1].args_02_length), u"blue");
+  EXPECT_EQ(m_queue[2].id, 2);
+}
+
+TEST_F(UICommandCoalescerTest, collapseRedundantPropertyWrites) {
+  m_queue.emplace_back(command(1, UICommand::setProperty, u"value", u"a"));
+  m_queue.emplace_back(command(1, UICommand::setProperty, u"value", u"ab"));
+  m_queue.emplace_back(command(1, UICommand::removeProperty, u"value"));
+  // Styles and properties with the same key are independent.
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"value", u"x"));
+
+  EXPECT_EQ(coalesce(), 2);
+  ASSERT_EQ(m_queue.size(), 2u);
+  EXPECT_EQ(m_queue[0].type, UICommand::removeProperty);
+  EXPECT_EQ(m_queue[1].type, UICommand::setStyle);
+}
+
+TEST_F(UICommandCoalescerTest, collapseRepeatedAddedEvents) {
+  m_queue.emplace_back(command(1, UICommand::addEvent, u"click"));
+  m_queue.emplace_back(command(1, UICommand::addEvent, u"touchstart"));
+  m_queue.emplace_back(command(1, UICommand::addEvent, u"click"));
+
+  EXPECT_EQ(coalesce(), 1);
+  ASSERT_EQ(m_queue.size(), 2u);
+  EXPECT_EQ(readString(m_queue[0].string_01, m_queue[0].args_01_length), u"click");
+  EXPECT_EQ(readString(m_queue[1].string_01, m_queue[1].args_01_length), u"touchstart");
+}
+
+TEST_F(UICommandCoalescerTest, keepEventsRemovedAfterAdded) {
+  // Replayed one by one, dart listens once for click and stops listening at the removeEvent.
+  m_queue.emplace_back(command(1, UICommand::addEvent, u"click"));
+  m_queue.emplace_back(command(1, UICommand::addEvent, u"click"));
+  m_queue.emplace_back(command(1, UICommand::removeEvent, u"click"));
+  m_queue.emplace_back(command(1, UICommand::addEvent, u"click"));
+
+  EXPECT_EQ(coalesce(), 1);
+  ASSERT_EQ(m_queue.size(), 3u);
+  EXPECT_EQ(m_queue[0].type, UICommand::addEvent);
+  EXPECT_EQ(m_queue[1].type, UICommand::removeEvent);
+  EXPECT_EQ(m_queue[2].type, UICommand::addEvent);
+}
+
+TEST_F(UICommandCoalescerTest, elideNodesCreatedAndDisposedInOneFrame) {
+  m_queue.emplace_back(command(1, UICommand::createElement, u"div"));
+  m_queue.emplace_back(command(2, UICommand::createElement, u"span"));
+  m_queue.emplace_back(command(2, UICommand::setStyle, u"color", u"red"));
+  m_queue.emplace_back(command(1, UICommand::insertAdjacentNode, u"2", u"beforeend"));
+  m_queue.emplace_back(command(2, UICommand::removeNode));
+  m_queue.emplace_back(command(2, UICommand::disposeEventTarget));
+
+  EXPECT_EQ(coalesce(), 5);
+  ASSERT_EQ(m_queue.size(), 1u);
+  EXPECT_EQ(m_queue[0].id, 1);
+  EXPECT_EQ(m_queue[0].type, UICommand::createElement);
+}
+
+TEST_F(UICommandCoalescerTest, keepDisposedNodesUsedAsReference) {
+  m_queue.emplace_back(command(1, UICommand::createElement, u"div"));
+  m_queue.emplace_back(command(2, UICommand::createElement, u"span"));
+  m_queue.emplace_back(command(1, UICommand::insertAdjacentNode, u"3", u"afterend"));
+  m_queue.emplace_back(command(1, UICommand::disposeEventTarget));
+  m_queue.emplace_back(command(2, UICommand::cloneNode, u"4"));
+  m_queue.emplace_back(command(2, UICommand::disposeEventTarget));
+
+  EXPECT_EQ(coalesce(), 0);
+  EXPECT_EQ(m_queue.size(), 6u);
+}
+
+TEST_F(UICommandCoalescerTest, keepWritesAroundBarriersInOrder) {
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"red"));
+  m_queue.emplace_back(command(2, UICommand::insertAdjacentNode, u"1", u"beforeend"));
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"blue"));
+  m_queue.emplace_back(command(1, UICommand::cloneNode, u"3"));
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"green"));
+  m_queue.emplace_back(command(1, UICommand::removeNode));
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"black"));
+
+  EXPECT_EQ(coalesce(), 0);
+  ASSERT_EQ(m_queue.size(), 7u);
+  const UICommand expected[] = {UICommand::setStyle,  UICommand::insertAdjacentNode, UICommand::setStyle,
+                                UICommand::cloneNode, UICommand::setStyle,           UICommand::removeNode,
+                                UICommand::setStyle};
+  for (size_t i = 0; i < m_queue.size(); i++) {
+    EXPECT_EQ(m_queue[i].type, expected[i]);
+  }
+}
+
+TEST_F(UICommandCoalescerTest, readInternedKeys) {
+  std::u16string color = u"color";
+  int32_t atomId = m_atomTable.intern(reinterpret_cast<const uint16_t *>(color.c_str()), color.length());
+  ASSERT_GE(atomId, 0);
+
+  UICommandItem interned = command(1, UICommand::setStyle, u"", u"red");
+  interned.string_01 = 0;
+  interned.args_01_length = -atomId - 1;
+  m_queue.emplace_back(interned);
+  m_queue.emplace_back(command(1, UICommand::setStyle, u"color", u"blue"));
+
+  EXPECT_EQ(coalesce(), 1);
+  ASSERT_EQ(m_queue.size(), 1u);
+  EXPECT_EQ(readString(m_queue[0].string_02, m_queue[0].args_02_length), u"blue");
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "include/kraken_bridge.h"
+
+namespace foundation {
+
+namespace {
+
+enum ArgsKind { ARGS_ATOM = 0, ARGS_LATIN1 = 1, ARGS_UTF16 = 2 };
+
+constexpr uint8_t OPCODE_NATIVE_PTR = 1 << 4;
+constexpr uint8_t OPCODE_ARGS_01 = 1 << 5;
+constexpr uint8_t OPCODE_ARGS_02 = 1 << 6;
+
+void writeVarint(std::vector<uint8_t> &bytes, uint64_t value) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+void writeArgs(std::vector<uint8_t> &bytes, int64_t string, int32_t length) {
+  if (length < 0) {
+    uint64_t atomId = -length - 1;
+    writeVarint(bytes, atomId << 2 | ARGS_ATOM);
+    return;
+  }
+
+  auto chars = reinterpret_cast<const uint16_t *>(string);
+  bool isLatin1 = true;
+  for (int32_t i = 0; i < length; i++) {
+    if (chars[i] > 0xff) {
+      isLatin1 = false;
+      break;
+    }
+  }
+
+  if (isLatin1) {
+    writeVarint(bytes, static_cast<uint64_t>(length) << 2 | ARGS_LATIN1);
+    for (int32_t i = 0; i < length; i++) {
+      bytes.push_back(static_cast<uint8_t>(chars[i]));
+    }
+  } else {
+    writeVarint(bytes, static_cast<uint64_t>(length) << 2 | ARGS_UTF16);
+    for (int32_t i = 0; i < length; i++) {
+      bytes.push_back(static_cast<uint8_t>(chars[i]));
+      bytes.push_back(static_cast<uint8_t>(chars[i] >> 8));
+    }
+  }
+}
+
+} // namespace
+
+void UICommandEncoder::encode(const std::vector<UICommandItem> &queue, std::vector<uint8_t> &bytes) {
+  bytes.clear();
+  bytes.push_back(VERSION);
+  writeVarint(bytes, queue.size());
+
+  for (auto &item : queue) {
+    uint8_t opcode = static_cast<uint8_t>(item.type) & 0x0f;
+    if (item.nativePtr != 0) opcode |= OPCODE_NATIVE_PTR;
+    if (item.string_01 != 0) opcode |= OPCODE_ARGS_01;
+    if (item.string_02 != 0) opcode |= OPCODE_ARGS_02;
+    bytes.push_back(opcode);
+
+    // Zigzag encoding keeps reserved negative ids such as WINDOW_TARGET_ID in one byte.
+    auto zigzagId = (static_cast<uint32_t>(item.id) << 1) ^ static_cast<uint32_t>(item.id >> 31);
+    writeVarint(bytes, zigzagId);
+
+    if (opcode & OPCODE_NATIVE_PTR) {
+      auto ptr = static_cast<uint64_t>(item.nativePtr);
+      for (int i = 0; i < 8; i++) {
+        bytes.push_back(static_cast<uint8_t>(ptr >> (i * 8)));
+      }
+    }
+    if (opcode & OPCODE_ARGS_01) writeArgs(bytes, item.string_01, item.args_01_length);
+    if (opcode & OPCODE_ARGS_02) writeArgs(bytes, item.string_02, item.args_02_length);
+  }
+}
+
+} // namespace foundation
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "include/kraken_bridge.h"
+#include <climits>
+
+using namespace foundation;
+
+namespace {
+
+// Decode the zigzag varint id of the only command of bytes, the way the dart reader does.
+int32_t readSingleId(const std::vector<uint8_t> &bytes, size_t *idLength) {
+  // version, command count, opcode.
+  size_t offset = 3;
+  uint64_t zigzag = 0;
+  int shift = 0;
+  while (true) {
+    uint8_t byte = bytes[offset++];
+    zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) break;
+    shift += 7;
+  }
+  *idLength = offset - 3;
+  return static_cast<int32_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+}
+
+} // namespace
+
+TEST(UICommandEncoder, zigzagIds) {
+  const int32_t ids[] = {0, 1, -1, -2, 63, -64, 64, INT_MAX, INT_MIN};
+  for (int32_t id : ids) {
+    std::vector<UICommandItem> queue{UICommandItem(id, UICommand::removeNode, nullptr)};
+    std::vector<uint8_t> bytes;
+    UICommandEncoder::encode(queue, bytes);
+
+    size_t idLength;
+    EXPECT_EQ(readSingleId(bytes, &idLength), id);
+    if (id >= -64 && id <= 63) {
+      EXPECT_EQ(idLength, 1u) << "id " << id;
+    } else {
+      EXPECT_LE(idLength, 5u) << "id " << id;
+    }
+  }
+}
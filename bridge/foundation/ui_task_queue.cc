@@ -7,7 +7,7 @@
 
 namespace foundation {
 std::mutex UITaskQueue::ui_task_creation_mutex_{};
-fml::RefPtr<UITaskQueue> UITaskQueue::instance_{};
+std::unordered_map<int32_t, fml::RefPtr<UITaskQueue>> UITaskQueue::instanceMap_{};
 
 int32_t UITaskQueue::registerTask(const Task &task, void *data) {
   int32_t taskId = TaskQueue::registerTask(task, data);
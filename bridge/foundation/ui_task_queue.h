@@ -16,16 +16,17 @@ class UITaskQueue : public TaskQueue {
 public:
   static fml::RefPtr<UITaskQueue> instance(int32_t contextId) {
     std::lock_guard<std::mutex> guard(ui_task_creation_mutex_);
-    if (!instance_) {
-      instance_ = fml::MakeRefCounted<UITaskQueue>();
-      instance_->m_contextId = contextId;
+    auto &instance = instanceMap_[contextId];
+    if (!instance) {
+      instance = fml::MakeRefCounted<UITaskQueue>();
+      instance->m_contextId = contextId;
     }
-    return instance_;
+    return instance;
   };
-  int32_t registerTask(const Task &task, void *data);
+  int32_t registerTask(const Task &task, void *data) override;
 private:
   static std::mutex ui_task_creation_mutex_;
-  static fml::RefPtr<UITaskQueue> instance_;
+  static std::unordered_map<int32_t, fml::RefPtr<UITaskQueue>> instanceMap_;
   int m_contextId;
 };
 
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "utf_codec.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KRAKEN_UTF_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define KRAKEN_UTF_NEON 1
+#endif
+
+namespace foundation {
+
+namespace {
+
+constexpr char16_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+inline bool isContinuation(unsigned char c) {
+  return (c & 0xC0) == 0x80;
+}
+
+// Copy the leading ASCII run of data into output, 16 bytes per step. Returns the number of bytes copied.
+inline size_t copyASCIIBlocks(const char *data, size_t length, char16_t *output) {
+  size_t i = 0;
+#if KRAKEN_UTF_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    if (_mm_movemask_epi8(bytes) != 0) break;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_unpacklo_epi8(bytes, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 8), _mm_unpackhi_epi8(bytes, zero));
+  }
+#elif KRAKEN_UTF_NEON
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+    if (vmaxvq_u8(bytes) >= 0x80) break;
+    vst1q_u16(reinterpret_cast<uint16_t *>(output + i), vmovl_u8(vget_low_u8(bytes)));
+    vst1q_u16(reinterpret_cast<uint16_t *>(output + i + 8), vmovl_high_u8(bytes));
+  }
+#endif
+  return i;
+}
+
+// Narrow the leading ASCII run of data into output, 16 code units per step. Returns the number of units copied.
+inline size_t copyASCIIBlocks(const char16_t *data, size_t length, char *output) {
+  size_t i = 0;
+#if KRAKEN_UTF_SSE2
+  const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 8));
+    __m128i test = _mm_and_si128(_mm_or_si128(low, high), nonASCII);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(test, zero)) != 0xFFFF) break;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(low, high));
+  }
+#elif KRAKEN_UTF_NEON
+  for (; i + 16 <= length; i += 16) {
+    uint16x8_t low = vld1q_u16(reinterpret_cast<const uint16_t *>(data + i));
+    uint16x8_t high = vld1q_u16(reinterpret_cast<const uint16_t *>(data + i + 8));
+    if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80) break;
+    vst1q_u8(reinterpret_cast<uint8_t *>(output + i), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+  }
+#endif
+  return i;
+}
+
+} // namespace
+
+size_t asciiPrefixLength(const char *data, size_t length) {
+  size_t i = 0;
+#if KRAKEN_UTF_SSE2
+  for (; i + 16 <= length; i += 16) {
+    int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+    if (mask != 0) return i + __builtin_ctz(mask);
+  }
+#elif KRAKEN_UTF_NEON
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + i))) >= 0x80) break;
+  }
+#else
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if ((word & 0x8080808080808080ULL) != 0) break;
+  }
+#endif
+  while (i < length && static_cast<unsigned char>(data[i]) < 0x80) i++;
+  return i;
+}
+
+size_t asciiPrefixLength(const char16_t *data, size_t length) {
+  size_t i = 0;
+#if KRAKEN_UTF_SSE2
+  const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= length; i += 8) {
+    __m128i units = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), nonASCII);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(units, zero)) != 0xFFFF) break;
+  }
+#elif KRAKEN_UTF_NEON
+  for (; i + 8 <= length; i += 8) {
+    if (vmaxvq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(data + i))) >= 0x80) break;
+  }
+#endif
+  while (i < length && data[i] < 0x80) i++;
+  return i;
+}
+
+size_t utf8ToUTF16(const char *data, size_t length, char16_t *output) {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+  size_t i = 0;
+  size_t o = 0;
+
+  while (i < length) {
+    if (bytes[i] < 0x80) {
+      // Same offset in input and output until the first non ASCII byte, afterwards shift the block copy.
+      size_t copied = copyASCIIBlocks(data + i, length - i, output + o);
+      i += copied;
+      o += copied;
+      while (i < length && bytes[i] < 0x80) output[o++] = bytes[i++];
+      continue;
+    }
+
+    unsigned char lead = bytes[i];
+    size_t needed;
+    uint32_t codePoint;
+    // Allowed range of the first continuation byte, rejects overlong forms, surrogates and values above U+10FFFF.
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      needed = 1;
+      codePoint = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      needed = 2;
+      codePoint = lead & 0x0F;
+      if (lead == 0xE0) lower = 0xA0;
+      if (lead == 0xED) upper = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      needed = 3;
+      codePoint = lead & 0x07;
+      if (lead == 0xF0) lower = 0x90;
+      if (lead == 0xF4) upper = 0x8F;
+    } else {
+      output[o++] = REPLACEMENT_CHARACTER;
+      i++;
+      continue;
+    }
+
+    size_t consumed = 1;
+    bool valid = true;
+    for (; consumed <= needed; consumed++) {
+      if (i + consumed >= length) {
+        valid = false;
+        break;
+      }
+      unsigned char c = bytes[i + consumed];
+      if (consumed == 1 ? (c < lower || c > upper) : !isContinuation(c)) {
+        valid = false;
+        break;
+      }
+      codePoint = (codePoint << 6) | (c & 0x3F);
+    }
+
+    i += consumed;
+    if (!valid) {
+      // A truncated sequence is replaced by one U+FFFD, the byte that broke it is decoded on its own.
+      output[o++] = REPLACEMENT_CHARACTER;
+    } else if (codePoint >= 0x10000) {
+      codePoint -= 0x10000;
+      output[o++] = static_cast<char16_t>(0xD800 + (codePoint >> 10));
+      output[o++] = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+    } else {
+      output[o++] = static_cast<char16_t>(codePoint);
+    }
+  }
+
+  return o;
+}
+
+void utf8ToUTF16(const char *data, size_t length, std::u16string &result) {
+  result.resize(length);
+  result.resize(utf8ToUTF16(data, length, &result[0]));
+}
+
+void utf16ToUTF8(const char16_t *data, size_t length, std::string &result) {
+  size_t asciiLength = asciiPrefixLength(data, length);
+  // ASCII strings are sized exactly, otherwise reserve the worst case of 3 bytes per remaining code unit.
+  result.resize(asciiLength + (length - asciiLength) * 3);
+  char *output = &result[0];
+  size_t i = copyASCIIBlocks(data, asciiLength, output);
+  size_t o = i;
+
+  while (i < length) {
+    char16_t unit = data[i];
+    if (unit < 0x80) {
+      size_t copied = copyASCIIBlocks(data + i, length - i, output + o);
+      i += copied;
+      o += copied;
+      while (i < length && data[i] < 0x80) output[o++] = static_cast<char>(data[i++]);
+      continue;
+    }
+
+    uint32_t codePoint = unit;
+    i++;
+    if (unit >= 0xD800 && unit <= 0xDBFF && i < length && data[i] >= 0xDC00 && data[i] <= 0xDFFF) {
+      codePoint = 0x10000 + ((unit - 0xD800) << 10) + (data[i] - 0xDC00);
+      i++;
+    } else if (unit >= 0xD800 && unit <= 0xDFFF) {
+      codePoint = REPLACEMENT_CHARACTER;
+    }
+
+    if (codePoint < 0x800) {
+      output[o++] = static_cast<char>(0xC0 | (codePoint >> 6));
+      output[o++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+      output[o++] = static_cast<char>(0xE0 | (codePoint >> 12));
+      output[o++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      output[o++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+      // A surrogate pair is 2 code units in and 4 bytes out, within the 3 bytes per unit budget.
+      output[o++] = static_cast<char>(0xF0 | (codePoint >> 18));
+      output[o++] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+      output[o++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      output[o++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+  }
+
+  result.resize(o);
+}
+
+} // namespace foundation
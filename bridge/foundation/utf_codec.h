@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_UTF_CODEC_H
+#define KRAKENBRIDGE_UTF_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace foundation {
+
+// UTF-8 <-> UTF-16 transcoding used wherever strings cross between JavaScriptCore (UTF-16), gumbo and std::string
+// based code (UTF-8) and dart (UTF-16). Most strings on these paths are ASCII, which is converted 16 bytes at a
+// time with SSE2 or NEON when available.
+//
+// Malformed input never fails: invalid UTF-8 sequences and unpaired surrogates are replaced with U+FFFD.
+
+// Length of the leading ASCII run.
+size_t asciiPrefixLength(const char *data, size_t length);
+size_t asciiPrefixLength(const char16_t *data, size_t length);
+
+// Replace the content of result with the converted string.
+void utf8ToUTF16(const char *data, size_t length, std::u16string &result);
+void utf16ToUTF8(const char16_t *data, size_t length, std::string &result);
+
+// Write the converted string into output, which must have room for at least length code units (UTF-8 to UTF-16
+// never produces more code units than input bytes). Returns the number of code units written.
+size_t utf8ToUTF16(const char *data, size_t length, char16_t *output);
+
+inline std::u16string utf8ToUTF16(const std::string &source) {
+  std::u16string result;
+  utf8ToUTF16(source.data(), source.length(), result);
+  return result;
+}
+
+inline std::string utf16ToUTF8(const std::u16string &source) {
+  std::string result;
+  utf16ToUTF8(source.data(), source.length(), result);
+  return result;
+}
+
+} // namespace foundation
+
+#endif // KRAKENBRIDGE_UTF_CODEC_H
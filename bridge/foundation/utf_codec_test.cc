@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "foundation/utf_codec.h"
+
+using namespace foundation;
+
+namespace {
+
+std::u16string decode(const std::string &source) {
+  return utf8ToUTF16(source);
+}
+
+std::string encode(const std::u16string &source) {
+  return utf16ToUTF8(source);
+}
+
+} // namespace
+
+TEST(UTFCodec, roundTripValidStrings) {
+  const std::u16string samples[] = {u"", u"kraken", u"café", u"你好，世界",
+                                    u"emoji \U0001F600 and \U0010FFFF", u"\u0080߿ࠀ￿\U00010000"};
+  for (auto &sample : samples) {
+    EXPECT_EQ(decode(encode(sample)), sample);
+  }
+  EXPECT_EQ(encode(u"\U0001F600"), "\xF0\x9F\x98\x80");
+  EXPECT_EQ(decode("\xE4\xBD\xA0"), u"你");
+}
+
+TEST(UTFCodec, replaceOverlongSequences) {
+  // '/' encoded in two, three and four bytes.
+  EXPECT_EQ(decode("\xC0\xAF"), u"��");
+  EXPECT_EQ(decode("\xE0\x80\xAF"), u"���");
+  EXPECT_EQ(decode("\xF0\x80\x80\xAF"), u"����");
+  // The smallest code points which need three and four bytes are accepted.
+  EXPECT_EQ(decode("\xE0\xA0\x80"), u"ࠀ");
+  EXPECT_EQ(decode("\xF0\x90\x80\x80"), u"\U00010000");
+}
+
+TEST(UTFCodec, replaceEncodedSurrogates) {
+  EXPECT_EQ(decode("\xED\xA0\x80"), u"���");
+  EXPECT_EQ(decode("\xED\xBF\xBF"), u"���");
+  EXPECT_EQ(decode("\xED\x9F\xBF"), u"퟿");
+  EXPECT_EQ(decode("\xEE\x80\x80"), u"");
+}
+
+TEST(UTFCodec, replaceCodePointsAboveUnicodeRange) {
+  EXPECT_EQ(decode("\xF4\x90\x80\x80"), u"����");
+  EXPECT_EQ(decode("\xF5\x80\x80\x80"), u"����");
+  EXPECT_EQ(decode("\xFF"), u"�");
+  EXPECT_EQ(decode("\xF4\x8F\xBF\xBF"), u"\U0010FFFF");
+}
+
+TEST(UTFCodec, replaceTruncatedSequences) {
+  // A truncated sequence becomes one replacement character, the byte which broke it is decoded on its own.
+  EXPECT_EQ(decode("\xE4\xBD"), u"�");
+  EXPECT_EQ(decode("\xF0\x9F\x98"), u"�");
+  EXPECT_EQ(decode("a\xC3"), u"a�");
+  EXPECT_EQ(decode("\xE4\xBD" "a"), u"�" u"a");
+  EXPECT_EQ(decode("\xF0\x9F\xE4\xBD\xA0"), u"�你");
+  EXPECT_EQ(decode("\x80\xBF"), u"��");
+}
+
+TEST(UTFCodec, replaceUnpairedSurrogates) {
+  EXPECT_EQ(encode(std::u16string(1, 0xD800)), "\xEF\xBF\xBD");
+  EXPECT_EQ(encode(std::u16string(1, 0xDC00)), "\xEF\xBF\xBD");
+  EXPECT_EQ(encode(std::u16string{u'a', 0xD83D, u'b'}), "a\xEF\xBF\xBD" "b");
+  // A low surrogate before a high one is not a pair.
+  EXPECT_EQ(encode(std::u16string{0xDE00, 0xD83D}), "\xEF\xBF\xBD\xEF\xBF\xBD");
+  EXPECT_EQ(encode(std::u16string{0xD83D, 0xDE00}), "\xF0\x9F\x98\x80");
+}
+
+// The block copies handle 16 units per step, a non ASCII character at every offset around the block boundaries
+// must come out at the same position as with the scalar tail.
+TEST(UTFCodec, convertAroundSIMDBlockBoundaries) {
+  for (size_t length = 0; length <= 48; length++) {
+    std::string ascii;
+    std::u16string asciiUTF16;
+    for (size_t i = 0; i < length; i++) {
+      ascii.push_back(static_cast<char>('a' + i % 26));
+      asciiUTF16.push_back(static_cast<char16_t>('a' + i % 26));
+    }
+    EXPECT_EQ(decode(ascii), asciiUTF16) << "length " << length;
+    EXPECT_EQ(encode(asciiUTF16), ascii) << "length " << length;
+    EXPECT_EQ(asciiPrefixLength(ascii.data(), ascii.length()), length);
+    EXPECT_EQ(asciiPrefixLength(asciiUTF16.data(), asciiUTF16.length()), length);
+
+    for (size_t position = 0; position < length; position++) {
+      std::string utf8 = ascii.substr(0, position) + "\xE4\xBD\xA0" + ascii.substr(position);
+      std::u16string utf16 = asciiUTF16.substr(0, position) + u"你" + asciiUTF16.substr(position);
+      EXPECT_EQ(decode(utf8), utf16) << "length " << length << " position " << position;
+      EXPECT_EQ(encode(utf16), utf8) << "length " << length << " position " << position;
+      EXPECT_EQ(asciiPrefixLength(utf8.data(), utf8.length()), position);
+      EXPECT_EQ(asciiPrefixLength(utf16.data(), utf16.length()), position);
+
+      // A truncated sequence at the very end of the buffer, right after a block.
+      EXPECT_EQ(decode(ascii.substr(0, position) + "\xE4\xBD"), asciiUTF16.substr(0, position) + u"�");
+    }
+  }
+}
+
+TEST(UTFCodec, writeIntoCallerBuffer) {
+  std::string source = "0123456789abcdef\xC3\xA9";
+  std::u16string output(source.length(), u'\0');
+  size_t written = utf8ToUTF16(source.data(), source.length(), &output[0]);
+  EXPECT_EQ(written, 17u);
+  EXPECT_EQ(output.substr(0, written), u"0123456789abcdefé");
+}
@@ -11,6 +11,7 @@
 #ifdef ENABLE_TEST
 #include "kraken_bridge_test.h"
 #endif
+#include <atomic>
 #include <memory>
 #include <thread>
 
@@ -42,6 +43,7 @@ typedef void (*FlushUICommand)();
 typedef void (*InitHTML)(int32_t contextId, void *nativePtr);
 typedef void (*InitWindow)(int32_t contextId, void *nativePtr);
 typedef void (*InitDocument)(int32_t contextId, void *nativePtr);
+typedef void (*OnHTMLConstructed)(int32_t contextId);
 
 using MatchImageSnapshotCallback = void (*)(void *callbackContext, int32_t contextId, int8_t);
 using MatchImageSnapshot = void (*)(void *callbackContext, int32_t contextId, uint8_t *bytes, int32_t length,
@@ -92,6 +94,20 @@ struct DartMethodPointer {
   InitHTML initHTML{nullptr};
   InitWindow initWindow{nullptr};
   InitDocument initDocument{nullptr};
+  OnHTMLConstructed onHTMLConstructed{nullptr};
+};
+
+// Calls made from the bridge into dart since the process started, shared by all contexts because some methods,
+// like flushUICommand, are not bound to a context.
+struct DartMethodCallCounts {
+  std::atomic<int64_t> invokeModule{0};
+  std::atomic<int64_t> requestBatchUpdate{0};
+  std::atomic<int64_t> setTimeout{0};
+  std::atomic<int64_t> setInterval{0};
+  std::atomic<int64_t> clearTimeout{0};
+  std::atomic<int64_t> requestAnimationFrame{0};
+  std::atomic<int64_t> cancelAnimationFrame{0};
+  std::atomic<int64_t> flushUICommand{0};
 };
 
 void registerDartMethods(uint64_t *methodBytes, int32_t length);
@@ -104,6 +120,9 @@ void registerTestEnvDartMethods(uint64_t *methodBytes, int32_t length);
 KRAKEN_EXPORT
 std::shared_ptr<DartMethodPointer> getDartMethod();
 
+KRAKEN_EXPORT
+DartMethodCallCounts &getDartMethodCallCounts();
+
 } // namespace kraken
 
 #endif
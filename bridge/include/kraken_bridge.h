@@ -21,6 +21,9 @@
 
 KRAKEN_EXPORT
 std::__thread_id getUIThreadId();
+// Dart methods are only handed out on this thread, initJSContextPool registers the thread it runs on.
+KRAKEN_EXPORT
+void setUIThreadId(std::__thread_id threadId);
 
 struct KRAKEN_EXPORT NativeString {
   const uint16_t *string;
@@ -59,6 +62,7 @@ enum UICommand {
   removeProperty,
   cloneNode,
   removeEvent,
+  canvasDisplayList,
 };
 
 struct KRAKEN_EXPORT UICommandItem {
@@ -84,11 +88,36 @@ typedef void (*Task)(void *);
 typedef void (*ConsoleMessageHandler)(void* ctx, const std::string &message, int logLevel);
 
 KRAKEN_EXPORT_C
-void initJSContextPool(int poolSize);
+// uiCommandEncoding: UI_COMMAND_ENCODING_STRUCT (0) or UI_COMMAND_ENCODING_COMPACT (1).
+void initJSContextPool(int poolSize, int32_t uiCommandEncoding);
 KRAKEN_EXPORT_C
 void disposeContext(int32_t contextId);
 KRAKEN_EXPORT_C
 int32_t allocateNewContext(int32_t targetContextId);
+// Create bridges constructed afterwards on the calling thread in one shared JSContextGroup, so they share one
+// JavaScriptCore VM, heap and JIT code cache. Call before initJSContextPool to apply it to every bridge.
+KRAKEN_EXPORT_C
+void setSharedJSContextGroupEnabled(int32_t enabled);
+// Whether bridges constructed afterwards create rarely used constructors on their first global lookup, enabled by
+// default.
+KRAKEN_EXPORT_C
+void setLazyBindingEnabled(int32_t enabled);
+// Whether functions with private data share one JSClassRef per callback and name, enabled by default.
+KRAKEN_EXPORT_C
+void setFunctionClassCacheEnabled(int32_t enabled);
+// Whether property names of host objects are converted once per context and cached, enabled by default.
+KRAKEN_EXPORT_C
+void setPropertyNameCacheEnabled(int32_t enabled);
+// Whether canvas 2d ops are recorded into display lists and replayed once per flush, enabled by default.
+KRAKEN_EXPORT_C
+void setCanvasDisplayListEnabled(int32_t enabled);
+// Number of fully constructed spare bridges to keep, allocateNewContext hands them out without construction cost.
+KRAKEN_EXPORT_C
+void setPrewarmedContextCount(int32_t count);
+// Construct at most one spare bridge on the calling (ui) thread. Returns how many spares are still missing, the
+// embedder calls it again from its next idle slot while the result is positive.
+KRAKEN_EXPORT_C
+int32_t prewarmContext();
 KRAKEN_EXPORT_C
 void *getJSContext(int32_t contextId);
 bool checkContext(int32_t contextId);
@@ -97,11 +126,19 @@ KRAKEN_EXPORT_C
 void evaluateScripts(int32_t contextId, NativeString *code, const char *bundleFilename, int startLine);
 KRAKEN_EXPORT_C
 void parseHTML(int32_t contextId, NativeString *code, const char *bundleFilename);
+// Feed a document chunk by chunk as it is received. Nothing is parsed before the chunk with isFinal set, which
+// returns after the first slice of DOM construction, the remaining slices run in the following frames.
+KRAKEN_EXPORT_C
+void parseHTMLChunk(int32_t contextId, NativeString *chunk, const char *bundleFilename, int32_t isFinal);
 KRAKEN_EXPORT_C
 void reloadJsContext(int32_t contextId);
 KRAKEN_EXPORT_C
 void invokeModuleEvent(int32_t contextId, NativeString *module, const char *eventType, void *event,
                        NativeString *extra);
+// Geometry cached by elements is read again after this. Dart calls it whenever layout or scroll offsets may have
+// changed without an event reaching the bridge.
+KRAKEN_EXPORT_C
+void invalidateLayout(int32_t contextId);
 KRAKEN_EXPORT_C
 void registerDartMethods(uint64_t *methodBytes, int32_t length);
 KRAKEN_EXPORT_C
@@ -113,6 +150,8 @@ void dispatchUITask(int32_t contextId, void *context, void *callback);
 KRAKEN_EXPORT_C
 void flushUITask(int32_t contextId);
 KRAKEN_EXPORT_C
+int64_t flushUITaskWithBudget(int32_t contextId, int64_t budgetMicroseconds);
+KRAKEN_EXPORT_C
 void registerUITask(int32_t contextId, Task task, void *data);
 KRAKEN_EXPORT_C
 void flushUICommandCallback();
@@ -121,8 +160,37 @@ UICommandItem *getUICommandItems(int32_t contextId);
 KRAKEN_EXPORT_C
 int64_t getUICommandItemSize(int32_t contextId);
 KRAKEN_EXPORT_C
+uint8_t *getUICommandBytes(int32_t contextId);
+KRAKEN_EXPORT_C
+int64_t getUICommandByteLength(int32_t contextId);
+KRAKEN_EXPORT_C
 void clearUICommandItems(int32_t contextId);
 KRAKEN_EXPORT_C
+void publishUICommandItems(int32_t contextId);
+KRAKEN_EXPORT_C
+void releaseUICommandItems(int32_t contextId);
+KRAKEN_EXPORT_C
+void setUICommandCoalescing(int32_t contextId, int32_t enabled);
+KRAKEN_EXPORT_C
+int64_t getUICommandCoalescedCount(int32_t contextId);
+KRAKEN_EXPORT_C
+void setNativeTimerQueue(int32_t contextId, int32_t enabled);
+KRAKEN_EXPORT_C
+void setTraceEnabled(int32_t enabled);
+KRAKEN_EXPORT_C
+void clearTraceEvents();
+// Returns recorded trace events as Chrome trace event JSON. The caller owns the buffer and releases it with free().
+KRAKEN_EXPORT_C
+char *exportTraceEvents();
+// Returns ui command, dart call, startup, html parser and script cache statistics of the context as JSON. The caller owns the buffer and releases it
+// with free().
+KRAKEN_EXPORT_C
+char *getBridgeStats(int32_t contextId);
+KRAKEN_EXPORT_C
+void resetBridgeStats(int32_t contextId);
+KRAKEN_EXPORT_C
+NativeString *getUICommandAtom(int32_t contextId, int32_t atomId);
+KRAKEN_EXPORT_C
 void registerContextDisposedCallbacks(int32_t contextId, Task task, void *data);
 KRAKEN_EXPORT_C
 void registerPluginSource(NativeString* code, const char *pluginName);
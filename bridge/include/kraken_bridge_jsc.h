@@ -16,6 +16,7 @@
 #include <cassert>
 #include <functional>
 #include <map>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <forward_list>
@@ -47,6 +48,8 @@ class JSDocument;
 class DocumentCookie;
 class DocumentInstance;
 struct NativeDocument;
+class JSAllCollection;
+class JSHTMLCollection;
 class CSSStyleDeclaration;
 class JSElementAttributes;
 class JSElement;
@@ -63,6 +66,10 @@ struct NativeGestureEvent;
 class GestureEventInstance;
 struct NativeMouseEvent;
 class MouseEventInstance;
+class EventPayloadPool;
+class EventTypeAtoms;
+struct NativeInputEvent;
+struct NativeTouchEvent;
 
 class JSContext {
 public:
@@ -70,13 +77,19 @@ public:
   static std::vector<JSStaticValue> globalValue;
 
   JSContext() = delete;
-  JSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner);
+  JSContext(int32_t contextId, const JSExceptionHandler &handler, void *owner,
+            const JSStaticValue *lazyGlobalValues = nullptr);
   ~JSContext();
 
+  // The context whose global object ctx belongs to, nullptr once it was released.
+  static JSContext *fromGlobalContext(JSContextRef ctx);
+
   KRAKEN_EXPORT bool evaluateJavaScript(const uint16_t *code, size_t codeLength, const char *sourceURL, int startLine);
   KRAKEN_EXPORT bool evaluateJavaScript(const char16_t *code, size_t length, const char *sourceURL, int startLine);
 
   KRAKEN_EXPORT bool isValid();
+  // Whether this context shares its VM with the other contexts of the thread's shared context group.
+  KRAKEN_EXPORT bool isInSharedGroup();
 
   KRAKEN_EXPORT JSObjectRef global();
   KRAKEN_EXPORT JSGlobalContextRef context();
@@ -89,29 +102,105 @@ public:
 
   KRAKEN_EXPORT void reportError(const char *errmsg);
 
+  // Convert property names of host objects once and share them with all later property access. Names
+  // returned are shared and must not be modified. Once the cache is full, names are converted into the caller
+  // owned storage instead, so a property access nested in another one never overwrites its name.
+  KRAKEN_EXPORT std::string &getPropertyName(JSStringRef propertyName, std::string &storage);
+
+  // Native payloads of finalized events, reused by events created from script in this context.
+  EventPayloadPool *eventPayloadPool();
+  // Event types script listens to in this context.
+  EventTypeAtoms *eventTypeAtoms();
+
+  // UI commands of this context, resolved once so recording a command never looks the buffer up again.
+  foundation::UICommandBuffer *uiCommandBuffer() {
+    return m_uiCommandBuffer;
+  }
+
   std::chrono::time_point<std::chrono::system_clock> timeOrigin;
 
   int32_t uniqueId;
 
 private:
+  // Dynamic property names such as expando keys are not cached after this size.
+  static constexpr size_t MAX_PROPERTY_NAME_CACHE_SIZE = 2048;
+  std::unordered_map<std::string_view, std::unique_ptr<std::string>> m_propertyNames;
+  std::unique_ptr<EventPayloadPool> m_eventPayloadPool;
+  std::unique_ptr<EventTypeAtoms> m_eventTypeAtoms;
+  foundation::UICommandBuffer *m_uiCommandBuffer;
   int32_t contextId;
   JSExceptionHandler _handler;
   void *owner;
   std::atomic<bool> ctxInvalid_{false};
+  bool m_sharedGroup{false};
   JSGlobalContextRef ctx_;
+
+  friend void disposeJSContext(std::unique_ptr<JSContext> &context);
 };
 
 class HTMLParser {
 public:
+  // Time a construction slice may spend appending nodes, the rest of the document is appended in later frames.
+  static constexpr int64_t SLICE_BUDGET_US = 8000;
+
+  struct Stats {
+    int64_t slices{0};
+    int64_t nodes{0};
+    int64_t maxSliceUs{0};
+  };
+
   HTMLParser(std::unique_ptr<JSContext> &context, const JSExceptionHandler &handler, void *owner);
+  ~HTMLParser();
+  // Parse a whole document and append it to body before returning.
   KRAKEN_EXPORT bool parseHTML(const uint16_t *code, size_t codeLength);
+  // Streaming variant of parseHTML. Chunks are buffered as they arrive, the final chunk parses the document and
+  // appends it to body in time budgeted slices, one per frame. Scripts run in document order as they are appended.
+  // Dart is notified through onHTMLConstructed once the last slice ran, or right away when the document has no body.
+  KRAKEN_EXPORT bool parseHTMLChunk(const uint16_t *chunk, size_t chunkLength, bool isFinal);
+  // Whether nodes of the last parsed document are still waiting for a slice.
+  bool isConstructing() const {
+    return m_output != nullptr;
+  }
+  const Stats &stats() const {
+    return m_stats;
+  }
 
 private:
+  // An element whose gumbo children are being appended, in document order from childIndex.
+  struct ConstructionFrame {
+    GumboNode *node;
+    ElementInstance *element;
+    unsigned int childIndex;
+  };
+
+  static void handleFrame(void *ptr, int32_t contextId, double highResTimeStamp, const char *errmsg);
+
   std::unique_ptr<JSContext> &m_context;
   JSExceptionHandler _handler;
   void *owner;
 
-  void traverseHTML(GumboNode * node, ElementInstance* element);
+  // UTF-8 source of the document being received, and a high surrogate held back from the end of the last chunk.
+  std::string m_source;
+  char16_t m_pendingHighSurrogate{0};
+  // Source and parse tree of the document being appended.
+  std::string m_parsedSource;
+  GumboOutput *m_output{nullptr};
+  std::vector<ConstructionFrame> m_stack;
+  uintptr_t m_armedFrame{0};
+  // Whether dart waits for the document being appended, which was received by parseHTMLChunk.
+  bool m_notifyConstructed{false};
+  Stats m_stats;
+
+  void appendSource(const uint16_t *chunk, size_t chunkLength, bool isFinal);
+  bool beginConstruction(std::string &&source);
+  // Append nodes until the stack is empty or budgetUs is spent, a negative budget appends everything. Returns
+  // whether the document is complete.
+  bool construct(int64_t budgetUs);
+  void constructNode(ElementInstance *parent, GumboNode *node);
+  void pushFrame(GumboNode *node, ElementInstance *element);
+  void runSlice();
+  void finishConstruction();
+  bool arm();
 
   void parseProperty(ElementInstance* element, GumboElement * gumboElement);
 };
@@ -165,6 +254,8 @@ private:
   KRAKEN_DISALLOW_COPY_ASSIGN_AND_MOVE(JSValueHolder);
 };
 
+// Arguments built here borrow their characters from the input string or a thread local scratch buffer,
+// pass them to UICommandBuffer::addCommand right away which copies them into the ui command arena.
 void KRAKEN_EXPORT buildUICommandArgs(JSStringRef key, NativeString &args_01);
 void KRAKEN_EXPORT buildUICommandArgs(std::string &key, NativeString &args_01);
 void KRAKEN_EXPORT buildUICommandArgs(std::string &key, JSStringRef value, NativeString &args_01,
@@ -180,6 +271,12 @@ KRAKEN_EXPORT NativeString *stringRefToNativeString(JSStringRef string);
 
 KRAKEN_EXPORT JSObjectRef makeObjectFunctionWithPrivateData(JSContext *context, void *data, const char *name,
                                                 JSObjectCallAsFunctionCallback callback);
+// Function classes are shared per (callback, name) by default. Disabling the cache creates a class for every
+// function again, benchmarks use it to compare against the uncached path.
+void setFunctionClassCacheEnabled(bool enabled);
+// Property names are cached per context by default. Disabling the cache converts every name again, benchmarks use it
+// to compare against the uncached path.
+void setPropertyNameCacheEnabled(bool enabled);
 
 KRAKEN_EXPORT JSObjectRef JSObjectMakePromise(JSContext *context, void *data, JSObjectCallAsFunctionCallback callback,
                                   JSValueRef *exception);
@@ -199,6 +296,9 @@ public:
   HostObject(JSContext *context, std::string name);
   std::string name;
 
+  // Number of host objects which reused a cached JSClassRef, and number of class definitions created.
+  static void getClassCacheStats(int64_t *hits, int64_t *misses);
+
   JSContext *context;
   int32_t contextId;
   JSObjectRef jsObject;
@@ -276,6 +376,7 @@ public:
   HostClass(JSContext *context, HostClass *parentHostClass, std::string name, const JSStaticFunction *staticFunction,
             const JSStaticValue *staticValue);
 
+  // Property names passed to getProperty/setProperty come from JSContext::getPropertyName, copy them before modifying.
   KRAKEN_EXPORT virtual JSValueRef getProperty(std::string &name, JSValueRef *exception);
   KRAKEN_EXPORT virtual JSValueRef prototypeGetProperty(std::string &name, JSValueRef *exception);
 
@@ -310,6 +411,11 @@ public:
   static JSObjectRef getProto(JSContextRef ctx, JSObjectRef child, JSValueRef *exception);
   static void setProto(JSContextRef ctx, JSObjectRef prototype, JSObjectRef child, JSValueRef *exception);
 
+  // Class of prototype objects holding the methods of a host class as static functions, created once per process.
+  // Methods of parent classes are reached through parentClass.
+  static JSClassRef getPrototypeClassRef(const char *className, JSClassRef parentClass,
+                                         const JSStaticFunction *staticFunctions);
+
   std::string _name{""};
   JSContext *context{nullptr};
   int32_t contextId;
@@ -322,9 +428,16 @@ public:
   JSObjectRef prototypeObject{nullptr};
   JSObjectRef _call{nullptr};
 
+protected:
+  // Back prototypeObject by a class from getPrototypeClassRef and make it the prototype of instances created
+  // afterwards. JSC resolves methods from the static tables and caches the created functions on the prototype, so
+  // method lookups of instances no longer go through getProperty. Only called by constructors of host classes.
+  void setPrototypeClass(JSClassRef prototypeClass);
+
 private:
   // The class template of javascript constructor function.
   JSClassRef jsClass{nullptr};
+  JSClassRef _prototypeClass{nullptr};
   HostClass *_parentHostClass{nullptr};
 };
 
@@ -399,6 +512,26 @@ private:
   JSFunctionHolder m_preventDefault{context, prototypeObject, this, "preventDefault", preventDefault};
 };
 
+// Event types interned to small integers per context, so dispatching compares integers instead of converting
+// strings. Only types a listener is registered for are interned, all other paths look types up without inserting
+// and get NOT_INTERNED, which no listener can be registered for.
+class EventTypeAtoms {
+public:
+  static constexpr int32_t NOT_INTERNED = -1;
+
+  int32_t intern(const uint16_t *string, size_t length);
+  int32_t intern(const std::string &eventType);
+  int32_t find(const uint16_t *string, size_t length) const;
+  // Lookup with the UTF-8 type of script created events and on* properties, no conversion needed.
+  int32_t find(const std::string &eventType) const;
+
+private:
+  // Keys point to the strings in m_eventTypes, which live as long as the context.
+  std::deque<std::u16string> m_eventTypes;
+  std::unordered_map<std::u16string_view, int32_t> m_atoms;
+  std::unordered_map<std::string, int32_t> m_utf8Atoms;
+};
+
 class EventInstance : public HostClass::Instance {
 public:
   EventInstance() = delete;
@@ -409,7 +542,14 @@ public:
   bool setProperty(std::string &name, JSValueRef value, JSValueRef *exception) override;
   void getPropertyNames(JSPropertyNameAccumulatorRef accumulator) override;
   ~EventInstance() override;
+  // Replaces the event type when events are initialized again from script, keeping eventTypeAtom in sync.
+  void setType(NativeString *type);
+  // Listeners may be registered after the event was created, look the type up again if it had none then.
+  int32_t resolveEventTypeAtom();
   NativeEvent *nativeEvent;
+  // Whether the payloads came from the payload pool and go back to it once the event is finalized.
+  bool pooledPayload{false};
+  int32_t eventTypeAtom{EventTypeAtoms::NOT_INTERNED};
   bool _cancelled{false};
   bool _propagationStopped{false};
   bool _propagationImmediatelyStopped{false};
@@ -432,6 +572,49 @@ struct NativeEvent {
   void *currentTarget{nullptr};
 };
 
+// Native payloads of finalized script created events, handed out again to events created from script. Payloads
+// dart allocated are freed as before. Events are only released by the garbage collector, so no payload script can
+// still reach is recycled. Type strings stay attached to their
+// payload, a payload released by an event of the same type is preferred so neither needs to be allocated.
+class EventPayloadPool {
+public:
+  struct Stats {
+    // Payloads taken from the pool and payloads allocated because none was pooled, counted per payload struct.
+    int64_t hits{0};
+    int64_t misses{0};
+    // Payloads returned by finalized events, and payloads freed instead because the pool was full.
+    int64_t recycled{0};
+    int64_t dropped{0};
+  };
+
+  // Cap of each list, event, input event and touch event payloads are pooled separately.
+  static constexpr size_t MAX_POOLED_EVENTS = 64;
+
+  EventPayloadPool() = default;
+  ~EventPayloadPool();
+
+  // A payload of eventType with every other field reset.
+  NativeEvent *acquireEvent(std::string &eventType);
+  // Takes ownership of the payload and its type string.
+  void releaseEvent(NativeEvent *nativeEvent);
+  NativeInputEvent *acquireInputEvent(NativeEvent *nativeEvent);
+  // Strings of the payload must be released already.
+  void releaseInputEvent(NativeInputEvent *nativeInputEvent);
+  NativeTouchEvent *acquireTouchEvent(NativeEvent *nativeEvent);
+  // Touches of the payload must be released already.
+  void releaseTouchEvent(NativeTouchEvent *nativeTouchEvent);
+
+  const Stats &stats() const {
+    return m_stats;
+  }
+
+private:
+  std::vector<NativeEvent *> m_events;
+  std::vector<NativeInputEvent *> m_inputEvents;
+  std::vector<NativeTouchEvent *> m_touchEvents;
+  Stats m_stats;
+};
+
 class JSEventTarget : public HostClass {
 public:
   static std::unordered_map<JSContext *, JSEventTarget *> instanceMap;
@@ -450,6 +633,14 @@ public:
 
   JSValueRef prototypeGetProperty(std::string &name, JSValueRef *exception) override;
 
+  static JSClassRef prototypeClass();
+
+  // Whether any event target of this context listens to the event type.
+  bool hasEventListeners(int32_t eventTypeAtom);
+  // Listeners and property handlers registered for the event type by all event targets of this context.
+  int32_t eventListenerCount(int32_t eventTypeAtom);
+  void updateEventListenerCount(int32_t eventTypeAtom, int32_t delta);
+
 protected:
   JSEventTarget() = delete;
   friend EventTargetInstance;
@@ -460,6 +651,8 @@ protected:
 
 private:
   std::vector<std::string> m_jsOnlyEvents;
+  // Listeners and property handlers of all event targets, indexed by event type atom.
+  std::vector<int32_t> m_eventListenerCounts;
 
   static JSValueRef addEventListener(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject,
                                      size_t argumentCount, const JSValueRef arguments[], JSValueRef *exception);
@@ -470,12 +663,7 @@ private:
   static JSValueRef clearListeners(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
                                    const JSValueRef arguments[], JSValueRef *exception);
 
-  JSFunctionHolder m_removeEventListener{context, prototypeObject, nullptr, "removeEventListener", removeEventListener};
-  JSFunctionHolder m_dispatchEvent{context, prototypeObject, nullptr, "dispatchEvent", dispatchEvent};
-  JSFunctionHolder m_addEventListener{context, prototypeObject, nullptr, "addEventListener", addEventListener};
-  #ifdef IS_TEST
-  JSFunctionHolder m_clearListeners{context, prototypeObject, nullptr, "__kraken_clear_event_listeners__", clearListeners};
-  #endif
+  static const JSStaticFunction prototypeStaticFunctions[];
 };
 
 class EventTargetInstance : public HostClass::Instance {
@@ -489,6 +677,10 @@ public:
   JSValueRef getPropertyHandler(std::string &name, JSValueRef *exception);
   void setPropertyHandler(std::string &name, JSValueRef value, JSValueRef *exception);
   bool dispatchEvent(EventInstance *event);
+  // Whether this target or one of its ancestors listens to the event type.
+  bool hasEventListener(int32_t eventTypeAtom);
+  // The next target of bubbling events.
+  virtual EventTargetInstance *parentEventTarget();
 
   ~EventTargetInstance() override;
   int32_t eventTargetId;
@@ -496,25 +688,43 @@ public:
 
 private:
   friend JSEventTarget;
-  // TODO: use std::u16string for better performance.
-  std::unordered_map<std::string, std::forward_list<JSObjectRef>> _eventHandlers;
-  std::unordered_map<std::string, JSObjectRef> _propertyEventHandler;
+
+  struct EventHandlers {
+    int32_t eventTypeAtom;
+    // Shared with dispatches in progress, a shared list is copied before modified. Null until the first
+    // addEventListener of this type.
+    std::shared_ptr<std::vector<JSObjectRef>> listeners;
+    JSObjectRef propertyHandler{nullptr};
+  };
+
+  EventHandlers *getEventHandlers(int32_t eventTypeAtom);
+  EventHandlers &ensureEventHandlers(int32_t eventTypeAtom);
+  std::vector<JSObjectRef> &mutableListeners(EventHandlers &handlers);
+  bool hasEventListeners();
+
+  // Event targets only listen to a few types, scanning a flat vector is faster than hashing.
+  std::vector<EventHandlers> _eventHandlers;
   bool internalDispatchEvent(EventInstance *eventInstance);
 };
 
 using NativeDispatchEvent = void (*)(NativeEventTarget *nativeEventTarget, NativeString *eventType, void *nativeEvent,
                                      int32_t isCustomEvent);
+using NativeHasEventListener = int32_t (*)(NativeEventTarget *nativeEventTarget, NativeString *eventType);
 
 struct NativeEventTarget {
   NativeEventTarget() = delete;
   NativeEventTarget(EventTargetInstance *_instance)
-    : instance(_instance), dispatchEvent(NativeEventTarget::dispatchEventImpl){};
+    : instance(_instance), dispatchEvent(NativeEventTarget::dispatchEventImpl),
+      hasEventListener(NativeEventTarget::hasEventListenerImpl){};
 
   KRAKEN_EXPORT static void dispatchEventImpl(NativeEventTarget *nativeEventTarget, NativeString *eventType,
                                               void *nativeEvent, int32_t isCustomEvent);
+  // Dart checks it before building native events, events nobody listens to never reach JS.
+  KRAKEN_EXPORT static int32_t hasEventListenerImpl(NativeEventTarget *nativeEventTarget, NativeString *eventType);
 
   EventTargetInstance *instance;
   NativeDispatchEvent dispatchEvent;
+  NativeHasEventListener hasEventListener;
 };
 
 enum NodeType {
@@ -561,18 +771,15 @@ public:
 
   JSValueRef prototypeGetProperty(std::string &name, JSValueRef *exception) override;
 
+  static JSClassRef prototypeClass();
+
 protected:
   JSNode() = delete;
   explicit JSNode(JSContext *context);
   explicit JSNode(JSContext *context, const char *name);
   ~JSNode();
 
-  JSFunctionHolder m_cloneNode{context, prototypeObject, this, "cloneNode", cloneNode};
-  JSFunctionHolder m_removeChild{context, prototypeObject, this, "removeChild", removeChild};
-  JSFunctionHolder m_appendChild{context, prototypeObject, this, "appendChild", appendChild};
-  JSFunctionHolder m_remove{context, prototypeObject, this, "remove", remove};
-  JSFunctionHolder m_insertBefore{context, prototypeObject, this, "insertBefore", insertBefore};
-  JSFunctionHolder m_replaceChild{context, prototypeObject, this, "replaceChild", replaceChild};
+  static const JSStaticFunction prototypeStaticFunctions[];
 
 private:
   friend NodeInstance;
@@ -580,6 +787,49 @@ private:
   static JSValueRef copyNodeValue(JSContextRef ctx, NodeInstance* element);
 };
 
+// Children of a node linked through their sibling pointers, so sibling navigation and child mutation are O(1).
+// Index access is served from a vector rebuilt lazily after the list changed, the childNodes getter from a frozen
+// JS array released as soon as the list changes.
+class ChildNodeList {
+public:
+  class iterator {
+  public:
+    explicit iterator(NodeInstance *node) : m_node(node){};
+    NodeInstance *const &operator*() const { return m_node; }
+    iterator &operator++();
+    bool operator!=(const iterator &other) const { return m_node != other.m_node; }
+
+  private:
+    NodeInstance *m_node;
+  };
+
+  iterator begin() const { return iterator(m_first); }
+  iterator end() const { return iterator(nullptr); }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  NodeInstance *front() const { return m_first; }
+  NodeInstance *back() const { return m_last; }
+  NodeInstance *operator[](size_t index);
+
+  void append(NodeInstance *node);
+  // Insert node before referenceNode, which must be in this list.
+  void insertBefore(NodeInstance *node, NodeInstance *referenceNode);
+  void remove(NodeInstance *node);
+
+  JSObjectRef array(JSContextRef ctx);
+  // Called by mutations, and by the owner while its context is still valid.
+  void releaseArray();
+
+private:
+  NodeInstance *m_first{nullptr};
+  NodeInstance *m_last{nullptr};
+  size_t m_size{0};
+  std::vector<NodeInstance *> m_indexCache;
+  bool m_indexCacheValid{false};
+  JSContextRef m_arrayContext{nullptr};
+  JSObjectRef m_array{nullptr};
+};
+
 class NodeInstance : public EventTargetInstance {
 public:
   NodeInstance() = delete;
@@ -590,6 +840,7 @@ public:
   JSValueRef getProperty(std::string &name, JSValueRef *exception) override;
   bool setProperty(std::string &name, JSValueRef value, JSValueRef *exception) override;
   void getPropertyNames(JSPropertyNameAccumulatorRef accumulator) override;
+  EventTargetInstance *parentEventTarget() override;
 
   bool isConnected();
   DocumentInstance *ownerDocument();
@@ -607,7 +858,7 @@ public:
 
   NodeType nodeType;
   NodeInstance *parentNode{nullptr};
-  std::vector<NodeInstance *> childNodes;
+  ChildNodeList childNodes;
 
   NativeNode *nativeNode{nullptr};
 
@@ -622,9 +873,13 @@ public:
 
 private:
   DocumentInstance *m_document{nullptr};
+  // Maintained by parent's ChildNodeList.
+  NodeInstance *m_previousSibling{nullptr};
+  NodeInstance *m_nextSibling{nullptr};
   void ensureDetached(NodeInstance *node);
   friend DocumentInstance;
   friend JSNode;
+  friend ChildNodeList;
 };
 
 struct NativeNode {
@@ -692,6 +947,29 @@ struct NativeDocument {
   NativeNode *nativeNode;
 };
 
+struct ElementIndexLink {
+  ElementInstance *previous{nullptr};
+  ElementInstance *next{nullptr};
+};
+
+// Connected elements sharing the same tag name or id, linked through an ElementIndexLink member of ElementInstance.
+// Members are kept in no particular order, tree order is computed by the callers which needs it.
+class ElementIndexList {
+public:
+  using Link = ElementIndexLink ElementInstance::*;
+
+  void add(ElementInstance *element, Link link);
+  void remove(ElementInstance *element, Link link);
+
+  inline ElementInstance *front() { return m_head; }
+  inline size_t size() { return m_size; }
+  inline bool empty() { return m_size == 0; }
+
+private:
+  ElementInstance *m_head{nullptr};
+  size_t m_size{0};
+};
+
 class DocumentInstance : public NodeInstance {
 public:
   DEFINE_OBJECT_PROPERTY(Document, 4, nodeName, all, cookie, documentElement);
@@ -707,16 +985,40 @@ public:
   KRAKEN_EXPORT bool setProperty(std::string &name, JSValueRef value, JSValueRef *exception) override;
   KRAKEN_EXPORT void getPropertyNames(JSPropertyNameAccumulatorRef accumulator) override;
 
-  void removeElementById(JSValueRef id, ElementInstance *element);
-  void addElementById(JSValueRef id, ElementInstance *element);
+  // Keep indexes of connected elements up to date, called when elements are connected or disconnected.
+  void indexElement(ElementInstance *element);
+  void unindexElement(ElementInstance *element);
+  void updateElementId(ElementInstance *element, JSValueRef id);
+
+  ElementInstance *getElementById(const std::string &id);
+  // Collections are cached until the last connected element of their tag is disconnected.
+  JSHTMLCollection *getElementsByTagName(const std::string &tagName);
+  // Append connected elements with tagName in tree order, "*" matches all elements.
+  void collectElementsByTagName(const std::string &tagName, std::vector<ElementInstance *> &elements);
+  size_t countElementsByTagName(const std::string &tagName);
+
+  // Changed every time the indexes changed, collections use it to check whether their elements are outdated.
+  inline uint64_t elementIndexVersion() { return m_elementIndexVersion; }
 
   NativeDocument *nativeDocument;
-  std::unordered_map<std::string, std::vector<ElementInstance *>> elementMapById;
 
   ElementInstance *documentElement;
 
 private:
+  template <typename Predicate>
+  void collectElements(size_t expectedCount, std::vector<ElementInstance *> &elements, Predicate predicate);
+  // Array methods which do not mutate and Symbol.iterator shared by all HTMLCollection objects of the document.
+  JSObjectRef htmlCollectionPrototype();
+
   DocumentCookie m_cookie;
+  std::unordered_map<std::string, ElementIndexList> m_elementsByTagName;
+  std::unordered_map<std::string, ElementIndexList> m_elementsById;
+  size_t m_elementCount{0};
+  uint64_t m_elementIndexVersion{1};
+  std::unordered_map<std::string, JSHTMLCollection *> m_collectionsByTagName;
+  JSObjectRef m_htmlCollectionPrototype{nullptr};
+  JSAllCollection *m_allCollection{nullptr};
+  uint64_t m_allCollectionVersion{0};
   friend NodeInstance;
 };
 
@@ -831,6 +1133,8 @@ public:
 
   static void defineElement(std::string tagName, ElementCreator creator);
 
+  static JSClassRef prototypeClass();
+
 protected:
   JSElement() = delete;
   explicit JSElement(JSContext *context);
@@ -858,17 +1162,28 @@ private:
                            const JSValueRef arguments[], JSValueRef *exception);
   static JSValueRef scrollBy(JSContextRef ctx, JSObjectRef function, JSObjectRef thisObject, size_t argumentCount,
                              const JSValueRef arguments[], JSValueRef *exception);
-  JSFunctionHolder m_getBoundingClientRect{context, prototypeObject, this, "getBoundingClientRect",
-                                           getBoundingClientRect};
-  JSFunctionHolder m_setAttribute{context, prototypeObject, this, "setAttribute", setAttribute};
-  JSFunctionHolder m_getAttribute{context, prototypeObject, this, "getAttribute", getAttribute};
-  JSFunctionHolder m_hasAttribute{context, prototypeObject, this, "hasAttribute", hasAttribute};
-  JSFunctionHolder m_removeAttribute{context, prototypeObject, this, "removeAttribute", removeAttribute};
-  JSFunctionHolder m_toBlob{context, prototypeObject, this, "toBlob", toBlob};
-  JSFunctionHolder m_click{context, prototypeObject, this, "click", click};
-  JSFunctionHolder m_scroll{context, prototypeObject, this, "scroll", scroll};
-  JSFunctionHolder m_scrollTo{context, prototypeObject, this, "scrollTo", scroll};
-  JSFunctionHolder m_scrollBy{context, prototypeObject, this, "scrollBy", scrollBy};
+
+  static const JSStaticFunction prototypeStaticFunctions[];
+};
+
+enum class ViewModuleProperty {
+  offsetTop,
+  offsetLeft,
+  offsetWidth,
+  offsetHeight,
+  clientWidth,
+  clientHeight,
+  clientTop,
+  clientLeft,
+  scrollTop,
+  scrollLeft,
+  scrollHeight,
+  scrollWidth
+};
+
+// Snapshot of all view module properties, indexed by ViewModuleProperty.
+struct NativeViewModuleProperties {
+  double properties[12];
 };
 
 class KRAKEN_EXPORT ElementInstance : public NodeInstance {
@@ -897,8 +1212,21 @@ public:
 
 private:
   friend JSElement;
+  friend DocumentInstance;
   JSStringHolder m_tagName{context, ""};
 
+  // Links and keys of this element in the document indexes, only valid when m_indexed is true.
+  ElementIndexLink m_tagNameLink;
+  ElementIndexLink m_idLink;
+  std::string m_indexedTagName;
+  std::string m_indexedId;
+  bool m_indexed{false};
+
+  // Read geometry from the snapshot, only call into dart when layout changed since it was taken.
+  double getViewModuleProperty(ViewModuleProperty property);
+  NativeViewModuleProperties m_viewModuleProperties{};
+  uint64_t m_viewModulePropertiesEpoch{0};
+
   KRAKEN_EXPORT void _notifyNodeRemoved(NodeInstance *node) override;
   void _notifyChildRemoved();
   KRAKEN_EXPORT void _notifyNodeInsert(NodeInstance *insertNode) override;
@@ -910,20 +1238,6 @@ private:
                             new StyleDeclarationInstance(CSSStyleDeclaration::instance(context), this)};
 };
 
-enum class ViewModuleProperty {
-  offsetTop,
-  offsetLeft,
-  offsetWidth,
-  offsetHeight,
-  clientWidth,
-  clientHeight,
-  clientTop,
-  clientLeft,
-  scrollTop,
-  scrollLeft,
-  scrollHeight,
-  scrollWidth
-};
 using GetViewModuleProperty = double (*)(NativeElement *nativeElement, int64_t property);
 using SetViewModuleProperty = void (*)(NativeElement *nativeElement, int64_t property, double value);
 using GetBoundingClientRect = NativeBoundingClientRect *(*)(NativeElement *nativeElement);
@@ -931,6 +1245,7 @@ using GetStringValueProperty = NativeString *(*)(NativeElement *nativeElement, N
 using Click = void (*)(NativeElement *nativeElement);
 using Scroll = void (*)(NativeElement *nativeElement, int32_t x, int32_t y);
 using ScrollBy = void (*)(NativeElement *nativeElement, int32_t x, int32_t y);
+using GetViewModuleProperties = void (*)(NativeElement *nativeElement, NativeViewModuleProperties *properties);
 
 class BoundingClientRect : public HostObject {
 public:
@@ -963,6 +1278,7 @@ struct NativeElement {
   Click click{nullptr};
   Scroll scroll{nullptr};
   ScrollBy scrollBy{nullptr};
+  GetViewModuleProperties getViewModuleProperties{nullptr};
 };
 
 struct NativeGestureEvent {
@@ -7,7 +7,11 @@
 #define KRAKENBRIDGE_FOUNDATION_H
 
 #include "kraken_bridge_jsc_config.h"
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -61,6 +65,176 @@ private:
   std::vector<CallbackItem> queue;
 };
 
+// A bump allocator which owns all string payloads of ui commands recorded in one frame.
+// Chunks are kept after reset, so steady state frames do not touch the heap at all.
+class UICommandArena {
+public:
+  UICommandArena() = default;
+  ~UICommandArena();
+  const uint16_t *copy(const uint16_t *string, size_t length);
+  // Release all strings at once. O(1), chunks are reused for next frame.
+  void reset();
+
+private:
+  struct Chunk {
+    uint16_t *data;
+    size_t capacity;
+  };
+  // Default chunk capacity, in uint16_t units.
+  static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+  std::vector<Chunk> m_chunks;
+  size_t m_chunkIndex{0};
+  size_t m_offset{0};
+
+  KRAKEN_DISALLOW_COPY_AND_ASSIGN(UICommandArena);
+};
+
+// Strings like style property names, event types and tag names are repeated in almost every frame.
+// Interned strings are stored once per context and referenced by atom id from ui command items.
+class UICommandAtomTable {
+public:
+  UICommandAtomTable() = default;
+  ~UICommandAtomTable();
+  // Return atom id of string, or -1 if this string should not be interned.
+  int32_t intern(const uint16_t *string, size_t length);
+  NativeString *atom(int32_t atomId);
+  size_t size();
+
+private:
+  static constexpr size_t MAX_ATOM_LENGTH = 64;
+  static constexpr size_t MAX_ATOM_COUNT = 4096;
+
+  // Atoms are written by producer and read by consumer, the array never grows so readers
+  // only need to sync with m_atomCount.
+  std::unordered_map<std::u16string_view, int32_t> m_atomMap;
+  std::unique_ptr<NativeString *[]> m_atoms;
+  std::atomic<int32_t> m_atomCount{0};
+
+  KRAKEN_DISALLOW_COPY_AND_ASSIGN(UICommandAtomTable);
+};
+
+enum UICommandEncoding : int32_t {
+  // Items are read as an array of UICommandItem.
+  UI_COMMAND_ENCODING_STRUCT = 0,
+  // Items are serialized with UICommandEncoder.
+  UI_COMMAND_ENCODING_COMPACT = 1
+};
+
+// Compact wire format of ui commands, all numbers are little endian.
+//  header:  uint8 version, varint command count.
+//  command: uint8 opcode (bit 0-3: type, bit 4: has nativePtr, bit 5: has args_01, bit 6: has args_02),
+//           zigzag varint id, [uint64 nativePtr], [args_01], [args_02].
+//  args:    varint (value << 2 | kind), kind 0: atom with id `value`, kind 1: `value` latin1 bytes,
+//           kind 2: `value` utf16 code units.
+class UICommandEncoder {
+public:
+  static constexpr uint8_t VERSION = 1;
+  static void encode(const std::vector<UICommandItem> &queue, std::vector<uint8_t> &bytes);
+};
+
+// Remove commands which have no visible effect at the end of a frame:
+//  - setStyle/setProperty/removeProperty writes overwritten later for the same (eventTargetId, key).
+//  - addEvent repeating the previous event command of the same (eventTargetId, eventType), dart only listens once.
+//    An addEvent/removeEvent pair is kept, the target may have listened before this frame.
+//  - nodes created and disposed in the same frame without being used as parent or clone source.
+// Clone, insert and remove of a node are barriers for its pending writes, so cloned state and style
+// transitions still observe intermediate values.
+class UICommandCoalescer {
+public:
+  UICommandCoalescer() = default;
+  // Return the count of eliminated commands.
+  int64_t coalesce(std::vector<UICommandItem> &queue, UICommandAtomTable &atomTable);
+
+private:
+  struct CommandKey {
+    int32_t id;
+    int32_t kind;
+    std::u16string_view key;
+    bool operator==(const CommandKey &other) const {
+      return id == other.id && kind == other.kind && key == other.key;
+    }
+  };
+  struct CommandKeyHash {
+    size_t operator()(const CommandKey &key) const {
+      return std::hash<std::u16string_view>()(key.key) ^ (static_cast<size_t>(key.id) << 4) ^ key.kind;
+    }
+  };
+  struct PendingWrite {
+    size_t index;
+    int32_t epoch;
+  };
+
+  void coalesceWrites(std::vector<UICommandItem> &queue, UICommandAtomTable &atomTable);
+  void elideDisposedNodes(std::vector<UICommandItem> &queue);
+
+  // Containers are reused between frames to avoid rehashing every flush.
+  std::unordered_map<CommandKey, PendingWrite, CommandKeyHash> m_pendingWrites;
+  std::unordered_map<CommandKey, int32_t, CommandKeyHash> m_pendingEvents;
+  std::unordered_map<int32_t, int32_t> m_barrierEpochs;
+  std::unordered_map<int32_t, bool> m_disposableNodes;
+  std::vector<bool> m_eliminated;
+};
+
+// Power of two histogram: bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i), the last bucket also
+// counts everything larger. Written by one thread at a time, readable from any thread.
+class UICommandHistogram {
+public:
+  static constexpr int32_t BUCKET_COUNT = 24;
+
+  void add(int64_t value);
+  void reset();
+  int64_t count() const {
+    return m_count.load(std::memory_order_relaxed);
+  }
+  int64_t sum() const {
+    return m_sum.load(std::memory_order_relaxed);
+  }
+  int64_t max() const {
+    return m_max.load(std::memory_order_relaxed);
+  }
+  int64_t bucket(int32_t index) const {
+    return m_buckets[index].load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int64_t> m_buckets[BUCKET_COUNT]{};
+  std::atomic<int64_t> m_count{0};
+  std::atomic<int64_t> m_sum{0};
+  std::atomic<int64_t> m_max{0};
+};
+
+// Always-on statistics of the ui commands of one context. Commands are counted when a frame is published, after
+// coalescing, so the numbers describe what actually crosses over to dart.
+struct UICommandStats {
+  // Command types fit in the 4 bit type field of the compact encoding.
+  static constexpr int32_t TYPE_COUNT = 16;
+  static const char *typeName(int32_t type);
+
+  void reset();
+
+  std::atomic<int64_t> commandCount[TYPE_COUNT]{};
+  std::atomic<int64_t> lastFrameCommandCount[TYPE_COUNT]{};
+  // UTF-16 payload bytes of command arguments. Interned arguments only send their atom id and count as zero.
+  std::atomic<int64_t> argsBytes{0};
+  // Bytes of the published frames in the compact encoding, zero with the struct encoding.
+  std::atomic<int64_t> encodedBytes{0};
+  std::atomic<int64_t> publishedFrames{0};
+  UICommandHistogram commandsPerFrame;
+  UICommandHistogram bytesPerFrame;
+  // Microseconds from publishing a frame until dart side released it.
+  UICommandHistogram flushLatency;
+};
+
+// Ui command strings are copied into the per context arena, repeated keys are interned into the atom table.
+// An interned argument is encoded with a negative length: `args_length = -(atomId + 1)`, its string pointer
+// still points to the atom characters.
+//
+// Commands are double buffered: the producer (JS thread) records into one frame while the consumer (dart side)
+// reads the other one. Frames change hands with an atomic publish/release protocol:
+//  - producer: addCommand() records into the recording frame, publish() hands it over when the consumer
+//    released the previous one. Otherwise commands stay in the recording frame and go out with next publish().
+//  - consumer: data()/size() read the published frame, release() gives it back after all items are read.
 class UICommandBuffer {
 public:
   UICommandBuffer() = delete;
@@ -72,14 +246,61 @@ public:
   KRAKEN_EXPORT void addCommand(int32_t id, int32_t type, NativeString &args_01, NativeString &args_02,
                                      void *nativePtr);
   KRAKEN_EXPORT void addCommand(int32_t id, int32_t type, NativeString &args_01, void *nativePtr);
+  KRAKEN_EXPORT bool publish();
+  // Publish recorded commands when called from producer thread, used by consumers which share thread with JS.
+  KRAKEN_EXPORT void publishIfProducer();
   KRAKEN_EXPORT UICommandItem *data();
   KRAKEN_EXPORT int64_t size();
+  KRAKEN_EXPORT void release();
+  // Drop all recorded and published commands. Only safe when producer is idle, such as context disposing.
   KRAKEN_EXPORT void clear();
+  KRAKEN_EXPORT NativeString *atom(int32_t atomId);
+  // Coalescing runs on recorded commands right before they are published, disabled by default.
+  KRAKEN_EXPORT void setCoalescingEnabled(bool enabled);
+  // Commands eliminated by coalescing in the last published frame.
+  KRAKEN_EXPORT int64_t coalescedCount();
+  // Wire format of published frames, shared by all contexts.
+  static KRAKEN_EXPORT void setEncoding(int32_t encoding);
+  static KRAKEN_EXPORT int32_t encoding();
+  // Published frame in UI_COMMAND_ENCODING_COMPACT format.
+  KRAKEN_EXPORT uint8_t *encodedData();
+  KRAKEN_EXPORT int64_t encodedSize();
+  // Recorded or published commands not consumed yet, layout of dart side is stale until they are flushed.
+  KRAKEN_EXPORT bool isLayoutDirty();
+  // Geometry read from dart side stays valid while layout epoch is unchanged.
+  KRAKEN_EXPORT uint64_t layoutEpoch();
+  KRAKEN_EXPORT void invalidateLayout();
+  // Changed each time a command is recorded or commands are published.
+  KRAKEN_EXPORT uint64_t commandSequence();
+  KRAKEN_EXPORT UICommandStats &stats();
 
 private:
+  struct Frame {
+    std::vector<UICommandItem> queue;
+    UICommandArena arena;
+    std::vector<uint8_t> encoded;
+  };
+
+  void recordCommand(UICommandItem &item);
+  void recordFrameStats(const std::vector<UICommandItem> &queue);
+  void copyArgs(int32_t type, NativeString &args_01, NativeString *args_02, UICommandItem &item);
+
   int32_t contextId;
   std::atomic<bool> update_batched{false};
-  std::vector<UICommandItem> queue;
+  Frame frames[2];
+  // Only touched by producer thread.
+  int32_t recordingIndex{0};
+  // Index of frame owned by consumer, -1 if consumer have nothing to read.
+  std::atomic<int32_t> publishedIndex{-1};
+  std::atomic<std::thread::id> producerThread;
+  UICommandAtomTable atomTable;
+  std::atomic<bool> coalescingEnabled{false};
+  std::atomic<int64_t> lastCoalescedCount{0};
+  UICommandCoalescer coalescer;
+  std::atomic<uint64_t> currentLayoutEpoch{1};
+  std::atomic<uint64_t> sequence{0};
+  UICommandStats commandStats;
+  std::atomic<int64_t> publishTime{0};
 };
 
 typedef int LogSeverity;
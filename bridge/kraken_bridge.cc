@@ -8,7 +8,12 @@
 #include "foundation/logging.h"
 #include "foundation/ui_task_queue.h"
 #include "foundation/inspector_task_queue.h"
+#include "foundation/bridge_stats.h"
+#include "foundation/trace_event.h"
 #include "bindings/jsc/KOM/performance.h"
+#include "bindings/jsc/KOM/timer.h"
+#include "bindings/jsc/DOM/elements/canvas_element.h"
+#include "bindings/jsc/script_cache.h"
 
 #ifdef KRAKEN_ENABLE_JSA
 #include "bridge_jsa.h"
@@ -17,6 +22,7 @@
 #endif
 
 #include <atomic>
+#include <cstring>
 #include <thread>
 
 #if defined(_WIN32)
@@ -47,6 +53,10 @@ std::atomic<bool> inited{false};
 std::atomic<int32_t> poolIndex{0};
 int maxPoolSize = 0;
 kraken::JSBridge **contextPool;
+// Fully constructed bridges waiting to be handed out by allocateNewContext, indexed by the context id they were
+// built for.
+kraken::JSBridge **sparePool{nullptr};
+int32_t prewarmedContextCount = 0;
 Screen screen;
 
 std::__thread_id uiThreadId;
@@ -55,6 +65,10 @@ std::__thread_id getUIThreadId() {
   return uiThreadId;
 }
 
+void setUIThreadId(std::__thread_id threadId) {
+  uiThreadId = threadId;
+}
+
 void printError(int32_t contextId, const char* errmsg) {
   if (kraken::getDartMethod()->onJsError != nullptr) {
     kraken::getDartMethod()->onJsError(contextId, errmsg);
@@ -64,10 +78,26 @@ void printError(int32_t contextId, const char* errmsg) {
 
 namespace {
 
+// Dart reads the commands of every view each frame, the buffer kept by the context spares the locked lookup of
+// UICommandBuffer::instance.
+foundation::UICommandBuffer *uiCommandBuffer(int32_t contextId) {
+  assert(checkContext(contextId) && "uiCommandBuffer: contextId is not valid");
+  return static_cast<kraken::JSBridge *>(getJSContext(contextId))->getContext()->uiCommandBuffer();
+}
+
+void disposeSpareBridges() {
+  if (sparePool == nullptr) return;
+  for (int i = 0; i < maxPoolSize; i++) {
+    delete sparePool[i];
+    sparePool[i] = nullptr;
+  }
+}
+
 void disposeAllBridge() {
   for (int i = 0; i <= poolIndex && i < maxPoolSize; i++) {
     disposeContext(i);
   }
+  disposeSpareBridges();
   poolIndex = 0;
   inited = false;
 }
@@ -83,8 +113,9 @@ int32_t searchForAvailableContextId() {
 
 } // namespace
 
-void initJSContextPool(int poolSize) {
-  uiThreadId = std::this_thread::get_id();
+void initJSContextPool(int poolSize, int32_t uiCommandEncoding) {
+  setUIThreadId(std::this_thread::get_id());
+  foundation::UICommandBuffer::setEncoding(uiCommandEncoding);
   // When dart hot restarted, should dispose previous bridge and clear task message queue.
   if (inited) {
     disposeAllBridge();
@@ -94,6 +125,11 @@ void initJSContextPool(int poolSize) {
   for (int i = 1; i < poolSize; i++) {
     contextPool[i] = nullptr;
   }
+  delete[] sparePool;
+  sparePool = new kraken::JSBridge *[poolSize];
+  for (int i = 0; i < poolSize; i++) {
+    sparePool[i] = nullptr;
+  }
 
   contextPool[0] = new kraken::JSBridge(0, printError);
   inited = true;
@@ -113,6 +149,7 @@ void disposeContext(int32_t contextId) {
 }
 
 int32_t allocateNewContext(int32_t targetContextId) {
+  int64_t startTime = foundation::TraceLog::now();
   if (targetContextId == -1) {
     targetContextId = ++poolIndex;
   }
@@ -124,11 +161,70 @@ int32_t allocateNewContext(int32_t targetContextId) {
   assert(contextPool[targetContextId] == nullptr && (std::string("can not allocate JSBridge at index") +
                                                std::to_string(targetContextId) + std::string(": bridge have already exist."))
                                                 .c_str());
-  auto context = new kraken::JSBridge(targetContextId, printError);
+  kraken::JSBridge *context = sparePool[targetContextId];
+  if (context != nullptr) {
+    sparePool[targetContextId] = nullptr;
+    context->startupTiming.prewarmed = true;
+    // The page starts when the spare is handed out, not when it was built in idle time.
+    context->getContext()->timeOrigin = std::chrono::system_clock::now();
+#if ENABLE_PROFILE
+    // Marks taken while the spare was constructed predate this navigation, which did not pay for them.
+    kraken::binding::jsc::NativePerformance::instance(targetContextId)->entries.clear();
+#endif
+  } else {
+    context = new kraken::JSBridge(targetContextId, printError);
+  }
+  context->startupTiming.allocate = (foundation::TraceLog::now() - startTime) / 1000;
   contextPool[targetContextId] = context;
   return targetContextId;
 }
 
+void setSharedJSContextGroupEnabled(int32_t enabled) {
+  kraken::binding::jsc::setSharedContextGroupEnabled(enabled != 0);
+}
+
+void setLazyBindingEnabled(int32_t enabled) {
+  kraken::JSBridge::lazyBinding = enabled != 0;
+}
+
+void setFunctionClassCacheEnabled(int32_t enabled) {
+  kraken::binding::jsc::setFunctionClassCacheEnabled(enabled != 0);
+}
+
+void setPropertyNameCacheEnabled(int32_t enabled) {
+  kraken::binding::jsc::setPropertyNameCacheEnabled(enabled != 0);
+}
+
+void setCanvasDisplayListEnabled(int32_t enabled) {
+  kraken::binding::jsc::setCanvasDisplayListEnabled(enabled != 0);
+}
+
+void setPrewarmedContextCount(int32_t count) {
+  prewarmedContextCount = count;
+}
+
+int32_t prewarmContext() {
+  if (!inited || prewarmedContextCount <= 0) return 0;
+
+  int32_t spareCount = 0;
+  for (int i = 0; i < maxPoolSize; i++) {
+    if (sparePool[i] != nullptr) spareCount++;
+  }
+  if (spareCount >= prewarmedContextCount) return 0;
+
+  // Warm the ids allocateNewContext(-1) hands out next. Past the end of the pool it searches for a free id instead of
+  // wrapping around, so ids below poolIndex are not warmed.
+  for (int32_t contextId = poolIndex + 1; contextId < maxPoolSize; contextId++) {
+    if (contextPool[contextId] != nullptr || sparePool[contextId] != nullptr) continue;
+    KRAKEN_TRACE_EVENT("prewarmContext", contextId);
+    sparePool[contextId] = new kraken::JSBridge(contextId, printError);
+    return prewarmedContextCount - spareCount - 1;
+  }
+
+  // Every id is either in use or already warm.
+  return 0;
+}
+
 void *getJSContext(int32_t contextId) {
   assert(checkContext(contextId) && "getJSContext: contextId is not valid.");
   return contextPool[contextId];
@@ -156,6 +252,12 @@ void parseHTML(int32_t contextId, NativeString *code, const char *bundleFilename
   context->parseHTML(code, bundleFilename);
 }
 
+void parseHTMLChunk(int32_t contextId, NativeString *chunk, const char *bundleFilename, int32_t isFinal) {
+  assert(checkContext(contextId) && "parseHTMLChunk: contextId is not valid");
+  auto context = static_cast<kraken::JSBridge *>(getJSContext(contextId));
+  context->parseHTMLChunk(chunk, bundleFilename, isFinal != 0);
+}
+
 void reloadJsContext(int32_t contextId) {
   assert(checkContext(contextId) && "reloadJSContext: contextId is not valid");
   auto bridgePtr = getJSContext(contextId);
@@ -168,9 +270,14 @@ void reloadJsContext(int32_t contextId) {
 void invokeModuleEvent(int32_t contextId, NativeString *moduleName, const char *eventType, void *event, NativeString *extra) {
   assert(checkContext(contextId) && "invokeEventListener: contextId is not valid");
   auto context = static_cast<kraken::JSBridge *>(getJSContext(contextId));
+  context->getContext()->uiCommandBuffer()->invalidateLayout();
   context->invokeModuleEvent(moduleName, eventType, event, extra);
 }
 
+void invalidateLayout(int32_t contextId) {
+  uiCommandBuffer(contextId)->invalidateLayout();
+}
+
 void registerDartMethods(uint64_t *methodBytes, int32_t length) {
   kraken::registerDartMethods(methodBytes, length);
 }
@@ -218,6 +325,10 @@ void flushUITask(int32_t contextId) {
   foundation::UITaskQueue::instance(contextId)->flushTask();
 }
 
+int64_t flushUITaskWithBudget(int32_t contextId, int64_t budgetMicroseconds) {
+  return foundation::UITaskQueue::instance(contextId)->flushTask(budgetMicroseconds);
+}
+
 void registerUITask(int32_t contextId, Task task, void *data) {
   foundation::UITaskQueue::instance(contextId)->registerTask(task, data);
 };
@@ -227,17 +338,120 @@ void flushUICommandCallback() {
 }
 
 UICommandItem *getUICommandItems(int32_t contextId) {
-  return foundation::UICommandBuffer::instance(contextId)->data();
+  auto buffer = uiCommandBuffer(contextId);
+  // JS and dart share the same thread by default, recorded commands can be published right before reading.
+  buffer->publishIfProducer();
+  // Dart reads commands once per frame, layout may have changed since last frame.
+  buffer->invalidateLayout();
+  return buffer->data();
 }
 
 int64_t getUICommandItemSize(int32_t contextId) {
-  return foundation::UICommandBuffer::instance(contextId)->size();
+  return uiCommandBuffer(contextId)->size();
+}
+
+uint8_t *getUICommandBytes(int32_t contextId) {
+  auto buffer = uiCommandBuffer(contextId);
+  buffer->publishIfProducer();
+  buffer->invalidateLayout();
+  return buffer->encodedData();
+}
+
+int64_t getUICommandByteLength(int32_t contextId) {
+  return uiCommandBuffer(contextId)->encodedSize();
 }
 
 void clearUICommandItems(int32_t contextId) {
+  // Called while pages are disposed, the bridge may be gone already.
   return foundation::UICommandBuffer::instance(contextId)->clear();
 }
 
+void publishUICommandItems(int32_t contextId) {
+  uiCommandBuffer(contextId)->publish();
+}
+
+void releaseUICommandItems(int32_t contextId) {
+  uiCommandBuffer(contextId)->release();
+}
+
+void setUICommandCoalescing(int32_t contextId, int32_t enabled) {
+  foundation::UICommandBuffer::instance(contextId)->setCoalescingEnabled(enabled == 1);
+}
+
+int64_t getUICommandCoalescedCount(int32_t contextId) {
+  return uiCommandBuffer(contextId)->coalescedCount();
+}
+
+void setNativeTimerQueue(int32_t contextId, int32_t enabled) {
+  kraken::binding::jsc::TimerQueue::setEnabled(contextId, enabled == 1);
+}
+
+void setTraceEnabled(int32_t enabled) {
+  foundation::TraceLog::setEnabled(enabled == 1);
+}
+
+void clearTraceEvents() {
+  foundation::TraceLog::clear();
+}
+
+char *exportTraceEvents() {
+  std::string trace = foundation::TraceLog::exportChromeTrace();
+  auto *buffer = static_cast<char *>(malloc(trace.size() + 1));
+  memcpy(buffer, trace.c_str(), trace.size() + 1);
+  return buffer;
+}
+
+char *getBridgeStats(int32_t contextId) {
+  foundation::BridgeStatsWriter writer;
+  foundation::writeUICommandStats(writer, contextId);
+
+#if KRAKEN_JSC_ENGINE
+  if (checkContext(contextId)) {
+    auto bridge = static_cast<kraken::JSBridge *>(getJSContext(contextId));
+    const kraken::BridgeStartupTiming &timing = bridge->startupTiming;
+    writer.beginObject("startupUs");
+    writer.field("createContext", timing.createContext);
+    writer.field("bindings", timing.bindings);
+    writer.field("polyfill", timing.polyfill);
+    writer.field("plugins", timing.plugins);
+    writer.field("total", timing.total);
+    writer.field("allocate", timing.allocate);
+    writer.field("prewarmed", timing.prewarmed);
+    writer.endObject();
+
+    const kraken::binding::jsc::HTMLParser *parser = bridge->getHTMLParser();
+    writer.beginObject("htmlParser");
+    writer.field("slices", parser->stats().slices);
+    writer.field("nodes", parser->stats().nodes);
+    writer.field("maxSliceUs", parser->stats().maxSliceUs);
+    writer.field("constructing", parser->isConstructing());
+    writer.endObject();
+  }
+
+  // The script cache is per thread, this reports the one of the calling thread.
+  const kraken::binding::jsc::ScriptCache::Stats &scriptCache = kraken::binding::jsc::ScriptCache::instance()->stats();
+  writer.beginObject("scriptCache");
+  writer.field("hits", scriptCache.hits);
+  writer.field("misses", scriptCache.misses);
+  writer.field("entries", scriptCache.entries);
+  writer.field("bytes", static_cast<int64_t>(scriptCache.bytes));
+  writer.endObject();
+#endif
+
+  std::string stats = writer.finish();
+  auto *buffer = static_cast<char *>(malloc(stats.size() + 1));
+  memcpy(buffer, stats.c_str(), stats.size() + 1);
+  return buffer;
+}
+
+void resetBridgeStats(int32_t contextId) {
+  foundation::resetBridgeStats(contextId);
+}
+
+NativeString *getUICommandAtom(int32_t contextId, int32_t atomId) {
+  return uiCommandBuffer(contextId)->atom(atomId);
+}
+
 void registerContextDisposedCallbacks(int32_t contextId, Task task, void *data) {
   assert(checkContext(contextId));
   auto context = static_cast<kraken::JSBridge *>(getJSContext(contextId));
@@ -249,15 +463,14 @@ void registerPluginSource(NativeString *code, const char *pluginName) {
     code->string,
     code->length
   };
+  // Spares were built without this plugin, let them be warmed again.
+  disposeSpareBridges();
 }
 
 NativeString *NativeString::clone() {
   NativeString *newNativeString = new NativeString();
   uint16_t *newString = new uint16_t[length];
-
-  for (size_t i = 0; i < length; i++) {
-    newString[i] = string[i];
-  }
+  memcpy(newString, string, length * sizeof(uint16_t));
 
   newNativeString->string = newString;
   newNativeString->length = length;
@@ -50,3 +50,23 @@ set(TEST_INCLUDE_DIR
         ./third_party/googletest/googlemock/include
         ${BRIDGE_INCLUDE}
         )
+
+# Unit tests of bridge internals which do not need a running dart side.
+list(APPEND KRAKEN_UNIT_TEST_SOURCE
+  ./foundation/ui_command_buffer_test.cc
+  ./foundation/ui_command_coalescer_test.cc
+  ./foundation/ui_command_encoder_test.cc
+  ./foundation/task_queue_test.cc
+  ./foundation/utf_codec_test.cc
+  ./bindings/jsc/host_class_test.cc
+  ./bindings/jsc/DOM/event_target_test.cc
+  ./bindings/jsc/DOM/event_test.cc
+  ./bindings/jsc/script_cache_test.cc
+)
+
+add_executable(kraken_unit_tests ${KRAKEN_UNIT_TEST_SOURCE})
+target_include_directories(kraken_unit_tests PRIVATE ${TEST_INCLUDE_DIR} ${CMAKE_CURRENT_SOURCE_DIR})
+target_link_libraries(kraken_unit_tests PRIVATE kraken_static gumbo_parse_static ${BRIDGE_LINK_LIBS} gtest gtest_main)
+
+enable_testing()
+add_test(NAME kraken_unit_tests COMMAND kraken_unit_tests)
@@ -387,4 +387,33 @@ describe('Canvas context 2d', () => {
     };
     img.src = 'assets/rabbit.png';
   });
+
+  it('should work with large polyline', async () => {
+    const canvas = <canvas height="300" width="300" />;
+    document.body.appendChild(canvas);
+    const ctx = canvas.getContext('2d');
+
+    ctx.strokeStyle = 'blue';
+    ctx.lineWidth = 1;
+    ctx.beginPath();
+    // A comb swept 250 times.
+    ctx.moveTo(0.5, 50.5);
+    for (let i = 1; i <= 50000; i++) {
+      const x = 0.5 + (Math.floor((i + 1) / 2) % 100) * 3;
+      const y = Math.floor(i / 2) % 2 === 0 ? 50.5 : 250.5;
+      ctx.lineTo(x, y);
+    }
+    ctx.stroke();
+
+    // Style changes between draws keep their order.
+    ctx.fillStyle = 'red';
+    ctx.fillRect(10, 10, 20, 20);
+    ctx.fillStyle = 'green';
+    ctx.fillRect(40, 10, 20, 20);
+
+    // The recorded ops are replayed with the next frame.
+    await new Promise(resolve => requestAnimationFrame(resolve));
+    expect(ctx.fillStyle).toBe('green');
+    expect(ctx.strokeStyle).toBe('blue');
+  });
 });
@@ -375,4 +375,24 @@ describe('Event', () => {
     e.initEvent(type, true, true);
     expect(e.type).toBe(type);
   });
+
+  it('should dispatch to listeners of the type given to the last initEvent', () => {
+    const parent = document.createElement('div');
+    const child = document.createElement('div');
+    parent.appendChild(child);
+    document.body.appendChild(parent);
+
+    const received: string[] = [];
+    child.addEventListener('firsttype', () => received.push('child firsttype'));
+    child.addEventListener('secondtype', () => received.push('child secondtype'));
+    parent.addEventListener('secondtype', () => received.push('parent secondtype'));
+
+    const e = document.createEvent('Event');
+    e.initEvent('firsttype', true, true);
+    e.initEvent('secondtype', true, true);
+    child.dispatchEvent(e);
+
+    expect(received).toEqual(['child secondtype', 'parent secondtype']);
+    document.body.removeChild(parent);
+  });
 });
@@ -171,4 +171,93 @@ describe('DOM EventTarget', () => {
     expect(shouldNotBeTrue).toEqual(false);
   });
 
+  it('should bubble through a 50-deep tree and tolerate listener mutation', () => {
+    const root = document.createElement('div');
+    let leaf = root;
+    for (let i = 0; i < 50; i++) {
+      const child = document.createElement('div');
+      leaf.appendChild(child);
+      leaf = child;
+    }
+    BODY.appendChild(root);
+
+    let rootCount = 0;
+    let leafCount = 0;
+    const onceHandler = () => {
+      leafCount++;
+      leaf.removeEventListener('bench', onceHandler);
+      leaf.addEventListener('bench', () => leafCount += 100);
+    };
+    leaf.addEventListener('bench', onceHandler);
+    root.addEventListener('bench', () => rootCount++);
+
+    for (let i = 0; i < 1000; i++) {
+      const event = document.createEvent('Event');
+      event.initEvent('bench', true, true);
+      leaf.dispatchEvent(event);
+    }
+
+    expect(rootCount).toBe(1000);
+    // The handler added during the first dispatch only runs from the second one.
+    expect(leafCount).toBe(1 + 999 * 100);
+  });
+
+  it('should dispatch again after all listeners of a type were removed and re-added', () => {
+    const div = document.createElement('div');
+    BODY.appendChild(div);
+
+    let count = 0;
+    const listener = () => count++;
+    div.addEventListener('fastpath', listener);
+    div.dispatchEvent(new Event('fastpath'));
+    div.removeEventListener('fastpath', listener);
+    div.dispatchEvent(new Event('fastpath'));
+    expect(count).toBe(1);
+
+    div.addEventListener('fastpath', listener);
+    div.dispatchEvent(new Event('fastpath'));
+    expect(count).toBe(2);
+  });
+
+  it('should dispatch to property handlers of ancestors without own listeners', () => {
+    const parent = document.createElement('div');
+    const child = document.createElement('div');
+    parent.appendChild(child);
+    BODY.appendChild(parent);
+
+    const dispatch = () => {
+      const event = document.createEvent('Event');
+      event.initEvent('fastpathhandler', true, true);
+      child.dispatchEvent(event);
+    };
+
+    let count = 0;
+    // @ts-ignore
+    parent.onfastpathhandler = () => count++;
+    dispatch();
+    expect(count).toBe(1);
+
+    // @ts-ignore
+    parent.onfastpathhandler = null;
+    dispatch();
+    expect(count).toBe(1);
+  });
+
+  it('should keep dispatching after another target of the same type is cleared', () => {
+    const first = document.createElement('div');
+    const second = document.createElement('div');
+    BODY.appendChild(first);
+    BODY.appendChild(second);
+
+    let count = 0;
+    first.addEventListener('fastpathshared', () => count++);
+    second.addEventListener('fastpathshared', () => count++);
+    // @ts-ignore
+    second.__kraken_clear_event_listeners__();
+
+    first.dispatchEvent(new Event('fastpathshared'));
+    second.dispatchEvent(new Event('fastpathshared'));
+    expect(count).toBe(1);
+  });
+
 });
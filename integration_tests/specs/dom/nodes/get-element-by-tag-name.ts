@@ -106,4 +106,57 @@ describe('Document getElementsByTagName', () => {
     expect(document.getElementsByTagName('testtag').length).toBe(0);
   });
 
+  it('return a live collection in tree order', () => {
+    const collection = document.getElementsByTagName('p');
+    expect(collection.length).toBe(0);
+
+    const first = document.createElement('p');
+    const second = document.createElement('p');
+    BODY.appendChild(second);
+    BODY.insertBefore(first, second);
+
+    expect(document.getElementsByTagName('p') === collection).toBe(true);
+    expect(collection.length).toBe(2);
+    expect(collection[0] === first).toBe(true);
+    expect(collection.item(1) === second).toBe(true);
+
+    BODY.removeChild(first);
+    expect(collection.length).toBe(1);
+    expect(collection[0] === second).toBe(true);
+  });
+
+  it('iterate a collection like an array', () => {
+    const first = document.createElement('section');
+    const second = document.createElement('section');
+    BODY.appendChild(first);
+    BODY.appendChild(second);
+
+    const collection = document.getElementsByTagName('section');
+    expect([...collection].length).toBe(2);
+    const visited = [];
+    for (const element of collection) visited.push(element);
+    expect(visited[0] === first && visited[1] === second).toBe(true);
+
+    const tagNames = [];
+    collection.forEach(element => tagNames.push(element.tagName));
+    expect(tagNames).toEqual(['SECTION', 'SECTION']);
+    expect(collection.map(element => element === second)).toEqual([false, true]);
+    expect(collection.indexOf(second)).toBe(1);
+    expect(Array.from(collection).length).toBe(2);
+  });
+
+  it('keep a removed collection live', () => {
+    const element = document.createElement('article');
+    BODY.appendChild(element);
+    const collection = document.getElementsByTagName('article');
+    expect(collection.length).toBe(1);
+
+    // The document releases the collection once the tag has no elements, script still holds a working one.
+    BODY.removeChild(element);
+    expect(collection.length).toBe(0);
+    BODY.appendChild(element);
+    expect(collection.length).toBe(1);
+    expect(collection[0] === element).toBe(true);
+  });
+
 });
@@ -119,4 +119,63 @@ describe('Node API', () => {
     let img = new Image();
     expect(img.ownerDocument).toBe(document);
   });
+
+  it('should keep siblings in order with 100k children', () => {
+    const count = 100000;
+    const container = document.createElement('div');
+
+    for (let i = 0; i < count; i++) {
+      container.appendChild(document.createTextNode(String(i)));
+    }
+
+    let visited = 0;
+    let node = container.firstChild;
+    while (node) {
+      visited++;
+      node = node.nextSibling;
+    }
+    expect(visited).toBe(count);
+    expect(container.childNodes[count - 1] === container.lastChild).toBe(true);
+
+    while (container.lastChild) {
+      container.removeChild(container.firstChild!);
+    }
+    expect(container.childNodes.length).toBe(0);
+  });
+
+  it('should return the same childNodes until children change', () => {
+    const container = document.createElement('div');
+    const first = document.createTextNode('first');
+    container.appendChild(first);
+
+    const childNodes = container.childNodes;
+    expect(container.childNodes === childNodes).toBe(true);
+
+    const second = document.createTextNode('second');
+    container.appendChild(second);
+    expect(container.childNodes === childNodes).toBe(false);
+    expect(container.childNodes.length).toBe(2);
+    expect(container.childNodes[1] === second).toBe(true);
+
+    container.removeChild(first);
+    expect(container.childNodes.length).toBe(1);
+    expect(container.childNodes[0] === second).toBe(true);
+  });
+
+  it('should not let script reorder the shared childNodes', () => {
+    const container = document.createElement('div');
+    const first = document.createTextNode('first');
+    const second = document.createTextNode('second');
+    container.appendChild(first);
+    container.appendChild(second);
+
+    expect(() => container.childNodes.reverse()).toThrow();
+    expect(() => container.childNodes.push(first)).toThrow();
+    expect(() => container.childNodes.splice(0, 1)).toThrow();
+    expect(container.childNodes.length).toBe(2);
+    expect(container.childNodes[0] === first).toBe(true);
+    expect(container.childNodes[1] === second).toBe(true);
+    // Array methods which do not mutate keep working.
+    expect(container.childNodes.map(node => node.data)).toEqual(['first', 'second']);
+  });
 });
@@ -48,3 +48,38 @@ describe('Offset api', () => {
     await snapshot();
   });
 });
+
+describe('Offset api without listeners', () => {
+  it('should read scrollTop again after user scrolling', async () => {
+    const container = document.createElement('div');
+    Object.assign(container.style, {
+      width: '100px',
+      height: '100px',
+      overflow: 'auto',
+    });
+    const content = document.createElement('div');
+    Object.assign(content.style, {
+      height: '500px',
+      background: 'red',
+    });
+    container.appendChild(content);
+    document.body.appendChild(container);
+
+    // Caches the geometry, no scroll listener is registered so dart never dispatches scroll events.
+    expect(container.scrollTop).toBe(0);
+    await simulateSwipe(50, 90, 50, 10, 0.1);
+    await sleep(0.5);
+    expect(container.scrollTop).toBeGreaterThan(0);
+  });
+
+  it('should read offsetHeight again after an image loads', async () => {
+    const img = document.createElement('img');
+    img.src = 'assets/rabbit.png';
+    document.body.appendChild(img);
+
+    // No load listener, the layout change after loading happens on dart side only.
+    expect(img.offsetHeight).toBe(0);
+    await sleep(1);
+    expect(img.offsetHeight).toBeGreaterThan(0);
+  });
+});
@@ -0,0 +1,107 @@
+describe('parseHTMLChunk', () => {
+  // Slices of a streamed document run in later frames.
+  function constructed(): Promise<void> {
+    return new Promise(resolve => {
+      const check = () => {
+        // @ts-ignore
+        if (!performance.__kraken_bridge_stats__().htmlParser.constructing) {
+          resolve();
+        } else {
+          requestAnimationFrame(check);
+        }
+      };
+      check();
+    });
+  }
+
+  function parseChunks(chunks: string[]) {
+    chunks.forEach((chunk, index) => {
+      // @ts-ignore
+      __kraken_parse_html_chunk__(chunk, index === chunks.length - 1);
+    });
+  }
+
+  function remove(id: string) {
+    const element = document.getElementById(id);
+    if (element && element.parentNode) element.parentNode.removeChild(element);
+  }
+
+  it('should join a document split at arbitrary positions', async () => {
+    parseChunks(['<html><body><div id="chunked">hel', 'lo <sp', 'an>world</span', '></div></body></html>']);
+    await constructed();
+
+    const div = document.getElementById('chunked');
+    expect(div.textContent).toBe('hello world');
+    expect(div.childNodes.length).toBe(2);
+    remove('chunked');
+  });
+
+  it('should keep a surrogate pair split across chunks', async () => {
+    const emoji = '😀';
+    parseChunks(['<div id="emoji">a\uD83D', '\uDE00b', '</div>']);
+    await constructed();
+
+    expect(document.getElementById('emoji').textContent).toBe('a' + emoji + 'b');
+    remove('emoji');
+  });
+
+  it('should build large documents in several slices', async () => {
+    // @ts-ignore
+    const before = performance.__kraken_bridge_stats__().htmlParser;
+    let html = '<div id="sliced">';
+    for (let i = 0; i < 20000; i++) {
+      html += '<div><span>' + i + '</span></div>';
+    }
+    html += '</div>';
+    parseChunks([html.substring(0, html.length / 2), html.substring(html.length / 2)]);
+    await constructed();
+
+    // @ts-ignore
+    const after = performance.__kraken_bridge_stats__().htmlParser;
+    const sliced = document.getElementById('sliced');
+    expect(sliced.childNodes.length).toBe(20000);
+    expect(sliced.lastChild.textContent).toBe('19999');
+    expect(after.slices - before.slices).toBeGreaterThan(1);
+    expect(after.nodes - before.nodes).toBe(1 + 20000 * 3);
+    remove('sliced');
+  });
+
+  it('should run scripts in document order after the nodes before them', async () => {
+    // @ts-ignore
+    window.__htmlScriptOrder = [];
+    parseChunks([
+      '<div id="ordered"><script>__htmlScriptOrder.push(1)</script>',
+      '<div><p id="ordered-before"></p><script>',
+      '__htmlScriptOrder.push(document.getElementById("ordered-before") ? 2 : -2)</script></div>',
+      '<script>__htmlScriptOrder.push(document.getElementById("ordered-after") ? -3 : 3)</script>',
+      '<p id="ordered-after"></p></div>'
+    ]);
+    await constructed();
+
+    // @ts-ignore
+    expect(window.__htmlScriptOrder).toEqual([1, 2, 3]);
+    remove('ordered');
+  });
+
+  it('should keep building an element detached between slices', async () => {
+    let html = '<div id="detached"><script>requestAnimationFrame(() => {' +
+      'var el = document.getElementById("detached"); window.__htmlDetached = el; el.parentNode.removeChild(el);' +
+      '})</script>';
+    for (let i = 0; i < 20000; i++) {
+      html += '<p>' + i + '</p>';
+    }
+    html += '</div><div id="detached-sibling"></div>';
+    parseChunks([html]);
+    await constructed();
+
+    // @ts-ignore
+    const detached = window.__htmlDetached;
+    expect(detached.parentNode).toBe(null);
+    // The script and every paragraph, including those appended after it was detached.
+    expect(detached.childNodes.length).toBe(20001);
+    expect(document.getElementById('detached-sibling').parentNode).toBe(document.body);
+    // @ts-ignore
+    window.__htmlDetached = null;
+    remove('detached-sibling');
+  });
+});
@@ -0,0 +1,56 @@
+/**
+ * Strings crossing the bridge are transcoded between UTF-16 and UTF-8, cover
+ * - ASCII, Latin-1, CJK and astral (surrogate pair) inputs
+ * - event types, text node data, style values and attributes
+ */
+describe('String encoding', () => {
+  const samples = {
+    ascii: 'background-color-and-some-longer-ascii-text',
+    latin1: 'café crème brûlée à la carte',
+    cjk: '中文字符串测试，日本語のテキスト，한국어',
+    astral: 'emoji 😀👍🏽 and 𠮷',
+  };
+
+  Object.keys(samples).forEach((kind) => {
+    const sample = samples[kind];
+
+    it(`${kind} event type round trip`, () => {
+      const event = new CustomEvent(sample, { detail: sample });
+      expect(event.type).toBe(sample);
+
+      let received = '';
+      const div = document.createElement('div');
+      div.addEventListener(sample, (e: CustomEvent) => {
+        received = e.type;
+      });
+      div.dispatchEvent(event);
+      expect(received).toBe(sample);
+    });
+
+    it(`${kind} text node data round trip`, () => {
+      const text = document.createTextNode(sample);
+      BODY.appendChild(text);
+      expect(text.data).toBe(sample);
+      text.data = sample + sample;
+      expect(text.data).toBe(sample + sample);
+    });
+
+    it(`${kind} attribute round trip`, () => {
+      const div = document.createElement('div');
+      div.setAttribute('title', sample);
+      expect(div.getAttribute('title')).toBe(sample);
+    });
+
+    it(`${kind} repeated conversions stay stable`, () => {
+      const div = document.createElement('div');
+      BODY.appendChild(div);
+      const text = document.createTextNode('');
+      div.appendChild(text);
+      for (let i = 0; i < 2000; i++) {
+        text.data = sample;
+        div.style.fontFamily = sample;
+      }
+      expect(text.data).toBe(sample);
+    });
+  });
+});
@@ -34,4 +34,115 @@ describe('Performance', () => {
     expect(hasAbc).toBe(true);
     expect(hasEfg).toBe(false);
   });
+
+  it('__kraken_event_object_stats__', async () => {
+    const div = document.createElement('div');
+    div.style.width = '100px';
+    div.style.height = '100px';
+    BODY.appendChild(div);
+
+    let sameList = false;
+    let touchEnded = false;
+    div.addEventListener('touchstart', (e: TouchEvent) => {
+      sameList = e.touches === e.touches;
+      e.changedTouches;
+    });
+    // Lists which are not read are never created.
+    div.addEventListener('touchend', () => touchEnded = true);
+
+    // The first touch warms up the class cache of Touch and TouchList.
+    await simulateClick(10, 10);
+
+    // @ts-ignore
+    const before = performance.__kraken_event_object_stats__();
+    await simulateClick(10, 10);
+    // @ts-ignore
+    const after = performance.__kraken_event_object_stats__();
+
+    expect(sameList).toBe(true);
+    expect(touchEnded).toBe(true);
+    // touches and changedTouches of touchstart, each holding one touch.
+    expect(after.touchListCreated - before.touchListCreated).toBe(2);
+    expect(after.hostObjectClassCacheHits - before.hostObjectClassCacheHits).toBe(4);
+    expect(after.hostObjectClassCacheMisses - before.hostObjectClassCacheMisses).toBe(0);
+  });
+
+  it('__kraken_event_object_stats__ counts event payload pool lookups', () => {
+    // @ts-ignore
+    const before = performance.__kraken_event_object_stats__();
+    new Event('payloadpool');
+    new MouseEvent('payloadpool');
+    // @ts-ignore
+    const after = performance.__kraken_event_object_stats__();
+
+    const lookups = (after.eventPayloadPoolHits - before.eventPayloadPoolHits) +
+      (after.eventPayloadPoolMisses - before.eventPayloadPoolMisses);
+    expect(lookups).toBe(2);
+    expect(after.eventPayloadsRecycled).toBeGreaterThanOrEqual(before.eventPayloadsRecycled);
+  });
+
+  it('records bridge trace events', () => {
+    // @ts-ignore
+    __kraken_set_trace_enabled__(true);
+    const div = document.createElement('div');
+    div.style.width = '100px';
+    BODY.appendChild(div);
+    // @ts-ignore
+    __kraken_set_trace_enabled__(false);
+
+    // @ts-ignore
+    const trace = JSON.parse(__kraken_export_trace__());
+    const names = trace.traceEvents.map(e => e.name);
+    expect(names).toContain('HostClass.getProperty');
+    expect(names).toContain('UICommandBuffer.addCommand');
+    const styleAccess = trace.traceEvents.find(e => e.name === 'HostClass.getProperty' && e.args.detail === 'style');
+    expect(styleAccess.ph).toBe('X');
+    expect(styleAccess.dur).toBeGreaterThanOrEqual(0);
+  });
+
+  it('__kraken_bridge_stats__', (done) => {
+    // @ts-ignore
+    const before = performance.__kraken_bridge_stats__();
+    const div = document.createElement('div');
+    div.style.height = '10px';
+    BODY.appendChild(div);
+
+    requestAnimationFrame(() => {
+      // @ts-ignore
+      const after = performance.__kraken_bridge_stats__();
+      expect(after.frames).toBeGreaterThan(before.frames);
+      expect(after.commands.createElement).toBeGreaterThan(before.commands.createElement);
+      expect(after.commands.setStyle).toBeGreaterThan(before.commands.setStyle);
+      expect(after.commandsPerFrame.buckets.length).toBe(24);
+      expect(after.flushLatencyUs.count).toBeGreaterThan(0);
+      expect(after.dartCalls.requestBatchUpdate).toBeGreaterThan(0);
+      done();
+    });
+  });
+
+  it('bridge startup timing', () => {
+    // @ts-ignore
+    const startup = performance.__kraken_bridge_stats__().startupUs;
+    expect(startup.total).toBeGreaterThan(0);
+    expect(startup.bindings).toBeGreaterThanOrEqual(0);
+    expect(startup.polyfill).toBeGreaterThan(0);
+    expect(startup.createContext + startup.bindings + startup.polyfill + startup.plugins).toBeLessThanOrEqual(startup.total);
+    expect(typeof startup.prewarmed).toBe('boolean');
+  });
+
+  it('script cache counters', () => {
+    // @ts-ignore
+    const scriptCache = performance.__kraken_bridge_stats__().scriptCache;
+    expect(scriptCache.hits).toBeGreaterThanOrEqual(0);
+    expect(scriptCache.misses).toBeGreaterThanOrEqual(0);
+    expect(scriptCache.entries).toBeLessThanOrEqual(scriptCache.misses);
+  });
+
+  it('html parser counters', () => {
+    // @ts-ignore
+    const htmlParser = performance.__kraken_bridge_stats__().htmlParser;
+    expect(htmlParser.nodes).toBeGreaterThanOrEqual(0);
+    expect(htmlParser.maxSliceUs).toBeGreaterThanOrEqual(0);
+    expect(typeof htmlParser.constructing).toBe('boolean');
+  });
 });
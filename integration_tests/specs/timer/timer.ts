@@ -24,6 +24,17 @@ describe('setTimeout', () => {
       }, 50);
     });
   });
+
+  it('fire every callback when thousands are pending', done => {
+    const total = 5000;
+    let fired = 0;
+    for (let i = 0; i < total; i++) {
+      setTimeout(() => {
+        fired++;
+        if (fired === total) done();
+      }, i % 10);
+    }
+  });
 });
 
 describe('setInterval', function() {
@@ -51,6 +62,52 @@ describe('requestAnimationFrame', () => {
       done();
     });
   });
+
+  it('run callbacks of a frame together in request order', done => {
+    // @ts-ignore
+    const before = __kraken_timer_stats__().dartFrameRequests;
+    const order: number[] = [];
+    const timestamps: number[] = [];
+    for (let i = 0; i < 50; i++) {
+      requestAnimationFrame((timestamp) => {
+        order.push(i);
+        timestamps.push(timestamp);
+        if (i === 49) {
+          // @ts-ignore
+          expect(__kraken_timer_stats__().dartFrameRequests - before).toBeLessThanOrEqual(1);
+          for (let j = 0; j < 50; j++) {
+            expect(order[j]).toBe(j);
+            expect(timestamps[j]).toBe(timestamps[0]);
+          }
+          done();
+        }
+      });
+    }
+  });
+
+  it('run callbacks requested during a frame in the next frame', done => {
+    let frameTimestamp = -1;
+    requestAnimationFrame((timestamp) => {
+      frameTimestamp = timestamp;
+      requestAnimationFrame((nextTimestamp) => {
+        expect(nextTimestamp).toBeGreaterThan(frameTimestamp);
+        done();
+      });
+    });
+  });
+
+  it('cancel a callback requested in the same frame', done => {
+    let second: number;
+    requestAnimationFrame(() => {
+      cancelAnimationFrame(second);
+    });
+    second = requestAnimationFrame(() => {
+      done.fail('cancelAnimationFrame not works.');
+    });
+    requestAnimationFrame(() => {
+      done();
+    });
+  });
 });
 
 describe('clearTimeout', () => {
@@ -73,4 +130,87 @@ describe('clearTimeout', () => {
     timer = null;
     clearTimeout(timer);
   });
-});
\ No newline at end of file
+});
+describe('native timer queue', () => {
+  afterEach(() => {
+    // @ts-ignore
+    __kraken_set_native_timer_queue__(false);
+  });
+
+  function scheduleTimers(count: number): Promise<number[]> {
+    return new Promise(resolve => {
+      const order: number[] = [];
+      for (let i = 0; i < count; i++) {
+        setTimeout(() => {
+          order.push(i);
+          if (order.length === count) resolve(order);
+        }, 10);
+      }
+    });
+  }
+
+  function countCrossings(stats: any) {
+    return stats.dartCalls + stats.dartCallbacks;
+  }
+
+  it('cross into dart far less often than dart timers', async () => {
+    const count = 100;
+    // @ts-ignore
+    let before = __kraken_timer_stats__();
+    await scheduleTimers(count);
+    // @ts-ignore
+    const dartCrossings = countCrossings(__kraken_timer_stats__()) - countCrossings(before);
+
+    // @ts-ignore
+    __kraken_set_native_timer_queue__(true);
+    // @ts-ignore
+    before = __kraken_timer_stats__();
+    const order = await scheduleTimers(count);
+    // @ts-ignore
+    const nativeCrossings = countCrossings(__kraken_timer_stats__()) - countCrossings(before);
+
+    expect(dartCrossings).toBeGreaterThanOrEqual(count * 2);
+    expect(nativeCrossings).toBeLessThan(dartCrossings / 4);
+    for (let i = 0; i < count; i++) {
+      expect(order[i]).toBe(i);
+    }
+  });
+
+  it('clearTimeout and clearInterval work with native timers', done => {
+    // @ts-ignore
+    __kraken_set_native_timer_queue__(true);
+    const timer = setTimeout(() => {
+      done.fail('clearTimeout not works.');
+    }, 20);
+    clearTimeout(timer);
+
+    let count = 0;
+    const interval = setInterval(() => {
+      count++;
+      if (count === 3) clearInterval(interval);
+    }, 10);
+
+    setTimeout(() => {
+      expect(count).toBe(3);
+      done();
+    }, 200);
+  });
+
+  it('clamp deeply nested zero timeouts', done => {
+    // @ts-ignore
+    __kraken_set_native_timer_queue__(true);
+    const start = Date.now();
+    let depth = 0;
+    function nest() {
+      depth++;
+      if (depth === 15) {
+        // Levels above 5 wait at least 4ms each.
+        expect(Date.now() - start).toBeGreaterThanOrEqual(30);
+        done();
+        return;
+      }
+      setTimeout(nest, 0);
+    }
+    setTimeout(nest, 0);
+  });
+});
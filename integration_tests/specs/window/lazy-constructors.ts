@@ -0,0 +1,33 @@
+/**
+ * Rarely used constructors are created on their first global lookup, they must behave like eagerly bound ones.
+ */
+describe('Lazy global constructors', () => {
+  const names = [
+    'CustomEvent', 'MouseEvent', 'CloseEvent', 'GestureEvent', 'MediaErrorEvent', 'TouchEvent', 'InputEvent',
+    'IntersectionChangeEvent', 'MessageEvent', 'Text', 'CommentNode', 'Image', 'HTMLImageElement',
+    'HTMLInputElement', 'SVGElement', 'Blob',
+  ];
+
+  names.forEach((name) => {
+    it(`${name} is defined`, () => {
+      // @ts-ignore
+      const first = globalThis[name];
+      expect(typeof first).toBe('function');
+      // @ts-ignore
+      expect(globalThis[name]).toBe(first);
+    });
+  });
+
+  it('returns the same constructor for instances', () => {
+    const event = new CustomEvent('lazy', { detail: 1 });
+    expect(event instanceof CustomEvent).toBe(true);
+    expect(event instanceof Event).toBe(true);
+
+    const image = document.createElement('img');
+    expect(image instanceof HTMLImageElement).toBe(true);
+    expect(Image).toBe(HTMLImageElement);
+
+    const text = document.createTextNode('lazy');
+    expect(text instanceof Text).toBe(true);
+  });
+});
@@ -13,8 +13,42 @@ import 'package:flutter/scheduler.dart';
 /// the Kraken JS Bridge Size
 int kKrakenJSBridgePoolSize = 8;
 
+/// The wire format of UI commands sent from the bridge, must be set before the first bridge initialized.
+UICommandEncoding kKrakenUICommandEncoding = UICommandEncoding.struct;
+
+/// Create all bridges in one shared JavaScriptCore context group, trading VM isolation between pages for memory
+/// and shared compiled code. Must be set before the first bridge initialized.
+bool kKrakenSharedJSContextGroup = false;
+
+/// Create rarely used constructors such as Blob or MouseEvent on first use, which shortens bridge construction.
+/// Must be set before the first bridge initialized.
+bool kKrakenLazyBinding = true;
+
+/// Number of spare bridges kept fully initialized, so opening another view does not pay for bridge construction.
+/// Spares are built one per idle slot after a view is created, must be set before the first bridge initialized.
+int kKrakenPrewarmedBridgeCount = 0;
+
+/// Time in microseconds each frame may spend on ui tasks registered by native threads, a negative value runs all
+/// of them. Longer backlogs are split across frames.
+int kKrakenUITaskFrameBudget = 4000;
+
+/// Keep setTimeout and setInterval timers in the bridge, due timers share one dart timer and fire in a batch.
+/// Applies to bridges initialized afterwards.
+bool kKrakenNativeTimerQueue = false;
+
+/// Drop ui commands without visible effect at the end of a frame, such as style writes overwritten in the same
+/// frame, before they are sent to dart. Applies to bridges initialized afterwards.
+bool kKrakenUICommandCoalescing = true;
+
 bool _firstView = true;
 
+void _schedulePrewarmContext() {
+  if (kKrakenPrewarmedBridgeCount <= 0) return;
+  SchedulerBinding.instance!.scheduleTask(() {
+    if (prewarmContext() > 0) _schedulePrewarmContext();
+  }, Priority.idle);
+}
+
 /// Init bridge
 int initBridge() {
   if (kProfileMode) {
@@ -37,6 +71,7 @@ int initBridge() {
       // Port flutter's frame callback into bridge.
       SchedulerBinding.instance!.addPersistentFrameCallback((_) {
         assert(contextId != -1);
+        flushUITask(kKrakenUITaskFrameBudget);
         flushUICommand();
         flushUICommandCallback();
       });
@@ -44,7 +79,10 @@ int initBridge() {
   }
 
   if (_firstView) {
-    initJSContextPool(kKrakenJSBridgePoolSize);
+    setLazyBindingEnabled(kKrakenLazyBinding);
+    setPrewarmedContextCount(kKrakenPrewarmedBridgeCount);
+    initJSContextPool(kKrakenJSBridgePoolSize,
+        uiCommandEncoding: kKrakenUICommandEncoding, sharedContextGroup: kKrakenSharedJSContextGroup);
     _firstView = false;
     contextId = 0;
   } else {
@@ -54,5 +92,9 @@ int initBridge() {
     }
   }
 
+  setNativeTimerQueue(contextId, kKrakenNativeTimerQueue);
+  setUICommandCoalescing(contextId, kKrakenUICommandCoalescing);
+  _schedulePrewarmContext();
+
   return contextId;
 }
@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'dart:convert';
 import 'dart:ffi';
 import 'dart:typed_data';
@@ -141,8 +142,10 @@ typedef DartRAFAsyncCallback = void Function(
 typedef NativeRequestBatchUpdate = Void Function(Int32 contextId);
 
 void _requestBatchUpdate(int contextId) {
-  KrakenController controller = KrakenController.getControllerOfJSContextId(contextId)!;
-  return controller.module.requestBatchUpdate();
+  // Bridges record commands before a controller owns them: the polyfill builds head and body while pool and prewarmed
+  // bridges are constructed. Those commands go out with the first flush after a controller took the bridge over.
+  KrakenController? controller = KrakenController.getControllerOfJSContextId(contextId);
+  controller?.module.requestBatchUpdate();
 }
 
 final Pointer<NativeFunction<NativeRequestBatchUpdate>> _nativeRequestBatchUpdate =
@@ -353,6 +356,23 @@ void _onJSError(int contextId, Pointer<Utf8> charStr) {
 
 final Pointer<NativeFunction<NativeJSError>> _nativeOnJsError = Pointer.fromFunction(_onJSError);
 
+typedef NativeHTMLConstructed = Void Function(Int32 contextId);
+
+final Map<int, Completer<void>> _htmlConstructions = {};
+
+/// Completes once the body of the document fed through [parseHTMLChunk] has been built and its scripts have run.
+/// Must be called before the final chunk is fed, a document without pending slices completes during that call.
+Future<void> htmlConstructed(int contextId) {
+  return (_htmlConstructions[contextId] ??= Completer<void>()).future;
+}
+
+void _onHTMLConstructed(int contextId) {
+  _htmlConstructions.remove(contextId)?.complete();
+}
+
+final Pointer<NativeFunction<NativeHTMLConstructed>> _nativeOnHTMLConstructed =
+    Pointer.fromFunction(_onHTMLConstructed);
+
 final List<int> _dartNativeMethods = [
   _nativeInvokeModule.address,
   _nativeRequestBatchUpdate.address,
@@ -372,6 +392,7 @@ final List<int> _dartNativeMethods = [
   _nativeInitDocument.address,
   _nativeGetEntries.address,
   _nativeOnJsError.address,
+  _nativeOnHTMLConstructed.address,
 ];
 
 typedef NativeRegisterDartMethods = Void Function(Pointer<Uint64> methodBytes, Int32 length);
@@ -230,9 +230,13 @@ class NativeBoundingClientRect extends Struct {
 typedef NativeDispatchEvent = Void Function(
     Pointer<NativeEventTarget> nativeEventTarget, Pointer<NativeString> eventType, Pointer<Void> nativeEvent, Int32 isCustomEvent);
 
+typedef NativeHasEventListener = Int32 Function(
+    Pointer<NativeEventTarget> nativeEventTarget, Pointer<NativeString> eventType);
+
 class NativeEventTarget extends Struct {
   external Pointer<Void> instance;
   external Pointer<NativeFunction<NativeDispatchEvent>> dispatchEvent;
+  external Pointer<NativeFunction<NativeHasEventListener>> hasEventListener;
 }
 
 class NativeNode extends Struct {
@@ -246,6 +250,46 @@ typedef NativeClick = Void Function(Pointer<NativeElement> nativeElement);
 typedef NativeScroll = Void Function(Pointer<NativeElement> nativeElement, Int32 x, Int32 y);
 typedef NativeScrollBy = Void Function(Pointer<NativeElement> nativeElement, Int32 x, Int32 y);
 typedef NativeSetViewModuleProperty = Void Function(Pointer<NativeElement> nativeElement, Int64 property, Double value);
+typedef NativeGetViewModuleProperties = Void Function(Pointer<NativeElement> nativeElement, Pointer<NativeViewModuleProperties> properties);
+
+// Fields follow the order of ViewModuleProperty.
+class NativeViewModuleProperties extends Struct {
+  @Double()
+  external double offsetTop;
+
+  @Double()
+  external double offsetLeft;
+
+  @Double()
+  external double offsetWidth;
+
+  @Double()
+  external double offsetHeight;
+
+  @Double()
+  external double clientWidth;
+
+  @Double()
+  external double clientHeight;
+
+  @Double()
+  external double clientTop;
+
+  @Double()
+  external double clientLeft;
+
+  @Double()
+  external double scrollTop;
+
+  @Double()
+  external double scrollLeft;
+
+  @Double()
+  external double scrollHeight;
+
+  @Double()
+  external double scrollWidth;
+}
 
 class NativeElement extends Struct {
   external Pointer<NativeNode> nativeNode;
@@ -257,6 +301,7 @@ class NativeElement extends Struct {
   external Pointer<NativeFunction<NativeClick>> click;
   external Pointer<NativeFunction<NativeScroll>> scroll;
   external Pointer<NativeFunction<NativeScrollBy>> scrollBy;
+  external Pointer<NativeFunction<NativeGetViewModuleProperties>> getViewModuleProperties;
 }
 
 typedef NativeWindowOpen = Void Function(Pointer<NativeWindow> nativeWindow, Pointer<NativeString> url);
@@ -401,6 +446,23 @@ class NativeCanvasRenderingContext2D extends Struct {
   external Pointer<NativeFunction<NativeRenderingContextTranslate>> translate;
 }
 
+class NativeCanvasDisplayList extends Struct {
+  external Pointer<NativeCanvasRenderingContext2D> nativeCanvasRenderingContext2D;
+
+  external Pointer<Double> ops;
+
+  @Int64()
+  external int length;
+
+  external Pointer<NativeString> strings;
+
+  @Int64()
+  external int stringCount;
+
+  @Int64()
+  external int replayed;
+}
+
 class NativePerformanceEntry extends Struct {
   external Pointer<Utf8> name;
   external Pointer<Utf8> entryType;
@@ -6,7 +6,9 @@ import 'package:flutter/scheduler.dart';
 import 'package:kraken/dom.dart';
 import 'package:kraken/kraken.dart';
 import 'package:kraken/module.dart';
+import 'package:kraken/src/dom/elements/canvas/canvas_context_2d.dart' show CanvasRenderingContext2D;
 import 'dart:io';
+import 'dart:typed_data';
 
 import 'from_native.dart';
 import 'platform.dart';
@@ -83,12 +85,23 @@ void invokeModuleEvent(int contextId, String moduleName, Event? event, String ex
 typedef DartDispatchEvent = void Function(
     Pointer<NativeEventTarget> nativeEventTarget, Pointer<NativeString> eventType, Pointer<Void> nativeEvent, int isCustomEvent);
 
+typedef DartHasEventListener = int Function(
+    Pointer<NativeEventTarget> nativeEventTarget, Pointer<NativeString> eventType);
+
 void emitUIEvent(int contextId, Pointer<NativeEventTarget> nativePtr, Event event) {
   Pointer<NativeEventTarget> nativeEventTarget = nativePtr;
+  Pointer<NativeString> eventTypeString = stringToNativeString(event.type);
+
+  // Neither the target nor its ancestors listen to this event, skip building the native event.
+  DartHasEventListener hasEventListener = nativeEventTarget.ref.hasEventListener.asFunction();
+  if (hasEventListener(nativeEventTarget, eventTypeString) == 0) {
+    freeNativeString(eventTypeString);
+    return;
+  }
+
   DartDispatchEvent dispatchEvent = nativeEventTarget.ref.dispatchEvent.asFunction();
   Pointer<Void> nativeEvent = event.toNative().cast<Void>();
   bool isCustomEvent = event is CustomEvent;
-  Pointer<NativeString> eventTypeString = stringToNativeString(event.type);
   dispatchEvent(nativeEventTarget, eventTypeString, nativeEvent, isCustomEvent ? 1 : 0);
   freeNativeString(eventTypeString);
 }
@@ -97,6 +110,18 @@ void emitModuleEvent(int contextId, String moduleName, Event? event, String extr
   invokeModuleEvent(contextId, moduleName, event, extra);
 }
 
+typedef NativeInvalidateLayout = Void Function(Int32 contextId);
+typedef DartInvalidateLayout = void Function(int contextId);
+
+final DartInvalidateLayout _invalidateLayout =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeInvalidateLayout>>('invalidateLayout').asFunction();
+
+/// Geometry cached by the bridge is read again afterwards. Events without listeners never reach the bridge, so
+/// layout and scroll changes have to be reported here.
+void invalidateLayout(int contextId) {
+  _invalidateLayout(contextId);
+}
+
 // Register createScreen
 typedef NativeCreateScreen = Pointer<Void> Function(Double, Double);
 typedef DartCreateScreen = Pointer<Void> Function(double, double);
@@ -148,15 +173,58 @@ void parseHTML(int contextId, String code, String url) {
   freeNativeString(nativeString);
 }
 
+// Register parseHTMLChunk
+typedef NativeParseHTMLChunk = Void Function(
+    Int32 contextId, Pointer<NativeString> chunk, Pointer<Utf8> url, Int32 isFinal);
+typedef DartParseHTMLChunk = void Function(
+    int contextId, Pointer<NativeString> chunk, Pointer<Utf8> url, int isFinal);
+
+final DartParseHTMLChunk _parseHTMLChunk =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeParseHTMLChunk>>('parseHTMLChunk').asFunction();
+
+/// Feed the next chunk of a document as it is received, url is only needed with the first chunk. The final chunk
+/// parses the document, body is then built in time budgeted slices over the following frames.
+void parseHTMLChunk(int contextId, String chunk, {String? url, bool isFinal = false}) {
+  Pointer<NativeString> nativeString = stringToNativeString(chunk);
+  Pointer<Utf8> _url = url == null ? nullptr : url.toNativeUtf8();
+  try {
+    _parseHTMLChunk(contextId, nativeString, _url, isFinal ? 1 : 0);
+  } catch (e, stack) {
+    print('$e\n$stack');
+  }
+  freeNativeString(nativeString);
+}
+
 // Register initJsEngine
-typedef NativeInitJSContextPool = Void Function(Int32 poolSize);
-typedef DartInitJSContextPool = void Function(int poolSize);
+typedef NativeInitJSContextPool = Void Function(Int32 poolSize, Int32 uiCommandEncoding);
+typedef DartInitJSContextPool = void Function(int poolSize, int uiCommandEncoding);
 
 final DartInitJSContextPool _initJSContextPool =
     nativeDynamicLibrary.lookup<NativeFunction<NativeInitJSContextPool>>('initJSContextPool').asFunction();
 
-void initJSContextPool(int poolSize) {
-  _initJSContextPool(poolSize);
+// Must keep the same order with UICommandEncoding in kraken_foundation.h
+enum UICommandEncoding {
+  struct,
+  compact,
+}
+
+UICommandEncoding _uiCommandEncoding = UICommandEncoding.struct;
+
+typedef NativeSetSharedJSContextGroupEnabled = Void Function(Int32 enabled);
+typedef DartSetSharedJSContextGroupEnabled = void Function(int enabled);
+
+final DartSetSharedJSContextGroupEnabled _setSharedJSContextGroupEnabled =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeSetSharedJSContextGroupEnabled>>('setSharedJSContextGroupEnabled').asFunction();
+
+/// When [sharedContextGroup] is true, every bridge of the pool shares one JavaScriptCore VM, heap and JIT code
+/// cache instead of creating its own.
+void initJSContextPool(int poolSize, {
+  UICommandEncoding uiCommandEncoding = UICommandEncoding.struct,
+  bool sharedContextGroup = false,
+}) {
+  _uiCommandEncoding = uiCommandEncoding;
+  _setSharedJSContextGroupEnabled(sharedContextGroup ? 1 : 0);
+  _initJSContextPool(poolSize, uiCommandEncoding.index);
 }
 
 typedef NativeDisposeContext = Void Function(Int32 contextId);
@@ -179,6 +247,74 @@ int allocateNewContext([int targetContextId = -1]) {
   return _allocateNewContext(targetContextId);
 }
 
+typedef NativeSetLazyBindingEnabled = Void Function(Int32 enabled);
+typedef DartSetLazyBindingEnabled = void Function(int enabled);
+
+final DartSetLazyBindingEnabled _setLazyBindingEnabled =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeSetLazyBindingEnabled>>('setLazyBindingEnabled').asFunction();
+
+/// Bridges created afterwards install rarely used constructors on their first global lookup.
+void setLazyBindingEnabled(bool enabled) {
+  _setLazyBindingEnabled(enabled ? 1 : 0);
+}
+
+typedef NativeSetFunctionClassCacheEnabled = Void Function(Int32 enabled);
+typedef DartSetFunctionClassCacheEnabled = void Function(int enabled);
+
+final DartSetFunctionClassCacheEnabled _setFunctionClassCacheEnabled = nativeDynamicLibrary
+    .lookup<NativeFunction<NativeSetFunctionClassCacheEnabled>>('setFunctionClassCacheEnabled')
+    .asFunction();
+
+/// Functions created afterwards with native private data share one class per callback and name.
+void setFunctionClassCacheEnabled(bool enabled) {
+  _setFunctionClassCacheEnabled(enabled ? 1 : 0);
+}
+
+typedef NativeSetPropertyNameCacheEnabled = Void Function(Int32 enabled);
+typedef DartSetPropertyNameCacheEnabled = void Function(int enabled);
+
+final DartSetPropertyNameCacheEnabled _setPropertyNameCacheEnabled = nativeDynamicLibrary
+    .lookup<NativeFunction<NativeSetPropertyNameCacheEnabled>>('setPropertyNameCacheEnabled')
+    .asFunction();
+
+/// Property names of host objects are converted once per context and looked up afterwards.
+void setPropertyNameCacheEnabled(bool enabled) {
+  _setPropertyNameCacheEnabled(enabled ? 1 : 0);
+}
+
+typedef NativeSetCanvasDisplayListEnabled = Void Function(Int32 enabled);
+typedef DartSetCanvasDisplayListEnabled = void Function(int enabled);
+
+final DartSetCanvasDisplayListEnabled _setCanvasDisplayListEnabled = nativeDynamicLibrary
+    .lookup<NativeFunction<NativeSetCanvasDisplayListEnabled>>('setCanvasDisplayListEnabled')
+    .asFunction();
+
+/// Canvas 2d ops are recorded into display lists, otherwise every op calls dart side on its own.
+void setCanvasDisplayListEnabled(bool enabled) {
+  _setCanvasDisplayListEnabled(enabled ? 1 : 0);
+}
+
+typedef NativeSetPrewarmedContextCount = Void Function(Int32 count);
+typedef DartSetPrewarmedContextCount = void Function(int count);
+
+final DartSetPrewarmedContextCount _setPrewarmedContextCount =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeSetPrewarmedContextCount>>('setPrewarmedContextCount').asFunction();
+
+void setPrewarmedContextCount(int count) {
+  _setPrewarmedContextCount(count);
+}
+
+typedef NativePrewarmContext = Int32 Function();
+typedef DartPrewarmContext = int Function();
+
+final DartPrewarmContext _prewarmContext =
+    nativeDynamicLibrary.lookup<NativeFunction<NativePrewarmContext>>('prewarmContext').asFunction();
+
+/// Build one spare bridge, returns how many spares are still missing.
+int prewarmContext() {
+  return _prewarmContext();
+}
+
 // Regisdster reloadJsContext
 typedef NativeReloadJSContext = Void Function(Int32 contextId);
 typedef DartReloadJSContext = void Function(int contextId);
@@ -215,6 +351,29 @@ void dispatchUITask(int contextId, Pointer<Void> context, Pointer<Void> callback
   _dispatchUITask(contextId, context, callback);
 }
 
+typedef NativeFlushUITaskWithBudget = Int64 Function(Int32 contextId, Int64 budgetMicroseconds);
+typedef DartFlushUITaskWithBudget = int Function(int contextId, int budgetMicroseconds);
+
+final DartFlushUITaskWithBudget _flushUITaskWithBudget =
+  nativeDynamicLibrary.lookup<NativeFunction<NativeFlushUITaskWithBudget>>('flushUITaskWithBudget').asFunction();
+
+// Run the ui tasks registered by native threads in registration order, stopping once budget has been spent.
+// A negative budget runs all of them. Returns the number of tasks left for the next call.
+int flushUITaskWithBudget(int contextId, int budgetMicroseconds) {
+  return _flushUITaskWithBudget(contextId, budgetMicroseconds);
+}
+
+// Flush the ui tasks of every context within the frame budget, tasks left over run in the next frame.
+void flushUITask(int budgetMicroseconds) {
+  Map<int, KrakenController?> controllerMap = KrakenController.getControllerMap();
+  for (KrakenController? controller in controllerMap.values) {
+    if (controller == null) continue;
+    if (flushUITaskWithBudget(controller.view.contextId, budgetMicroseconds) > 0) {
+      SchedulerBinding.instance!.scheduleFrame();
+    }
+  }
+}
+
 enum UICommandType {
   createElement,
   createTextNode,
@@ -228,6 +387,7 @@ enum UICommandType {
   removeProperty,
   cloneNode,
   removeEvent,
+  canvasDisplayList,
 }
 
 class UICommandItem extends Struct {
@@ -263,6 +423,133 @@ typedef DartClearUICommandItems = void Function(int contextId);
 final DartClearUICommandItems _clearUICommandItems =
     nativeDynamicLibrary.lookup<NativeFunction<NativeClearUICommandItems>>('clearUICommandItems').asFunction();
 
+typedef NativeReleaseUICommandItems = Void Function(Int32 contextId);
+typedef DartReleaseUICommandItems = void Function(int contextId);
+
+// Give the command frame back to native side after all items are read, so JS can keep recording into it.
+final DartReleaseUICommandItems _releaseUICommandItems =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeReleaseUICommandItems>>('releaseUICommandItems').asFunction();
+
+typedef NativeSetUICommandCoalescing = Void Function(Int32 contextId, Int32 enabled);
+typedef DartSetUICommandCoalescing = void Function(int contextId, int enabled);
+
+final DartSetUICommandCoalescing _setUICommandCoalescing =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeSetUICommandCoalescing>>('setUICommandCoalescing').asFunction();
+
+// Remove redundant ui commands (overwritten styles, repeated listeners, nodes disposed in the same frame)
+// before they are sent to dart.
+void setUICommandCoalescing(int contextId, bool enabled) {
+  _setUICommandCoalescing(contextId, enabled ? 1 : 0);
+}
+
+typedef NativeGetUICommandCoalescedCount = Int64 Function(Int32 contextId);
+typedef DartGetUICommandCoalescedCount = int Function(int contextId);
+
+final DartGetUICommandCoalescedCount _getUICommandCoalescedCount =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeGetUICommandCoalescedCount>>('getUICommandCoalescedCount').asFunction();
+
+// Count of ui commands eliminated by coalescing in the last flushed frame.
+int getUICommandCoalescedCount(int contextId) {
+  return _getUICommandCoalescedCount(contextId);
+}
+
+typedef NativeSetNativeTimerQueue = Void Function(Int32 contextId, Int32 enabled);
+typedef DartSetNativeTimerQueue = void Function(int contextId, int enabled);
+
+final DartSetNativeTimerQueue _setNativeTimerQueue =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeSetNativeTimerQueue>>('setNativeTimerQueue').asFunction();
+
+// Keep setTimeout and setInterval timers in the bridge, all due timers share one dart timer and fire in a batch.
+void setNativeTimerQueue(int contextId, bool enabled) {
+  _setNativeTimerQueue(contextId, enabled ? 1 : 0);
+}
+
+typedef NativeSetTraceEnabled = Void Function(Int32 enabled);
+typedef DartSetTraceEnabled = void Function(int enabled);
+
+final DartSetTraceEnabled _setTraceEnabled =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeSetTraceEnabled>>('setTraceEnabled').asFunction();
+
+// Record bridge hot paths (property access, ui commands, event dispatch, timers) into the native trace buffers.
+void setTraceEnabled(bool enabled) {
+  _setTraceEnabled(enabled ? 1 : 0);
+}
+
+typedef NativeClearTraceEvents = Void Function();
+typedef DartClearTraceEvents = void Function();
+
+final DartClearTraceEvents _clearTraceEvents =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeClearTraceEvents>>('clearTraceEvents').asFunction();
+
+void clearTraceEvents() {
+  _clearTraceEvents();
+}
+
+typedef NativeExportTraceEvents = Pointer<Utf8> Function();
+typedef DartExportTraceEvents = Pointer<Utf8> Function();
+
+final DartExportTraceEvents _exportTraceEvents =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeExportTraceEvents>>('exportTraceEvents').asFunction();
+
+// Recorded trace events in the Chrome trace event format, open it with chrome://tracing or ui.perfetto.dev.
+String exportTraceEvents() {
+  Pointer<Utf8> buffer = _exportTraceEvents();
+  String trace = buffer.toDartString();
+  malloc.free(buffer);
+  return trace;
+}
+
+typedef NativeGetBridgeStats = Pointer<Utf8> Function(Int32 contextId);
+typedef DartGetBridgeStats = Pointer<Utf8> Function(int contextId);
+
+final DartGetBridgeStats _getBridgeStats =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeGetBridgeStats>>('getBridgeStats').asFunction();
+
+// Ui command counts by type, payload bytes, flush latency histograms, dart call counts, bridge startup timing and
+// script cache counters of the context as JSON.
+String getBridgeStats(int contextId) {
+  Pointer<Utf8> buffer = _getBridgeStats(contextId);
+  String stats = buffer.toDartString();
+  malloc.free(buffer);
+  return stats;
+}
+
+typedef NativeResetBridgeStats = Void Function(Int32 contextId);
+typedef DartResetBridgeStats = void Function(int contextId);
+
+final DartResetBridgeStats _resetBridgeStats =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeResetBridgeStats>>('resetBridgeStats').asFunction();
+
+void resetBridgeStats(int contextId) {
+  _resetBridgeStats(contextId);
+}
+
+typedef NativeGetUICommandAtom = Pointer<NativeString> Function(Int32 contextId, Int32 atomId);
+typedef DartGetUICommandAtom = Pointer<NativeString> Function(int contextId, int atomId);
+
+final DartGetUICommandAtom _getUICommandAtom =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeGetUICommandAtom>>('getUICommandAtom').asFunction();
+
+// Interned ui command strings, such as style property names and event types.
+// Atoms are never released by native side, so they can be decoded once and cached per context.
+final Map<int, List<String>> _uiCommandAtoms = {};
+
+String _readUICommandAtom(int contextId, int atomId) {
+  List<String> atoms = _uiCommandAtoms.putIfAbsent(contextId, () => []);
+  while (atoms.length <= atomId) {
+    atoms.add(nativeStringToString(_getUICommandAtom(contextId, atoms.length)));
+  }
+  return atoms[atomId];
+}
+
+// Negative length represents an interned string, which length is -(atomId + 1).
+String _readUICommandArgs(int contextId, int stringMemory, int length) {
+  if (length < 0) {
+    return _readUICommandAtom(contextId, -length - 1);
+  }
+  return uint16ToString(Pointer.fromAddress(stringMemory), length);
+}
+
 class UICommand {
   late final UICommandType type;
   late final int id;
@@ -327,18 +614,16 @@ List<UICommand> readNativeUICommandToDart(Pointer<Uint64> nativeCommandItems, in
       args01Length = args02Length = 0;
     } else {
       args02Length = args01And02Length >> 32;
-      args01Length = args01And02Length ^ (args02Length << 32);
+      args01Length = (args01And02Length ^ (args02Length << 32)).toSigned(32);
     }
 
     int args01StringMemory = rawMemory[i + args01StringMemOffset];
     if (args01StringMemory != 0) {
-      Pointer<Uint16> args_01 = Pointer.fromAddress(args01StringMemory);
-      command.args.add(uint16ToString(args_01, args01Length));
+      command.args.add(_readUICommandArgs(contextId, args01StringMemory, args01Length));
 
       int args02StringMemory = rawMemory[i + args02StringMemOffset];
       if (args02StringMemory != 0) {
-        Pointer<Uint16> args_02 = Pointer.fromAddress(args02StringMemory);
-        command.args.add(uint16ToString(args_02, args02Length));
+        command.args.add(_readUICommandArgs(contextId, args02StringMemory, args02Length));
       }
     }
 
@@ -353,8 +638,114 @@ List<UICommand> readNativeUICommandToDart(Pointer<Uint64> nativeCommandItems, in
     return command;
   }, growable: false);
 
-  // Clear native command.
-  _clearUICommandItems(contextId);
+  // Release native command frame.
+  _releaseUICommandItems(contextId);
+
+  return results;
+}
+
+typedef NativeGetUICommandBytes = Pointer<Uint8> Function(Int32 contextId);
+typedef DartGetUICommandBytes = Pointer<Uint8> Function(int contextId);
+
+final DartGetUICommandBytes _getUICommandBytes =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeGetUICommandBytes>>('getUICommandBytes').asFunction();
+
+typedef NativeGetUICommandByteLength = Int64 Function(Int32 contextId);
+typedef DartGetUICommandByteLength = int Function(int contextId);
+
+final DartGetUICommandByteLength _getUICommandByteLength =
+    nativeDynamicLibrary.lookup<NativeFunction<NativeGetUICommandByteLength>>('getUICommandByteLength').asFunction();
+
+/**
+ * Compact ui command format, see UICommandEncoder in kraken_foundation.h
+ *  header:  uint8 version, varint command count.
+ *  command: uint8 opcode (bit 0-3: type, bit 4: has nativePtr, bit 5: has args_01, bit 6: has args_02),
+ *           zigzag varint id, [uint64 nativePtr], [args_01], [args_02].
+ *  args:    varint (value << 2 | kind), kind 0: atom with id `value`, kind 1: `value` latin1 bytes,
+ *           kind 2: `value` utf16 code units.
+ */
+const int compactUICommandVersion = 1;
+const int _opcodeTypeMask = 0x0f;
+const int _opcodeNativePtr = 1 << 4;
+const int _opcodeArgs01 = 1 << 5;
+const int _opcodeArgs02 = 1 << 6;
+const int _argsAtom = 0;
+const int _argsLatin1 = 1;
+
+class _CompactUICommandReader {
+  _CompactUICommandReader(this.bytes, this.contextId) : data = ByteData.sublistView(bytes);
+
+  final Uint8List bytes;
+  final ByteData data;
+  final int contextId;
+  int offset = 0;
+
+  int readVarint() {
+    int result = 0;
+    int shift = 0;
+    while (true) {
+      int byte = bytes[offset++];
+      result |= (byte & 0x7f) << shift;
+      if (byte < 0x80) return result;
+      shift += 7;
+    }
+  }
+
+  String readArgs() {
+    int tag = readVarint();
+    int kind = tag & 0x03;
+    int value = tag >> 2;
+    if (kind == _argsAtom) {
+      return _readUICommandAtom(contextId, value);
+    }
+
+    String result;
+    if (kind == _argsLatin1) {
+      result = String.fromCharCodes(bytes, offset, offset + value);
+      offset += value;
+    } else {
+      List<int> codeUnits = List.filled(value, 0);
+      for (int i = 0; i < value; i++) {
+        codeUnits[i] = data.getUint16(offset + i * 2, Endian.little);
+      }
+      result = String.fromCharCodes(codeUnits);
+      offset += value * 2;
+    }
+    return result;
+  }
+
+  UICommand readCommand() {
+    UICommand command = UICommand();
+    int opcode = bytes[offset++];
+    command.type = UICommandType.values[opcode & _opcodeTypeMask];
+
+    int zigzagId = readVarint();
+    command.id = (zigzagId >> 1) ^ -(zigzagId & 1);
+
+    if (opcode & _opcodeNativePtr != 0) {
+      command.nativePtr = Pointer.fromAddress(data.getUint64(offset, Endian.little));
+      offset += 8;
+    } else {
+      command.nativePtr = nullptr;
+    }
+
+    command.args = List.empty(growable: true);
+    if (opcode & _opcodeArgs01 != 0) command.args.add(readArgs());
+    if (opcode & _opcodeArgs02 != 0) command.args.add(readArgs());
+    return command;
+  }
+}
+
+List<UICommand> readCompactUICommandToDart(Pointer<Uint8> nativeBytes, int byteLength, int contextId) {
+  _CompactUICommandReader reader = _CompactUICommandReader(nativeBytes.asTypedList(byteLength), contextId);
+
+  int version = reader.bytes[reader.offset++];
+  assert(version == compactUICommandVersion, 'Unsupported ui command version: $version');
+
+  int commandLength = reader.readVarint();
+  List<UICommand> results = List.generate(commandLength, (int _) => reader.readCommand(), growable: false);
+
+  _releaseUICommandItems(contextId);
 
   return results;
 }
@@ -363,22 +754,54 @@ void clearUICommand(int contextId) {
   _clearUICommandItems(contextId);
 }
 
-void flushUICommand() {
-  Map<int, KrakenController?> controllerMap = KrakenController.getControllerMap();
-  for (KrakenController? controller in controllerMap.values) {
-    if (controller == null) continue;
-    Pointer<Uint64> nativeCommandItems = _getUICommandItems(controller.view.contextId);
-    int commandLength = _getUICommandItemSize(controller.view.contextId);
+/// Read the ui commands published by the bridge of contextId in the encoding chosen by initJSContextPool. Returns
+/// null when there is nothing to read.
+List<UICommand>? readUICommands(int contextId) {
+  if (_uiCommandEncoding == UICommandEncoding.compact) {
+    Pointer<Uint8> nativeBytes = _getUICommandBytes(contextId);
+    int byteLength = _getUICommandByteLength(contextId);
+
+    if (byteLength == 0) {
+      // Release a published frame with nothing to read, or the bridge can never publish another one.
+      _releaseUICommandItems(contextId);
+      return null;
+    }
+
+    if (kProfileMode) {
+      PerformanceTiming.instance().mark(PERF_FLUSH_UI_COMMAND_START);
+    }
+
+    return readCompactUICommandToDart(nativeBytes, byteLength, contextId);
+  } else {
+    Pointer<Uint64> nativeCommandItems = _getUICommandItems(contextId);
+    int commandLength = _getUICommandItemSize(contextId);
 
     if (commandLength == 0) {
-      continue;
+      _releaseUICommandItems(contextId);
+      return null;
     }
 
     if (kProfileMode) {
       PerformanceTiming.instance().mark(PERF_FLUSH_UI_COMMAND_START);
     }
 
-    List<UICommand> commands = readNativeUICommandToDart(nativeCommandItems, commandLength, controller.view.contextId);
+    return readNativeUICommandToDart(nativeCommandItems, commandLength, contextId);
+  }
+}
+
+void flushUICommand() {
+  Map<int, KrakenController?> controllerMap = KrakenController.getControllerMap();
+  for (KrakenController? controller in controllerMap.values) {
+    if (controller == null) continue;
+    int contextId = controller.view.contextId;
+    // Runs after layout of every frame, whether or not an event told the bridge about the changes.
+    invalidateLayout(contextId);
+    List<UICommand>? commands = readUICommands(contextId);
+
+    if (commands == null) {
+      continue;
+    }
+    int commandLength = commands.length;
 
     SchedulerBinding.instance!.scheduleFrame();
 
@@ -442,6 +865,9 @@ void flushUICommand() {
             String key = command.args[0];
             controller.view.removeProperty(id, key);
             break;
+          case UICommandType.canvasDisplayList:
+            CanvasRenderingContext2D.replayDisplayList(nativePtr.cast<NativeCanvasDisplayList>());
+            break;
           default:
             break;
         }
@@ -312,6 +312,7 @@ class Element extends Node
   void _scrollListener(double scrollOffset, AxisDirection axisDirection) {
     applyStickyChildrenOffset();
     paintFixedChildren(scrollOffset, axisDirection);
+    invalidateLayout(elementManager.contextId);
 
     if (eventHandlers.containsKey(EVENT_SCROLL)) {
       _fireScrollEvent();
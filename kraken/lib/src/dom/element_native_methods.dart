@@ -14,6 +14,8 @@ Pointer.fromFunction(ElementNativeMethods._getStringValueProperty);
 final Pointer<NativeFunction<NativeClick>> nativeClick = Pointer.fromFunction(ElementNativeMethods._click);
 final Pointer<NativeFunction<NativeScroll>> nativeScroll = Pointer.fromFunction(ElementNativeMethods._scroll);
 final Pointer<NativeFunction<NativeScrollBy>> nativeScrollBy = Pointer.fromFunction(ElementNativeMethods._scrollBy);
+final Pointer<NativeFunction<NativeGetViewModuleProperties>> nativeGetViewModuleProperties =
+    Pointer.fromFunction(ElementNativeMethods._getViewModuleProperties);
 
 // https://www.w3.org/TR/cssom-view-1/
 enum ViewModuleProperty {
@@ -79,6 +81,51 @@ mixin ElementNativeMethods on Node {
     }
   }
 
+  // Read all view module properties with one layout flush, bridge caches them until layout changed.
+  static void _getViewModuleProperties(Pointer<NativeElement> nativeElement, Pointer<NativeViewModuleProperties> nativeProperties) {
+    if (kProfileMode) {
+      PerformanceTiming.instance().mark(PERF_DOM_FORCE_LAYOUT_START);
+    }
+    Element element = Element.getElementOfNativePtr(nativeElement);
+    element.flushLayout();
+
+    if (kProfileMode) {
+      PerformanceTiming.instance().mark(PERF_DOM_FORCE_LAYOUT_END);
+    }
+
+    NativeViewModuleProperties properties = nativeProperties.ref;
+    RenderBoxModel? elementRenderBoxModel = element.renderBoxModel;
+
+    if (elementRenderBoxModel == null) {
+      properties.offsetTop = 0.0;
+      properties.offsetLeft = 0.0;
+      properties.offsetWidth = 0.0;
+      properties.offsetHeight = 0.0;
+      properties.clientWidth = 0.0;
+      properties.clientHeight = 0.0;
+      properties.clientTop = 0.0;
+      properties.clientLeft = 0.0;
+      properties.scrollTop = 0.0;
+      properties.scrollLeft = 0.0;
+      properties.scrollHeight = 0.0;
+      properties.scrollWidth = 0.0;
+      return;
+    }
+
+    properties.offsetTop = element.getOffsetY();
+    properties.offsetLeft = element.getOffsetX();
+    properties.offsetWidth = elementRenderBoxModel.hasSize ? elementRenderBoxModel.size.width : 0;
+    properties.offsetHeight = elementRenderBoxModel.hasSize ? elementRenderBoxModel.size.height : 0;
+    properties.clientWidth = elementRenderBoxModel.clientWidth;
+    properties.clientHeight = elementRenderBoxModel.clientHeight;
+    properties.clientTop = elementRenderBoxModel.renderStyle.borderTop;
+    properties.clientLeft = elementRenderBoxModel.renderStyle.borderLeft;
+    properties.scrollTop = element.scrollTop;
+    properties.scrollLeft = element.scrollLeft;
+    properties.scrollHeight = element.scrollHeight;
+    properties.scrollWidth = element.scrollWidth;
+  }
+
   static void _setViewModuleProperty(Pointer<NativeElement> nativeElement, int property, double value) {
     Element element = Element.getElementOfNativePtr(nativeElement);
     element.flushLayout();
@@ -139,5 +186,6 @@ mixin ElementNativeMethods on Node {
     nativeElement.ref.click = nativeClick;
     nativeElement.ref.scroll = nativeScroll;
     nativeElement.ref.scrollBy = nativeScrollBy;
+    nativeElement.ref.getViewModuleProperties = nativeGetViewModuleProperties;
   }
 }
@@ -75,6 +75,47 @@ const String SQUARE = 'square';
 const String MITER = 'miter';
 const String BEVEL = 'bevel';
 
+// Must be as same as the CanvasDisplayListOp enum of bridge side.
+enum CanvasDisplayListOp {
+  setDirection,
+  setFont,
+  setFillStyle,
+  setStrokeStyle,
+  setLineCap,
+  setLineDashOffset,
+  setLineJoin,
+  setLineWidth,
+  setMiterLimit,
+  setTextAlign,
+  setTextBaseline,
+  arc,
+  arcTo,
+  beginPath,
+  bezierCurveTo,
+  clearRect,
+  clip,
+  closePath,
+  ellipse,
+  fill,
+  fillRect,
+  fillText,
+  lineTo,
+  moveTo,
+  quadraticCurveTo,
+  rect,
+  restore,
+  rotate,
+  resetTransform,
+  save,
+  scale,
+  stroke,
+  strokeRect,
+  strokeText,
+  setTransform,
+  transform,
+  translate
+}
+
 class CanvasRenderingContext2DSettings {
   bool alpha = true;
   bool desynchronized = false;
@@ -359,6 +400,181 @@ class CanvasRenderingContext2D {
     canvasRenderingContext2D.translate(x, y);
   }
 
+  // Replay ops recorded by bridge in one call, each op is followed by a fixed count of doubles
+  // and strings are passed as index of the string table.
+  static void replayDisplayList(Pointer<NativeCanvasDisplayList> nativeDisplayList) {
+    NativeCanvasDisplayList displayList = nativeDisplayList.ref;
+    CanvasRenderingContext2D context = getCanvasRenderContext2DOfNativePtr(displayList.nativeCanvasRenderingContext2D);
+    if (displayList.length == 0) {
+      displayList.replayed = 1;
+      return;
+    }
+
+    Float64List ops = displayList.ops.asTypedList(displayList.length);
+    List<String> strings = List.generate(displayList.stringCount, (int i) => nativeStringToString(displayList.strings.elementAt(i)));
+
+    context._replaying = true;
+    int i = 0;
+    try {
+      while (i < ops.length) {
+        CanvasDisplayListOp op = CanvasDisplayListOp.values[ops[i++].toInt()];
+        switch (op) {
+          case CanvasDisplayListOp.setDirection:
+            context.direction = parseDirection(strings[ops[i++].toInt()]);
+            break;
+          case CanvasDisplayListOp.setFont:
+            context.font = strings[ops[i++].toInt()];
+            break;
+          case CanvasDisplayListOp.setFillStyle:
+            Color? color = CSSColor.parseColor(strings[ops[i++].toInt()]);
+            if (color != null) context.fillStyle = color;
+            break;
+          case CanvasDisplayListOp.setStrokeStyle:
+            Color? color = CSSColor.parseColor(strings[ops[i++].toInt()]);
+            if (color != null) context.strokeStyle = color;
+            break;
+          case CanvasDisplayListOp.setLineCap:
+            context.lineCap = parseLineCap(strings[ops[i++].toInt()]);
+            break;
+          case CanvasDisplayListOp.setLineDashOffset:
+            double? value = double.tryParse(strings[ops[i++].toInt()]);
+            if (value != null) context.lineDashOffset = value;
+            break;
+          case CanvasDisplayListOp.setLineJoin:
+            context.lineJoin = parseLineJoin(strings[ops[i++].toInt()]);
+            break;
+          case CanvasDisplayListOp.setLineWidth:
+            double? value = double.tryParse(strings[ops[i++].toInt()]);
+            if (value != null) context.lineWidth = value;
+            break;
+          case CanvasDisplayListOp.setMiterLimit:
+            double? value = double.tryParse(strings[ops[i++].toInt()]);
+            if (value != null) context.miterLimit = value;
+            break;
+          case CanvasDisplayListOp.setTextAlign:
+            context.textAlign = parseTextAlign(strings[ops[i++].toInt()]);
+            break;
+          case CanvasDisplayListOp.setTextBaseline:
+            context.textBaseline = parseTextBaseline(strings[ops[i++].toInt()]);
+            break;
+          case CanvasDisplayListOp.arc:
+            context.arc(ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], anticlockwise: ops[i + 5] == 1);
+            i += 6;
+            break;
+          case CanvasDisplayListOp.arcTo:
+            context.arcTo(ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4]);
+            i += 5;
+            break;
+          case CanvasDisplayListOp.beginPath:
+            context.beginPath();
+            break;
+          case CanvasDisplayListOp.bezierCurveTo:
+            context.bezierCurveTo(ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+            i += 6;
+            break;
+          case CanvasDisplayListOp.clearRect:
+            context.clearRect(ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+            i += 4;
+            break;
+          case CanvasDisplayListOp.clip:
+            context.clip(strings[ops[i++].toInt()] == EVENODD ? PathFillType.evenOdd : PathFillType.nonZero);
+            break;
+          case CanvasDisplayListOp.closePath:
+            context.closePath();
+            break;
+          case CanvasDisplayListOp.ellipse:
+            context.ellipse(ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5], ops[i + 6], anticlockwise: ops[i + 7] == 1);
+            i += 8;
+            break;
+          case CanvasDisplayListOp.fill:
+            context.fill(strings[ops[i++].toInt()] == EVENODD ? PathFillType.evenOdd : PathFillType.nonZero);
+            break;
+          case CanvasDisplayListOp.fillRect:
+            context.fillRect(ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+            i += 4;
+            break;
+          case CanvasDisplayListOp.fillText:
+            String text = strings[ops[i].toInt()];
+            double maxWidth = ops[i + 3];
+            if (!maxWidth.isNaN) {
+              context.fillText(text, ops[i + 1], ops[i + 2], maxWidth: maxWidth);
+            } else {
+              context.fillText(text, ops[i + 1], ops[i + 2]);
+            }
+            i += 4;
+            break;
+          case CanvasDisplayListOp.lineTo:
+            context.lineTo(ops[i], ops[i + 1]);
+            i += 2;
+            break;
+          case CanvasDisplayListOp.moveTo:
+            context.moveTo(ops[i], ops[i + 1]);
+            i += 2;
+            break;
+          case CanvasDisplayListOp.quadraticCurveTo:
+            context.quadraticCurveTo(ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+            i += 4;
+            break;
+          case CanvasDisplayListOp.rect:
+            context.rect(ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+            i += 4;
+            break;
+          case CanvasDisplayListOp.restore:
+            context.restore();
+            break;
+          case CanvasDisplayListOp.rotate:
+            context.rotate(ops[i++]);
+            break;
+          case CanvasDisplayListOp.resetTransform:
+            context.resetTransform();
+            break;
+          case CanvasDisplayListOp.save:
+            context.save();
+            break;
+          case CanvasDisplayListOp.scale:
+            context.scale(ops[i], ops[i + 1]);
+            i += 2;
+            break;
+          case CanvasDisplayListOp.stroke:
+            context.stroke();
+            break;
+          case CanvasDisplayListOp.strokeRect:
+            context.strokeRect(ops[i], ops[i + 1], ops[i + 2], ops[i + 3]);
+            i += 4;
+            break;
+          case CanvasDisplayListOp.strokeText:
+            String text = strings[ops[i].toInt()];
+            double maxWidth = ops[i + 3];
+            if (!maxWidth.isNaN) {
+              context.strokeText(text, ops[i + 1], ops[i + 2], maxWidth: maxWidth);
+            } else {
+              context.strokeText(text, ops[i + 1], ops[i + 2]);
+            }
+            i += 4;
+            break;
+          case CanvasDisplayListOp.setTransform:
+            context.setTransform(ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+            i += 6;
+            break;
+          case CanvasDisplayListOp.transform:
+            context.transform(ops[i], ops[i + 1], ops[i + 2], ops[i + 3], ops[i + 4], ops[i + 5]);
+            i += 6;
+            break;
+          case CanvasDisplayListOp.translate:
+            context.translate(ops[i], ops[i + 1]);
+            i += 2;
+            break;
+        }
+      }
+    } finally {
+      context._replaying = false;
+      displayList.replayed = 1;
+    }
+
+    // Must trigger repaint after actions
+    context.canvas.repaintNotifier.notifyListeners(); // ignore: invalid_use_of_visible_for_testing_member, invalid_use_of_protected_member
+  }
+
   late CanvasRenderingContext2DSettings _settings;
 
   CanvasRenderingContext2DSettings getContextAttributes() => _settings;
@@ -376,8 +592,12 @@ class CanvasRenderingContext2D {
 
   List<CanvasAction> _actions = [];
 
+  // Display list replay triggers repaint once after all actions are added.
+  bool _replaying = false;
+
   void addAction(CanvasAction action) {
     _actions.add(action);
+    if (_replaying) return;
     // Must trigger repaint after action
     canvas.repaintNotifier.notifyListeners(); // ignore: invalid_use_of_visible_for_testing_member, invalid_use_of_protected_member
   }
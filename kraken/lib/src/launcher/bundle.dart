@@ -2,6 +2,7 @@ import 'dart:async';
 import 'dart:convert';
 import 'dart:core';
 import 'dart:io';
+import 'dart:math' as math;
 import 'dart:typed_data';
 
 import 'package:kraken/bridge.dart';
@@ -17,6 +18,9 @@ const String BUNDLE_PATH = 'KRAKEN_BUNDLE_PATH';
 const String ENABLE_DEBUG = 'KRAKEN_ENABLE_DEBUG';
 const String ENABLE_PERFORMANCE_OVERLAY = 'KRAKEN_ENABLE_PERFORMANCE_OVERLAY';
 
+// Code units of an HTML bundle handed to the bridge per parseHTMLChunk call.
+const int _HTML_CHUNK_LENGTH = 64 * 1024;
+
 String? getBundleURLFromEnv() {
   return Platform.environment[BUNDLE_URL];
 }
@@ -77,8 +81,16 @@ abstract class KrakenBundle {
     }
 
     if (contentType?.mimeType == ContentType.html.mimeType || url.toString().contains('.html')) {
-      // parse html.
-      parseHTML(contextId, content, url.toString());
+      // Body is built in slices over the next frames, wait for it so load events fire after the document exists.
+      Future<void> constructed = htmlConstructed(contextId);
+      int start = 0;
+      do {
+        int end = math.min(start + _HTML_CHUNK_LENGTH, content.length);
+        parseHTMLChunk(contextId, content.substring(start, end),
+            url: start == 0 ? url.toString() : null, isFinal: end == content.length);
+        start = end;
+      } while (start < content.length);
+      await constructed;
     } else {
       // eval JavaScript.
       evaluateScripts(contextId, content, url.toString(), lineOffset);
@@ -0,0 +1,95 @@
+import 'dart:async';
+import 'dart:io';
+import 'package:flutter/widgets.dart';
+import 'package:kraken/bridge.dart';
+import 'package:kraken/kraken.dart';
+
+// Shared setup, timing and reporting of the benchmarks in this directory. Each benchmark only provides its workload:
+//
+//   void main() => runBenchmark('name', (Benchmark benchmark) {
+//     benchmark.report('workload: ${benchmark.medianMs(benchmark.repeat(() => benchmark.timeScript(code)))}');
+//   }, setup: setupScript);
+//
+// Timings are in microseconds.
+const int benchmarkRounds = int.fromEnvironment('KRAKEN_ROUNDS', defaultValue: 10);
+
+typedef BenchmarkWorkload = FutureOr<void> Function(Benchmark benchmark);
+
+// Creates the context of the benchmark, evaluates [setup] in it and exits once [workload] completes. Set the
+// kKraken* settings of package:kraken/bridge.dart other than the pool size before calling this.
+Future<void> runBenchmark(String name, BenchmarkWorkload workload, {int poolSize = 1, String? setup}) async {
+  kKrakenJSBridgePoolSize = poolSize;
+  Benchmark benchmark = Benchmark._(name);
+  if (setup != null) {
+    benchmark.evaluate(setup);
+    flushUICommand();
+  }
+  await workload(benchmark);
+  exit(0);
+}
+
+class Benchmark {
+  Benchmark._(this.name) : contextId = createContext();
+
+  final String name;
+  final int contextId;
+
+  // Benchmarks run without a widget tree, but native code calls back into the controller of a context as soon as it
+  // records ui commands. Every context which builds DOM nodes needs a controller. The first controller initializes
+  // the bridge pool, later ones allocate their context from it.
+  static int createContext() {
+    WidgetsFlutterBinding.ensureInitialized();
+    return KrakenController(null, 360, 640).view.contextId;
+  }
+
+  void report(String line) {
+    print('[$name] $line');
+  }
+
+  void evaluate(String code, {int? contextId}) {
+    evaluateScripts(contextId ?? this.contextId, code, '$name.js', 0);
+  }
+
+  int time(void Function() call) {
+    Stopwatch stopwatch = Stopwatch()..start();
+    call();
+    return stopwatch.elapsedMicroseconds;
+  }
+
+  // Times [code] in the benchmark context. Recorded ui commands are applied after the timing, or within it with
+  // [includeFlush].
+  int timeScript(String code, {bool includeFlush = false}) {
+    int elapsed = time(() {
+      evaluate(code);
+      if (includeFlush) flushUICommand();
+    });
+    if (!includeFlush) flushUICommand();
+    return elapsed;
+  }
+
+  List<int> repeat(int Function() sample, {int rounds = benchmarkRounds}) {
+    return List<int>.generate(rounds, (_) => sample());
+  }
+
+  // Samples with [setEnabled] true and false in alternation, so both modes see the same heap and JIT state. Leaves
+  // the mode enabled.
+  Map<bool, List<int>> compare(void Function(bool enabled) setEnabled, int Function() sample,
+      {int rounds = benchmarkRounds}) {
+    Map<bool, List<int>> samples = {true: [], false: []};
+    for (int round = 0; round < rounds; round++) {
+      for (bool enabled in [true, false]) {
+        setEnabled(enabled);
+        samples[enabled]!.add(sample());
+      }
+    }
+    setEnabled(true);
+    return samples;
+  }
+
+  String medianMs(List<int> samples) => 'median ${median(samples) ~/ 1000} ms';
+}
+
+int median(List<int> values) {
+  values.sort();
+  return values[values.length ~/ 2];
+}
@@ -0,0 +1,29 @@
+import 'package:kraken/bridge.dart';
+import 'dart:convert';
+import 'benchmark.dart';
+
+// Compares bridge construction with eager and lazy host class binding. Bridges of both modes are built in
+// alternation in the same process, so both see the same warm caches.
+//
+//   flutter run --profile -t lib/bridge_startup.dart
+const int rounds = int.fromEnvironment('KRAKEN_STARTUP_ROUNDS', defaultValue: 20);
+
+void main() => runBenchmark('bridge_startup', (Benchmark benchmark) {
+      bool lazy = true;
+      Map<bool, List<int>> total = {true: [], false: []};
+      Map<bool, List<int>> bindings = benchmark.compare((bool enabled) {
+        lazy = enabled;
+        setLazyBindingEnabled(enabled);
+      }, () {
+        allocateNewContext(1);
+        Map<String, dynamic> startup = jsonDecode(getBridgeStats(1))['startupUs'];
+        disposeContext(1);
+        total[lazy]!.add(startup['total']);
+        return startup['bindings'];
+      }, rounds: rounds);
+
+      for (bool mode in [false, true]) {
+        benchmark.report('${mode ? 'lazy' : 'eager'} binding: median bindings ${median(bindings[mode]!)} us, '
+            'median total ${median(total[mode]!)} us');
+      }
+    }, poolSize: 2);
@@ -0,0 +1,36 @@
+import 'package:kraken/bridge.dart';
+import 'benchmark.dart';
+
+// Times stroking a polyline of 50k lineTo calls, with ops recorded into a display list and replayed once per flush,
+// and with every op calling dart side on its own, the behavior before display lists. Each round includes the flush
+// which replays the list.
+//
+//   flutter run --profile -t lib/canvas_polyline.dart
+const int pointCount = int.fromEnvironment('KRAKEN_POINT_COUNT', defaultValue: 50000);
+
+const String setup = '''
+var canvas = document.createElement('canvas');
+canvas.width = 300;
+canvas.height = 300;
+document.body.appendChild(canvas);
+var context = canvas.getContext('2d');
+''';
+
+const String polyline = '''
+context.clearRect(0, 0, 300, 300);
+context.beginPath();
+context.moveTo(0, 150);
+for (var i = 1; i < $pointCount; i++) {
+  context.lineTo(i % 300, 150 + Math.sin(i / 10) * 100);
+}
+context.strokeStyle = 'blue';
+context.stroke();
+''';
+
+void main() => runBenchmark('canvas_polyline', (Benchmark benchmark) {
+      Map<bool, List<int>> times = benchmark.compare(
+          setCanvasDisplayListEnabled, () => benchmark.timeScript(polyline, includeFlush: true));
+      benchmark.report('$pointCount points');
+      benchmark.report('display list: ${benchmark.medianMs(times[true]!)}');
+      benchmark.report('call per op: ${benchmark.medianMs(times[false]!)}');
+    }, setup: setup);
@@ -0,0 +1,48 @@
+import 'package:flutter/widgets.dart';
+import 'package:kraken/bridge.dart';
+import 'dart:io';
+
+// Measures the resident memory of N bridges, each running the same script.
+//
+// Run once per mode and compare the printed deltas:
+//   flutter run --profile -t lib/context_memory.dart --dart-define=KRAKEN_CONTEXT_COUNT=8
+//   flutter run --profile -t lib/context_memory.dart --dart-define=KRAKEN_CONTEXT_COUNT=8 --dart-define=KRAKEN_SHARED_CONTEXT_GROUP=true
+const int contextCount = int.fromEnvironment('KRAKEN_CONTEXT_COUNT', defaultValue: 8);
+const bool sharedContextGroup = bool.fromEnvironment('KRAKEN_SHARED_CONTEXT_GROUP');
+
+const String workload = '''
+function render(n) {
+  var out = [];
+  for (var i = 0; i < n; i++) {
+    out.push(JSON.stringify({ id: i, name: 'item' + i, tags: [i % 3, i % 5, i % 7] }));
+  }
+  return out.join(',').length;
+}
+for (var round = 0; round < 20; round++) render(2000);
+''';
+
+int _rssInKB() => ProcessInfo.currentRss ~/ 1024;
+
+void main() {
+  WidgetsFlutterBinding.ensureInitialized();
+  registerDartMethodsToCpp();
+
+  int baseline = _rssInKB();
+  initJSContextPool(contextCount, sharedContextGroup: sharedContextGroup);
+  for (int i = 1; i < contextCount; i++) {
+    allocateNewContext(i);
+  }
+  int constructed = _rssInKB();
+
+  for (int i = 0; i < contextCount; i++) {
+    evaluateScripts(i, workload, 'context_memory.js', 0);
+  }
+  int executed = _rssInKB();
+
+  print('[context_memory] mode: ${sharedContextGroup ? 'shared group' : 'group per context'}, contexts: $contextCount');
+  print('[context_memory] after construction: +${constructed - baseline} KB, '
+      '${(constructed - baseline) ~/ contextCount} KB per context');
+  print('[context_memory] after workload: +${executed - baseline} KB, '
+      '${(executed - baseline) ~/ contextCount} KB per context');
+  exit(0);
+}
@@ -0,0 +1,35 @@
+import 'benchmark.dart';
+
+// Times dispatching bubbling events from the leaf of a 50 level deep tree, with listeners on the leaf and the root
+// and none on the levels in between.
+//
+//   flutter run --profile -t lib/event_dispatch.dart
+const int depth = int.fromEnvironment('KRAKEN_TREE_DEPTH', defaultValue: 50);
+
+const String setup = '''
+var root = document.createElement('div');
+var leaf = root;
+for (var i = 0; i < $depth; i++) {
+  var child = document.createElement('div');
+  leaf.appendChild(child);
+  leaf = child;
+}
+document.body.appendChild(root);
+var received = 0;
+leaf.addEventListener('bench', function() { received++; });
+root.addEventListener('bench', function() { received++; });
+''';
+
+const String dispatch = '''
+for (var i = 0; i < 10000; i++) {
+  var event = document.createEvent('Event');
+  event.initEvent('bench', true, true);
+  leaf.dispatchEvent(event);
+}
+''';
+
+void main() => runBenchmark('event_dispatch', (Benchmark benchmark) {
+      List<int> times = benchmark.repeat(() => benchmark.timeScript(dispatch))..sort();
+      benchmark.report('10k events through $depth ancestors: ${benchmark.medianMs(times)}, '
+          'min ${times.first ~/ 1000} ms');
+    }, setup: setup);
@@ -0,0 +1,62 @@
+import 'package:kraken/bridge.dart';
+import 'dart:convert';
+import 'benchmark.dart';
+
+// Host class and function JSClassRefs are created by the first bridge of the process and reused afterwards.
+// Compares the binding phase of that first bridge with bridges created later, with every class bound eagerly.
+//
+// Then compares call throughput through the cached classes with a class created per function, the behavior before
+// the cache: property gets and method calls on host objects, and Blob.text() which creates a promise function with
+// private data on every call.
+//
+//   flutter run --profile -t lib/host_class_refs.dart
+const int startupRounds = int.fromEnvironment('KRAKEN_STARTUP_ROUNDS', defaultValue: 20);
+
+const String setup = '''
+var element = document.createElement('div');
+element.setAttribute('id', 'host');
+var blob = new Blob(['kraken']);
+''';
+
+const Map<String, String> calls = {
+  '100k property gets': '''
+for (var i = 0; i < 100000; i++) {
+  element.nodeType;
+  blob.size;
+}
+''',
+  '100k method calls': '''
+for (var i = 0; i < 100000; i++) {
+  element.getAttribute('id');
+}
+''',
+  '10k Blob.text() calls': '''
+for (var i = 0; i < 10000; i++) {
+  blob.text();
+}
+''',
+};
+
+int _bindingsUs(int contextId) => jsonDecode(getBridgeStats(contextId))['startupUs']['bindings'];
+
+void main() {
+  kKrakenLazyBinding = false;
+  runBenchmark('host_class_refs', (Benchmark benchmark) {
+    int cold = _bindingsUs(benchmark.contextId);
+    List<int> warm = benchmark.repeat(() {
+      allocateNewContext(1);
+      int bindings = _bindingsUs(1);
+      disposeContext(1);
+      return bindings;
+    }, rounds: startupRounds);
+    benchmark.report('first bridge bindings: $cold us');
+    benchmark.report('later bridges bindings: median ${median(warm)} us');
+
+    benchmark.evaluate(setup);
+    calls.forEach((String name, String code) {
+      Map<bool, List<int>> times = benchmark.compare(setFunctionClassCacheEnabled, () => benchmark.timeScript(code));
+      benchmark.report('$name: cached classes ${benchmark.medianMs(times[true]!)}, '
+          'class per function ${benchmark.medianMs(times[false]!)}');
+    });
+  }, poolSize: 2);
+}
@@ -0,0 +1,65 @@
+import 'package:flutter/scheduler.dart';
+import 'package:kraken/bridge.dart';
+import 'dart:async';
+import 'dart:convert';
+import 'benchmark.dart';
+
+// Feeds a multi-megabyte document to the streaming parser in network sized chunks and compares the longest time
+// the ui thread was blocked with a single parseHTML call of the same document.
+//
+//   flutter run --profile -t lib/html_parse.dart --dart-define=KRAKEN_HTML_ROWS=40000
+const int rowCount = int.fromEnvironment('KRAKEN_HTML_ROWS', defaultValue: 40000);
+const int chunkSize = 64 * 1024;
+
+// Rows of nested elements with attributes and inline styles, with a few scripts which must run in document order.
+String _generateDocument() {
+  StringBuffer buffer = StringBuffer('<html><body><script>var order = [];</script>');
+  for (int i = 0; i < rowCount; i++) {
+    buffer.write('<div class="row" style="display: flex; padding: 4px"><span id="label$i">row $i</span>'
+        '<p>Lorem ipsum dolor sit amet, <b>consectetur</b> adipiscing elit.</p></div>');
+    if (i % 10000 == 0) buffer.write('<script>order.push($i);</script>');
+  }
+  buffer.write('</body></html>');
+  return buffer.toString();
+}
+
+Map<String, dynamic> _parserStats(int contextId) => jsonDecode(getBridgeStats(contextId))['htmlParser'];
+
+void main() => runBenchmark('html_parse', (Benchmark benchmark) {
+      // The benchmark context takes the blocking parse, a second context the streaming parse.
+      int streamingContextId = Benchmark.createContext();
+
+      String document = _generateDocument();
+      benchmark.report('document: ${document.length ~/ 1024} KB');
+
+      int blocking = benchmark.time(() => parseHTML(benchmark.contextId, document, 'https://example.com/sync.html'));
+      benchmark.report('parseHTML: ${blocking ~/ 1000} ms blocking');
+
+      int longestCall = 0;
+      Stopwatch stopwatch = Stopwatch()..start();
+      for (int start = 0; start < document.length; start += chunkSize) {
+        int end = start + chunkSize < document.length ? start + chunkSize : document.length;
+        int call = benchmark.time(() => parseHTMLChunk(streamingContextId, document.substring(start, end),
+            url: start == 0 ? 'https://example.com/streaming.html' : null, isFinal: end == document.length));
+        if (call > longestCall) longestCall = call;
+      }
+
+      Completer<void> constructed = Completer<void>();
+      int frames = 0;
+      void waitForConstruction(Duration timeStamp) {
+        frames++;
+        Map<String, dynamic> stats = _parserStats(streamingContextId);
+        if (stats['constructing']) {
+          SchedulerBinding.instance!.scheduleFrameCallback(waitForConstruction);
+          SchedulerBinding.instance!.scheduleFrame();
+          return;
+        }
+        benchmark.report('parseHTMLChunk: ${stopwatch.elapsedMilliseconds} ms over $frames frames, '
+            'longest call ${longestCall ~/ 1000} ms, longest slice ${stats['maxSliceUs'] ~/ 1000} ms, '
+            '${stats['slices']} slices, ${stats['nodes']} nodes');
+        constructed.complete();
+      }
+      SchedulerBinding.instance!.scheduleFrameCallback(waitForConstruction);
+      SchedulerBinding.instance!.scheduleFrame();
+      return constructed.future;
+    }, poolSize: 2);
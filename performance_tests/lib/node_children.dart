@@ -0,0 +1,38 @@
+import 'benchmark.dart';
+
+// Times appending, iterating, indexing and removing 100k children of one element.
+//
+//   flutter run --profile -t lib/node_children.dart
+const int childCount = int.fromEnvironment('KRAKEN_CHILD_COUNT', defaultValue: 100000);
+
+const String setup = '''
+var container = document.createElement('div');
+''';
+
+const String append = '''
+for (var i = 0; i < $childCount; i++) {
+  container.appendChild(document.createTextNode(String(i)));
+}
+''';
+
+const String iterate = '''
+var visited = 0;
+for (var node = container.firstChild; node; node = node.nextSibling) visited++;
+''';
+
+const String index = '''
+for (var i = 0; i < $childCount; i += 100) container.childNodes[i];
+''';
+
+const String remove = '''
+while (container.lastChild) container.removeChild(container.firstChild);
+''';
+
+void main() => runBenchmark('node_children', (Benchmark benchmark) {
+      int ms(String code) => benchmark.timeScript(code) ~/ 1000;
+      benchmark.report('$childCount children');
+      benchmark.report('append: ${ms(append)} ms');
+      benchmark.report('iterate siblings: ${ms(iterate)} ms');
+      benchmark.report('index every 100th child: ${ms(index)} ms');
+      benchmark.report('remove from front: ${ms(remove)} ms');
+    }, setup: setup);
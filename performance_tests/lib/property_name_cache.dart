@@ -0,0 +1,38 @@
+import 'package:kraken/bridge.dart';
+import 'benchmark.dart';
+
+// Times property access on host objects with the per context property name cache and without it, the behavior
+// before the cache converted every name again. Common names hit the cache, distinct expando names fill it up and then
+// take the uncached path.
+//
+//   flutter run --profile -t lib/property_name_cache.dart
+const String setup = '''
+var element = document.createElement('div');
+document.body.appendChild(element);
+''';
+
+const String commonNames = '''
+for (var i = 0; i < 100000; i++) {
+  element.nodeType;
+  element.tagName;
+  element.parentNode;
+  element.firstChild;
+  element.style;
+}
+''';
+
+const String distinctNames = '''
+for (var i = 0; i < 20000; i++) {
+  element['expando' + i];
+}
+''';
+
+const Map<String, String> scripts = {'500k cached reads': commonNames, '20k distinct names': distinctNames};
+
+void main() => runBenchmark('property_name_cache', (Benchmark benchmark) {
+      scripts.forEach((String name, String code) {
+        Map<bool, List<int>> times = benchmark.compare(setPropertyNameCacheEnabled, () => benchmark.timeScript(code));
+        benchmark.report('$name: cached ${benchmark.medianMs(times[true]!)}, '
+            'uncached ${benchmark.medianMs(times[false]!)}');
+      });
+    }, setup: setup);
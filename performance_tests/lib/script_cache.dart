@@ -0,0 +1,50 @@
+import 'package:flutter/widgets.dart';
+import 'package:kraken/bridge.dart';
+import 'dart:convert';
+import 'dart:io';
+
+// Compares cold and warm script evaluation: the first context of a group parses the polyfill and the bundle,
+// later contexts of a shared group reuse the parsed scripts.
+//
+//   flutter run --profile -t lib/script_cache.dart --dart-define=KRAKEN_SHARED_CONTEXT_GROUP=true
+//   flutter run --profile -t lib/script_cache.dart
+const int contextCount = int.fromEnvironment('KRAKEN_CONTEXT_COUNT', defaultValue: 4);
+const bool sharedContextGroup = bool.fromEnvironment('KRAKEN_SHARED_CONTEXT_GROUP');
+
+// About 2MB of source, shaped like a bundled app: many small functions which are defined but mostly not called.
+String _generateBundle() {
+  StringBuffer buffer = StringBuffer();
+  for (int i = 0; i < 20000; i++) {
+    buffer.writeln('function module$i(exports) { var value = { id: $i, name: "module$i" }; '
+        'exports.get = function() { return value.id + value.name.length; }; return exports; }');
+  }
+  buffer.writeln('module0({}).get();');
+  return buffer.toString();
+}
+
+void main() {
+  WidgetsFlutterBinding.ensureInitialized();
+  registerDartMethodsToCpp();
+
+  initJSContextPool(contextCount, sharedContextGroup: sharedContextGroup);
+  for (int i = 1; i < contextCount; i++) {
+    allocateNewContext(i);
+  }
+
+  String bundle = _generateBundle();
+  print('[script_cache] mode: ${sharedContextGroup ? 'shared group' : 'group per context'}, '
+      'bundle: ${bundle.length ~/ 1024} KB');
+  for (int i = 0; i < contextCount; i++) {
+    Stopwatch stopwatch = Stopwatch()..start();
+    evaluateScripts(i, bundle, 'bundle.js', 0);
+    stopwatch.stop();
+
+    Map<String, dynamic> stats = jsonDecode(getBridgeStats(i));
+    print('[script_cache] context $i: polyfill ${stats['startupUs']['polyfill']} us, '
+        'bundle ${stopwatch.elapsedMicroseconds} us');
+  }
+
+  Map<String, dynamic> stats = jsonDecode(getBridgeStats(0));
+  print('[script_cache] cache: ${stats['scriptCache']}');
+  exit(0);
+}
@@ -0,0 +1,67 @@
+import 'package:kraken/bridge.dart';
+import 'dart:convert';
+import 'dart:ffi';
+import 'benchmark.dart';
+
+// Compares publishing and reading a frame of ui commands as UICommandItem structs and in the compact encoding, and
+// the bytes per command of both encodings. A struct command takes one UICommandItem plus its copied UTF-16
+// arguments, the compact size is what the encoder wrote.
+//
+// Run once per encoding and compare the printed timings, the compact run prints the sizes of both encodings:
+//   flutter run --profile -t lib/ui_command_encoding.dart
+//   flutter run --profile -t lib/ui_command_encoding.dart --dart-define=KRAKEN_UI_COMMAND_ENCODING=compact
+const String encodingName = String.fromEnvironment('KRAKEN_UI_COMMAND_ENCODING', defaultValue: 'struct');
+const int rounds = int.fromEnvironment('KRAKEN_ROUNDS', defaultValue: 50);
+
+// One frame: 1000 styled elements with text, appended and then removed again.
+const String frame = '''
+var container = document.createElement('div');
+for (var i = 0; i < 1000; i++) {
+  var item = document.createElement('div');
+  item.style.width = '100px';
+  item.style.height = '20px';
+  item.style.backgroundColor = 'red';
+  item.setAttribute('data-index', String(i));
+  item.appendChild(document.createTextNode('item ' + i));
+  container.appendChild(item);
+}
+document.body.appendChild(container);
+document.body.removeChild(container);
+''';
+
+Map<String, dynamic> _commandStats(int contextId) => jsonDecode(getBridgeStats(contextId));
+
+void main() {
+  kKrakenUICommandEncoding = encodingName == 'compact' ? UICommandEncoding.compact : UICommandEncoding.struct;
+  runBenchmark('ui_command_encoding', (Benchmark benchmark) {
+    int contextId = benchmark.contextId;
+    // Commands of the bridge setup go out with the first frame.
+    readUICommands(contextId);
+
+    int commandCount = 0;
+    Map<String, dynamic> before = _commandStats(contextId);
+    List<int> readUs = benchmark.repeat(() {
+      benchmark.evaluate(frame);
+      List<UICommand>? commands;
+      int elapsed = benchmark.time(() => commands = readUICommands(contextId));
+      commandCount = commands?.length ?? 0;
+      return elapsed;
+    }, rounds: rounds);
+    Map<String, dynamic> after = _commandStats(contextId);
+
+    int publishedCommands = commandCount * rounds;
+    int argsBytes = after['argsBytes'] - before['argsBytes'];
+    int encodedBytes = after['encodedBytes'] - before['encodedBytes'];
+    double structBytes = nativeCommandSize * sizeOf<Uint64>() + argsBytes / publishedCommands;
+    double compactBytes = encodedBytes / publishedCommands;
+
+    readUs.sort();
+    benchmark.report('encoding: $encodingName, $commandCount commands per frame');
+    benchmark.report('publish and read: median ${readUs[readUs.length ~/ 2]} us, '
+        'p90 ${readUs[readUs.length * 9 ~/ 10]} us');
+    benchmark.report('struct: ${structBytes.toStringAsFixed(1)} bytes per command');
+    if (kKrakenUICommandEncoding == UICommandEncoding.compact) {
+      benchmark.report('compact: ${compactBytes.toStringAsFixed(1)} bytes per command');
+    }
+  });
+}
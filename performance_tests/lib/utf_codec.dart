@@ -0,0 +1,64 @@
+import 'package:kraken/bridge.dart';
+import 'benchmark.dart';
+
+// Times the UTF-16 <-> UTF-8 codec of the bridge with ASCII, Latin-1 and CJK text. Constructing an Event converts
+// its type to UTF-8 and back, parsing HTML converts the whole document to UTF-8 and every text node back.
+//
+//   flutter run --profile -t lib/utf_codec.dart --dart-define=KRAKEN_TEXT_LENGTH=1024
+const int textLength = int.fromEnvironment('KRAKEN_TEXT_LENGTH', defaultValue: 1024);
+
+const Map<String, String> samples = {
+  'ascii': 'The quick brown fox jumps over the lazy dog. ',
+  'latin1': 'Ça fait déjà l\'été, señor Müller à Zürich. ',
+  'cjk': '北京的秋天，天高云淡，桂花飘香。',
+};
+
+String _repeat(String sample, int length) {
+  StringBuffer buffer = StringBuffer();
+  while (buffer.length < length) {
+    buffer.write(sample);
+  }
+  return buffer.toString().substring(0, length);
+}
+
+String _eventScript(String text) {
+  return '''
+var text = ${_quote(text)};
+for (var i = 0; i < 10000; i++) {
+  new Event(text);
+}
+''';
+}
+
+String _html(String text) {
+  StringBuffer buffer = StringBuffer('<html><body>');
+  for (int i = 0; i < 200; i++) {
+    buffer.write('<p>$text</p>');
+  }
+  buffer.write('</body></html>');
+  return buffer.toString();
+}
+
+String _quote(String text) {
+  return '\'' + text.replaceAll('\\', '\\\\').replaceAll('\'', '\\\'') + '\'';
+}
+
+void main() => runBenchmark('utf_codec', (Benchmark benchmark) {
+      samples.forEach((String name, String sample) {
+        String text = _repeat(sample, textLength);
+        String eventScript = _eventScript(text);
+        String html = _html(text);
+
+        List<int> events = [];
+        List<int> documents = [];
+        for (int round = 0; round < benchmarkRounds; round++) {
+          events.add(benchmark.timeScript(eventScript));
+          documents.add(benchmark.time(() => parseHTML(benchmark.contextId, html, 'utf_codec.html')));
+          // Apply the parsed nodes outside of the timings.
+          flushUICommand();
+        }
+
+        benchmark.report('$name: 10k events of $textLength units: ${benchmark.medianMs(events)}');
+        benchmark.report('$name: document of 200 x $textLength units: ${benchmark.medianMs(documents)}');
+      });
+    });